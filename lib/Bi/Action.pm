@@ -54,6 +54,8 @@ sub new {
     $self->{_parent} = undef;
     $self->{_is_matrix} = 0;
     $self->{_can_combine} = 0;
+    $self->{_can_simd} = 0;
+    $self->{_can_batch} = 0;
     $self->{_is_inplace} = 0;
     $self->{_can_nest} = 0;
     $self->{_unroll_args} = 1;
@@ -81,6 +83,8 @@ sub clone {
     $clone->{_parent} = $self->get_parent;
     $clone->{_is_matrix} = $self->is_matrix;
     $clone->{_can_combine} = $self->can_combine;
+    $clone->{_can_simd} = $self->{_can_simd};
+    $clone->{_can_batch} = $self->{_can_batch};
     $clone->{_is_inplace} = $self->is_inplace;
     $clone->{_can_nest} = $self->can_nest;
     $clone->{_unroll_args} = $self->unroll_args;
@@ -392,6 +396,69 @@ sub set_can_combine {
     $self->{_can_combine} = $on;
 }
 
+=item B<can_simd>
+
+Can the action be evaluated for several trajectories at once with SIMD
+instructions? Matrix actions never can.
+
+=cut
+sub can_simd {
+    my $self = shift;
+    return ($self->{_can_simd} && !$self->is_matrix) ? 1 : 0;
+}
+
+=item B<set_can_simd>(I<on>)
+
+Can the action be evaluated for several trajectories at once with SIMD
+instructions?
+
+=cut
+sub set_can_simd {
+    my $self = shift;
+    my $on = shift;
+    $self->{_can_simd} = $on;
+}
+
+=item B<can_batch>
+
+Can the action be evaluated for all trajectories at once as one batch matrix
+operation? Only matrix actions can, and only when the ranges of all their
+arguments and target are constant, so that every trajectory operates on the
+same elements.
+
+=cut
+sub can_batch {
+    my $self = shift;
+    
+    if (!$self->{_can_batch} || !$self->is_matrix) {
+        return 0;
+    }
+    foreach my $ref (@{$self->get_all_var_refs}, $self->get_left) {
+        if (@{$ref->get_indexes} == 0) {
+            return 0;
+        }
+        foreach my $index (@{$ref->get_indexes}) {
+            if (!$index->is_range || !$index->has_start || !$index->has_end ||
+                    !$index->is_const) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+=item B<set_can_batch>(I<on>)
+
+Can the action be evaluated for all trajectories at once as one batch matrix
+operation?
+
+=cut
+sub set_can_batch {
+    my $self = shift;
+    my $on = shift;
+    $self->{_can_batch} = $on;
+}
+
 =item B<is_matrix>
 
 Is the action a matrix operation?
@@ -50,6 +50,7 @@ sub validate {
     
     $self->set_parent('eval_');
     $self->set_can_combine(1);
+    $self->set_can_simd(1);
     $self->set_can_nest(1);
     $self->set_unroll_args(0);
     $self->set_shape($self->get_named_arg('expr')->get_shape);
@@ -64,6 +64,7 @@ sub validate {
 
     $self->set_parent('pdf_');
     $self->set_can_combine(1);
+    $self->set_can_simd(1);
     $self->set_unroll_args(0);
 }
 
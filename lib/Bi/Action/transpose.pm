@@ -60,6 +60,7 @@ sub validate {
     $self->set_parent('matrix_');
     $self->set_can_combine(1);
     $self->set_is_matrix(1);
+    $self->set_can_batch(1);
     $self->set_can_nest(1);
     $self->set_unroll_target(1);
 }
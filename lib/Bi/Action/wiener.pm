@@ -35,6 +35,7 @@ sub validate {
     }
 
     $self->set_parent('wiener_');
+    $self->set_can_simd(1);
 }
 
 sub mean {
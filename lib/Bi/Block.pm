@@ -56,6 +56,7 @@ sub new {
     $self->{_vars} = [];
     $self->{_var_groups} = [];
     $self->{_children} = [];
+    $self->{_can_fuse} = 0;
 
     bless $self, $class;    
     return $self;
@@ -79,6 +80,7 @@ sub clone {
     $clone->{_vars} = $self->get_vars;
     $clone->{_var_groups} = $self->get_var_groups;
     $clone->{_children} = [ map { $_->clone } @{$self->get_children} ];
+    $clone->{_can_fuse} = $self->{_can_fuse};
     
     bless $clone, ref($self);
     return $clone; 
@@ -641,6 +643,102 @@ sub get_blocks {
     return [ map { ($_->isa('Bi::Block')) ? $_ : () } @{$self->get_children} ];
 }
 
+=item B<get_common_blocks>
+
+Get C<common_eval_> blocks. These compute values common to all
+trajectories from variables that are not written by any other block, and so
+can be evaluated once, before all other blocks.
+
+=cut
+sub get_common_blocks {
+    my $self = shift;
+    
+    return [ map { ($_->get_name eq 'common_eval_') ? $_ : () } @{$self->get_blocks} ];
+}
+
+=item B<get_fused_blocks>
+
+Get blocks, excluding those given by L<get_common_blocks>, grouped into runs
+of consecutive blocks that can be fused into a single sweep over trajectories
+(see L<can_fuse>), as an array ref of array refs. Blocks that cannot be fused
+form runs of their own.
+
+=cut
+sub get_fused_blocks {
+    my $self = shift;
+    
+    my $runs = [];
+    my $run = [];
+    foreach my $block (@{$self->get_blocks}) {
+        if ($block->get_name eq 'common_eval_') {
+            next;
+        } elsif ($block->can_fuse) {
+            push(@$run, $block);
+        } else {
+            push(@$runs, $run) if @$run > 0;
+            push(@$runs, [ $block ]);
+            $run = [];
+        }
+    }
+    push(@$runs, $run) if @$run > 0;
+    
+    return $runs;
+}
+
+=item B<can_tile>
+
+Can trajectories be taken through the block in tiles, independently of one
+another, once the blocks given by L<get_common_blocks> have been evaluated?
+This is the case when all other blocks can be fused (see L<can_fuse>).
+
+=cut
+sub can_tile {
+    my $self = shift;
+    
+    foreach my $run (@{$self->get_fused_blocks}) {
+        foreach my $block (@$run) {
+            if (!$block->can_fuse) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+=item B<can_fuse>
+
+Can the block be fused with neighbouring blocks into a single sweep over
+trajectories? Only blocks that update each trajectory independently can, and
+only when they have no sub-blocks and no actions that target common
+variables.
+
+=cut
+sub can_fuse {
+    my $self = shift;
+    
+    if (!$self->{_can_fuse} || @{$self->get_blocks} > 0) {
+        return 0;
+    }
+    foreach my $action (@{$self->get_actions}) {
+        if ($action->get_left->is_common) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+=item B<set_can_fuse>(I<on>)
+
+Does the block update each trajectory independently, so that it can be
+fused with neighbouring blocks into a single sweep over trajectories?
+
+=cut
+sub set_can_fuse {
+    my $self = shift;
+    my $on = shift;
+    $self->{_can_fuse} = $on;
+}
+
 =item B<get_block>(I<name>)
 
 Get the first block called I<name>, or undef if no such block exists.
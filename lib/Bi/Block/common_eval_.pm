@@ -0,0 +1,41 @@
+=head1 NAME
+
+common_eval_ - optimisation block for L<eval_> actions with targets that
+are common variables, evaluated once rather than once per trajectory.
+
+=cut
+
+package Bi::Block::common_eval_;
+
+use parent 'Bi::Block';
+use warnings;
+use strict;
+
+our $BLOCK_ARGS = [];
+
+sub validate {
+    my $self = shift;
+    
+    $self->process_args($BLOCK_ARGS);
+    
+    if (@{$self->get_blocks} > 0) {
+        die("a 'common_eval_' block may not contain nested blocks\n");
+    }
+    foreach my $action (@{$self->get_actions}) {
+        if ($action->get_name ne 'eval_') {
+            die("a 'common_eval_' block may only contain 'eval_' actions\n");
+        } elsif (!$action->get_left->is_common) {
+            die("a 'common_eval_' block may only contain actions with common targets\n");
+        }
+    }
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -59,12 +59,21 @@ An order 5(4) Dormand-Prince with adaptive step size.
 
 An order 4(3) low-storage Runge-Kutta with adaptive step size.
 
+=item C<'ROS4(3)'>
+
+An order 4(3) Rosenbrock (linearly implicit) method with adaptive step size,
+for stiff systems. Each step uses the Jacobian of the system, which is
+derived symbolically, and so all of the equations must be differentiable.
+Not available with C<--enable-cuda>.
+
 =back
 
 =item C<h> (position 1, default 1.0)
 
 For a fixed step size, the step size to use. For an adaptive step size, the
-suggested initial step size to use.
+suggested initial step size to use. Thereafter, each trajectory continues
+from the step size last chosen for it by the block, which is carried through
+resampling (except with C<--enable-cuda>).
 
 =item C<atoler> (position 2, default 1.0e-3)
 
@@ -106,7 +115,7 @@ sub validate {
     $self->process_args($BLOCK_ARGS);
     
     my $alg = $self->get_named_arg('alg')->eval_const;
-    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)') {
+    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)' && $alg ne 'ROS4(3)') {
         die("unrecognised value '$alg' for argument 'alg' of block 'ode'\n");
     }
     
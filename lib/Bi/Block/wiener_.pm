@@ -16,6 +16,7 @@ sub validate {
     my $self = shift;
     
     $self->process_args($BLOCK_ARGS);
+    $self->set_can_fuse(1);
     
     if (@{$self->get_blocks} > 0) {
         die("a 'wiener_' block may not contain nested blocks\n");
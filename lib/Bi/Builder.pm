@@ -33,6 +33,36 @@ Do not build.
 Force all build steps to be performed, even when determined not to be
 required.
 
+=item C<--jobs> I<n> (default number of cores)
+
+Number of jobs to run in parallel when building.
+
+=item C<--enable-cache> (default off)
+
+Share built client programs and libraries between working directories
+through a cache. Entries are keyed on a hash of the contents of the
+generated code, the client options used to generate it, the library
+sources, the build options and the compiler version and target, so that any
+change to these results in a rebuild. A client program found in the cache is
+copied into the build directory without running C<autogen.sh>,
+C<configure> or C<make>. The library of model-independent code, C<libbi.a>,
+is also cached, so that it is compiled only once for each set of build
+options, rather than once for each model and working directory.
+
+Entries are never removed, so the cache grows with each new model and set
+of build options; delete the cache directory to reclaim the space.
+
+=item C<--cache-dir> I<dir> (default C<$LIBBI_CACHE>, or C<~/.libbi/cache>)
+
+Directory of the cache.
+
+=item C<--enable-pch> (default on)
+
+Precompile the headers of the model-independent parts of the library, where
+the compiler supports it. These are then parsed only once for each build
+directory, rather than once for each client program. Not used with
+C<--enable-cuda>.
+
 =item C<--enable-warnings> (default off)
 
 Enable compiler warnings.
@@ -49,7 +79,9 @@ C<--with-gdb> or C<--with-cuda-gdb> when debugging.
 
 =item C<--enable-diagnostics n> (default 0)
 
-Enable diagnostic output n to standard error.
+Enable diagnostic output n to standard error. With n of 5, the time that
+each thread spends idle at the end of loops that follow C<--schedule> is
+reported on exit.
 
 =item C<--enable-diagnostics2> (default off)
 
@@ -86,6 +118,15 @@ Enable SSE code.
 
 Enable AVX code.
 
+=item C<--enable-avx2> (default off)
+
+Enable AVX2 and FMA code. Implies C<--enable-avx>.
+
+=item C<--enable-avx512> (default off)
+
+Enable AVX-512 code, doubling the SIMD vector width of AVX. Implies
+C<--enable-avx2>.
+
 =item C<--enable-mpi> (default off)
 
 Enable MPI code.
@@ -117,6 +158,10 @@ use Getopt::Long qw(:config pass_through no_auto_abbrev no_ignore_case);
 use File::Spec;
 use File::Slurp;
 use File::Path;
+use File::Copy;
+use File::Find;
+use Digest::SHA;
+use Config;
 
 =item B<new>(I<name>, I<verbose>)
 
@@ -142,6 +187,10 @@ sub new {
         _builddir => '',
         _verbose => $verbose,
         _force => 0,
+        _jobs => _num_cores(),
+        _cache => 0,
+        _cache_dir => _default_cache_dir(),
+        _pch => 1,
         _warnings => 0,
         _assert => 1,
         _openmp => 1,
@@ -150,6 +199,8 @@ sub new {
         _gpu_cache => 0,
         _sse => 0,
         _avx => 0,
+        _avx2 => 0,
+        _avx512 => 0,
         _mpi => 0,
         _vampir => 0,
         _single => 0,
@@ -165,6 +216,12 @@ sub new {
     # command line options
     my @args = (
         'force' => \$self->{_force},
+        'jobs=i' => \$self->{_jobs},
+        'enable-cache' => sub { $self->{_cache} = 1 },
+        'disable-cache' => sub { $self->{_cache} = 0 },
+        'cache-dir=s' => \$self->{_cache_dir},
+        'enable-pch' => sub { $self->{_pch} = 1 },
+        'disable-pch' => sub { $self->{_pch} = 0 },
         'enable-warnings' => sub { $self->{_warnings} = 1 },
         'disable-warnings' => sub { $self->{_warnings} = 0 },
         'enable-assert' => sub { $self->{_assert} = 1 },
@@ -181,6 +238,10 @@ sub new {
         'disable-sse' => sub { $self->{_sse} = 0 },
         'enable-avx' => sub { $self->{_avx} = 1 },
         'disable-avx' => sub { $self->{_avx} = 0 },
+        'enable-avx2' => sub { $self->{_avx2} = 1 },
+        'disable-avx2' => sub { $self->{_avx2} = 0 },
+        'enable-avx512' => sub { $self->{_avx512} = 1 },
+        'disable-avx512' => sub { $self->{_avx512} = 0 },
         'enable-mpi' => sub { $self->{_mpi} = 1 },
         'disable-mpi' => sub { $self->{_mpi} = 0 },
         'enable-vampir' => sub { $self->{_vampir} = 1 },
@@ -200,6 +261,14 @@ sub new {
     GetOptions(@args) || die("could not read command line arguments\n");
     
     # can't support AVX or SSE when CUDA enabled at this stage
+    if ($self->{_cuda} && $self->{_avx512}) {
+    	warn("AVX-512 has been disabled, unsupported when CUDA also enabled\n");
+    	$self->{_avx512} = 0;
+    }
+    if ($self->{_cuda} && $self->{_avx2}) {
+    	warn("AVX2 has been disabled, unsupported when CUDA also enabled\n");
+    	$self->{_avx2} = 0;
+    }
     if ($self->{_cuda} && $self->{_avx}) {
     	warn("AVX has been disabled, unsupported when CUDA also enabled\n");
     	$self->{_avx} = 0;
@@ -209,11 +278,28 @@ sub new {
     	$self->{_sse} = 0;
     }
     
+    # each SIMD level builds on those below it
+    if ($self->{_avx512}) {
+    	$self->{_avx2} = 1;
+    }
+    if ($self->{_avx2}) {
+    	$self->{_avx} = 1;
+    }
+
     # some AVX instructions defer to SSE, so enable SSE too
     if ($self->{_avx}) {
     	$self->{_sse} = 1;
     }
     
+    # no cache without somewhere to put it
+    if ($self->{_cache} && !defined $self->{_cache_dir}) {
+        warn("cache has been disabled, set LIBBI_CACHE or use --cache-dir to enable\n");
+        $self->{_cache} = 0;
+    }
+    if ($self->{_jobs} < 1) {
+        $self->{_jobs} = 1;
+    }
+
     # enable mpirun automatically when --enable-mpi used
     if ($self->{_mpi}) {
         push(@ARGV, '--with-mpi');
@@ -228,12 +314,15 @@ sub new {
     push(@builddir, 'gpucache') if $self->{_gpu_cache};
     push(@builddir, 'sse') if $self->{_sse};
     push(@builddir, 'avx') if $self->{_avx};
+    push(@builddir, 'avx2') if $self->{_avx2};
+    push(@builddir, 'avx512') if $self->{_avx512};
     push(@builddir, 'mpi') if $self->{_mpi};
     push(@builddir, 'vampir') if $self->{_vampir};
     push(@builddir, 'single') if $self->{_single};
     push(@builddir, 'extradebug') if $self->{_extra_debug};
     push(@builddir, 'diagnostics' . $self->{_diagnostics}) if $self->{_diagnostics};
     push(@builddir, 'gperftools') if $self->{_gperftools};
+    push(@builddir, 'nopch') if !$self->{_pch};
     
     $self->{_builddir} = File::Spec->catdir(".$name", join('_', @builddir));
     mkpath($self->{_builddir});
@@ -250,7 +339,7 @@ sub new {
     return $self;
 }
 
-=item B<build>(I<client>)
+=item B<build>(I<client>, I<args>)
 
 Build a client program.
 
@@ -259,6 +348,10 @@ Build a client program.
 =item I<client> The name of the client program ('simulate', 'filter',
 'pmcmc', etc).
 
+=item I<args> (optional) The client arguments used in generating its code,
+as returned by L<Bi::Client/get_recorded_args>. These are added to the key
+of the client program in the cache.
+
 =back
 
 No return value.
@@ -267,10 +360,18 @@ No return value.
 sub build {
     my $self = shift;
     my $client = shift;
+    my $args = shift;
     
+    $self->{_client_args} = defined $args ? $args : '';
+    if ($self->{_cache} && !$self->{_force} && $self->_fetch_client($client)) {
+        return;
+    }
     $self->_autogen;
     $self->_configure;
     $self->_make($client);
+    if ($self->{_cache}) {
+        $self->_store_client($client);
+    }
 }
 
 =item B<get_dir>
@@ -335,6 +436,38 @@ sub _configure {
 
     my $builddir = $self->get_dir;
     my $cwd = getcwd();
+    my $cmd = $self->_configure_command;
+
+    if ($self->{_force} ||
+        $self->_is_modified(File::Spec->catfile($builddir, 'configure')) ||
+        !-e File::Spec->catfile($builddir, 'Makefile')) {
+        if ($self->{_verbose}) {
+            print "$cmd\n";
+        } else {
+            $cmd .= ' > configure.log 2>&1';
+        }
+        
+        chdir($builddir);
+        my $ret = system($cmd);
+        if ($? == -1) {
+            die("./configure failed to execute ($!)\n");
+        } elsif ($? & 127) {
+            die(sprintf("./configure died with signal %d. See $builddir/configure.log and $builddir/config.log for details\n", $? & 127));
+        } elsif ($ret != 0) {
+            die(sprintf("./configure failed with return code %d." . _configure_whats_missing('configure.log') . " See $builddir/configure.log and $builddir/config.log for details\n", $ret >> 8));
+        }        
+        chdir($cwd);
+    }
+}
+
+=item B<_configure_command>
+
+Command to run the C<configure> script with the build options.
+
+=cut
+sub _configure_command {
+    my $self = shift;
+
     my $cxxflags = '-O3 -g3 -funroll-loops';
     my $linkflags = '';
     my $options = '';
@@ -350,6 +483,8 @@ sub _configure {
     $options .= $self->{_gpu_cache} ? ' --enable-gpucache' : ' --disable-gpucache';
     $options .= $self->{_sse} ? ' --enable-sse' : ' --disable-sse';
     $options .= $self->{_avx} ? ' --enable-avx' : ' --disable-avx';
+    $options .= $self->{_avx2} ? ' --enable-avx2' : ' --disable-avx2';
+    $options .= $self->{_avx512} ? ' --enable-avx512' : ' --disable-avx512';
     $options .= $self->{_mpi} ? ' --enable-mpi' : ' --disable-mpi';
     $options .= $self->{_vampir} ? ' --enable-vampir' : ' --disable-vampir';
     $options .= $self->{_single} ? ' --enable-single' : ' --disable-single';
@@ -357,40 +492,18 @@ sub _configure {
     $options .= $self->{_timing} ? ' --enable-timing' : ' --disable-timing';
     $options .= $self->{_diagnostics} ? ' --enable-diagnostics=' . $self->{_diagnostics} : ' --disable-diagnostics';
     $options .= $self->{_gperftools} ? ' --enable-gperftools' : ' --disable-gperftools';
+    $options .= $self->{_pch} ? ' --enable-pch' : ' --disable-pch';
     
     if ($self->{_extra_debug}) {
     	$cxxflags = '-O0 -g3 -fno-inline -D_GLIBCXX_DEBUG';
     }
-
-    if (!$self->{_verbose}) {
-        $options .= ' > configure.log 2>&1'; 
-    }
             
     if ($self->{_warnings}) {
         $cxxflags .= " -Wall";
         $linkflags .= " -Wall";
     }
 
-    if ($self->{_force} ||
-        $self->_is_modified(File::Spec->catfile($builddir, 'configure')) ||
-        !-e File::Spec->catfile($builddir, 'Makefile')) {
-        
-        my $cmd = "./configure $options CXXFLAGS='$cxxflags' LINKFLAGS='$linkflags'";
-        if ($self->{_verbose}) {
-            print "$cmd\n";
-        }
-        
-        chdir($builddir);
-        my $ret = system($cmd);
-        if ($? == -1) {
-            die("./configure failed to execute ($!)\n");
-        } elsif ($? & 127) {
-            die(sprintf("./configure died with signal %d. See $builddir/configure.log and $builddir/config.log for details\n", $? & 127));
-        } elsif ($ret != 0) {
-            die(sprintf("./configure failed with return code %d." . _configure_whats_missing('configure.log') . " See $builddir/configure.log and $builddir/config.log for details\n", $ret >> 8));
-        }        
-        chdir($cwd);
-    }
+    return "./configure $options CXXFLAGS='$cxxflags' LINKFLAGS='$linkflags'";
 }
 
 =item B<_make>(I<client>)
@@ -412,20 +525,23 @@ sub _make {
     my $self = shift;
     my $client = shift;
     
-    my $exeext = ($^O eq 'cygwin' || $^O eq 'MSWin32') ? '.exe' : '';
-    my $target = $client . "_" . ($self->{_cuda} ? 'gpu' : 'cpu') . $exeext;
-    my $link = $client . $exeext;
+    my $target = $self->_target($client);
+    my $link = $self->_link($client);
     my $options = '';
     if ($self->{_force}) {
         $options .= ' --always-make';
     }
+    if ($self->{_cache} && !$self->{_force} && $self->_fetch_library) {
+        # don't remake library, nor its objects, which may not exist
+        $options .= ' --old-file=libbi.a';
+    }
     if (!$self->{_verbose}) {
         $options .= ' > make.log 2>&1'; 
     }
     
     my $builddir = $self->get_dir;
     my $cwd = getcwd();
-    my $cmd = "make -j 4 $options $target";
+    my $cmd = 'make -j ' . $self->{_jobs} . " $options $target";
     
     if ($self->{_verbose}) {
         print "$cmd\n";
@@ -442,6 +558,343 @@ sub _make {
     }
     symlink($target, $link);
     chdir($cwd);
+    
+    if ($self->{_cache}) {
+        $self->_store_library;
+    }
+}
+
+=item B<_target>(I<client>)
+
+Name of the make target for a client program.
+
+=cut
+sub _target {
+    my $self = shift;
+    my $client = shift;
+    
+    return $client . "_" . ($self->{_cuda} ? 'gpu' : 'cpu') . _exeext();
+}
+
+=item B<_link>(I<client>)
+
+Name of the symlink to the make target for a client program.
+
+=cut
+sub _link {
+    my $self = shift;
+    my $client = shift;
+    
+    return $client . _exeext();
+}
+
+=item B<_fetch_client>(I<client>)
+
+Copy a client program from the cache into the build directory, if there.
+
+Returns true if the client program was found in the cache.
+
+=cut
+sub _fetch_client {
+    my $self = shift;
+    my $client = shift;
+
+    my $builddir = $self->get_dir;
+    my $target = $self->_target($client);
+    my $from = File::Spec->catfile($self->_client_cache_dir($client), $target);
+    my $to = File::Spec->catfile($builddir, $target);
+    
+    if (-x $from && _cache_copy($from, $to)) {
+        # date back to ensure that make relinks it on any later build
+        utime(0, 0, $to);
+        chmod(0755, $to);
+        symlink($target, File::Spec->catfile($builddir, $self->_link($client)));
+        if ($self->{_verbose}) {
+            print "using $target from $from\n";
+        }
+        return 1;
+    }
+    return 0;
+}
+
+=item B<_store_client>(I<client>)
+
+Copy a client program from the build directory into the cache.
+
+No return value.
+
+=cut
+sub _store_client {
+    my $self = shift;
+    my $client = shift;
+    
+    my $target = $self->_target($client);
+    my $from = File::Spec->catfile($self->get_dir, $target);
+    my $to = File::Spec->catfile($self->_client_cache_dir($client), $target);
+    
+    if (-x $from) {
+        _cache_copy($from, $to);
+    }
+}
+
+=item B<_fetch_library>
+
+Copy C<libbi.a> from the cache into the build directory, if there and not
+already there. A file C<libbi.key> in the build directory records the
+cache entry from which C<libbi.a> was taken, if it was.
+
+Returns true if C<libbi.a> in the build directory was taken from the cache,
+in which case its objects may not exist, and it should not be remade.
+
+=cut
+sub _fetch_library {
+    my $self = shift;
+    
+    my $builddir = $self->get_dir;
+    my $dir = $self->_library_cache_dir;
+    my $from = File::Spec->catfile($dir, 'libbi.a');
+    my $to = File::Spec->catfile($builddir, 'libbi.a');
+    my $keyfile = File::Spec->catfile($builddir, 'libbi.key');
+    
+    if (-e $keyfile) {
+        if (-e $to && read_file($keyfile) eq $dir) {
+            return 1;
+        }
+        
+        # stale, remake from scratch
+        unlink($keyfile, $to);
+    }
+    if (!-e $to && -e $from && _cache_copy($from, $to)) {
+        write_file($keyfile, $dir);
+        return 1;
+    }
+    return 0;
+}
+
+=item B<_store_library>
+
+Copy C<libbi.a> from the build directory into the cache, if it was built
+there.
+
+No return value.
+
+=cut
+sub _store_library {
+    my $self = shift;
+    
+    my $builddir = $self->get_dir;
+    my $from = File::Spec->catfile($builddir, 'libbi.a');
+    my $to = File::Spec->catfile($self->_library_cache_dir, 'libbi.a');
+
+    if (-e $from && !-e File::Spec->catfile($builddir, 'libbi.key') && !-e $to) {
+        _cache_copy($from, $to);
+    }
+}
+
+=item B<_client_cache_dir>(I<client>)
+
+Directory of the cache entry for a client program. Its name is a hash of
+everything that goes into building the program: the generated code, the
+client arguments used to generate it, the library sources, the build system
+and the build options.
+
+=cut
+sub _client_cache_dir {
+    my $self = shift;
+    my $client = shift;
+    
+    my $builddir = $self->get_dir;
+    my $sha = $self->_digest;
+    $sha->add($self->_target($client), "\n");
+    $sha->add($self->{_client_args}, "\n");
+    _digest_files($sha, $builddir, 'src');
+    _digest_files($sha, $builddir, 'Makefile.am');
+    
+    return File::Spec->catdir($self->{_cache_dir}, 'client', $sha->hexdigest);
+}
+
+=item B<_library_cache_dir>
+
+Directory of the cache entry for C<libbi.a>. Its name is a hash of the
+library sources, the build system without its client programs and the build
+options, but not the model, so that the entry is shared between models.
+
+=cut
+sub _library_cache_dir {
+    my $self = shift;
+
+    my $builddir = $self->get_dir;
+    my $sha = $self->_digest;
+    my $makefile = read_file(File::Spec->catfile($builddir, 'Makefile.am'));
+    
+    # client programs, which name the model, are dropped
+    $makefile =~ s/^# programs\n.*?^(?=# other\n)//ms;
+    $sha->add($makefile);
+    _digest_files($sha, $builddir, File::Spec->catdir('src', 'bi'));
+    
+    return File::Spec->catdir($self->{_cache_dir}, 'lib', $sha->hexdigest);
+}
+
+=item B<_digest>
+
+Start a hash of the build options, the compiler version and target, the
+architecture and the environment that affects the build.
+
+Returns a L<Digest::SHA> object.
+
+=cut
+sub _digest {
+    my $self = shift;
+    
+    my $sha = Digest::SHA->new(1);
+    my ($vol, $dir, $file) = File::Spec->splitpath($self->get_dir);
+    $sha->add($file, "\n", $Config{archname}, "\n");
+    $sha->add($self->_configure_command, "\n");
+    $sha->add($self->_compiler_version, "\n");
+    foreach my $var ('CC', 'CXX', 'NVCC', 'CPPFLAGS', 'CFLAGS', 'CXXFLAGS',
+        'LDFLAGS', 'LIBS', 'CUDA_ROOT') {
+        $sha->add($var, '=', defined $ENV{$var} ? $ENV{$var} : '', "\n");
+    }
+    _digest_files($sha, $self->get_dir, 'autogen.sh');
+    _digest_files($sha, $self->get_dir, 'configure.ac');
+    
+    return $sha;
+}
+
+=item B<_compiler_version>
+
+Version and target of the C++ compiler, and of the CUDA compiler if used, as
+reported by their C<--version> and C<-dumpmachine> options. Computed once and
+remembered.
+
+=cut
+sub _compiler_version {
+    my $self = shift;
+
+    if (!defined $self->{_compiler_version}) {
+        my @compilers = (defined $ENV{CXX} && $ENV{CXX} ne '') ? $ENV{CXX} : 'g++';
+        if ($self->{_cuda}) {
+            push(@compilers, (defined $ENV{NVCC} && $ENV{NVCC} ne '') ? $ENV{NVCC} : 'nvcc');
+        }
+        $self->{_compiler_version} = '';
+        foreach my $compiler (@compilers) {
+            my $version = `$compiler --version 2>&1`;
+            my $machine = `$compiler -dumpmachine 2>&1`;
+            $self->{_compiler_version} .= defined $version ? $version : '';
+            $self->{_compiler_version} .= defined $machine ? $machine : '';
+        }
+    }
+    return $self->{_compiler_version};
+}
+
+=item B<_digest_files>(I<sha>, I<dir>, I<path>)
+
+Add the contents of a file, or of all files under a directory, to a hash, in
+order of their names.
+
+=over 4
+
+=item I<sha> The L<Digest::SHA> object.
+
+=item I<dir> The build directory.
+
+=item I<path> Path of the file or directory, relative to I<dir>.
+
+=back
+
+No return value.
+
+=cut
+sub _digest_files {
+    my $sha = shift;
+    my $dir = shift;
+    my $path = shift;
+    
+    my $root = File::Spec->catfile($dir, $path);
+    my @files;
+    if (-d $root) {
+        find({
+            no_chdir => 1,
+            wanted => sub {
+                if (-f $File::Find::name && $File::Find::name =~ /\.(?:cpp|hpp|cu|cuh)$/) {
+                    push(@files, $File::Find::name);
+                }
+            }
+        }, $root);
+    } elsif (-f $root) {
+        push(@files, $root);
+    }
+    foreach my $file (sort @files) {
+        $sha->add(File::Spec->abs2rel($file, $dir), "\0");
+        $sha->addfile($file);
+    }
+}
+
+=item B<_cache_copy>(I<from>, I<to>)
+
+Copy a file into or out of the cache, via a temporary file, so that
+concurrent builds never see it partially written.
+
+Returns true on success.
+
+=cut
+sub _cache_copy {
+    my $from = shift;
+    my $to = shift;
+    
+    my ($vol, $dir, $file) = File::Spec->splitpath($to);
+    my $tmp = File::Spec->catfile($dir, ".$file.$$");
+    
+    eval { mkpath($dir) };
+    if (copy($from, $tmp)) {
+        chmod((stat($from))[2] & 07777, $tmp);
+        if (rename($tmp, $to)) {
+            return 1;
+        }
+    }
+    unlink($tmp);
+    return 0;
+}
+
+=item B<_num_cores>
+
+Number of processor cores, or 4 if it cannot be determined.
+
+=cut
+sub _num_cores {
+    my $n = `getconf _NPROCESSORS_ONLN 2> /dev/null`;
+    if (!defined $n || $n !~ /^\s*\d+\s*$/) {
+        $n = `sysctl -n hw.ncpu 2> /dev/null`;
+    }
+    if (defined $n && $n =~ /^\s*(\d+)\s*$/ && $1 > 0) {
+        return int($1);
+    }
+    return 4;
+}
+
+=item B<_default_cache_dir>
+
+Default directory of the cache, C<$LIBBI_CACHE> if set, otherwise
+C<.libbi/cache> in the home directory, or undefined if neither is set.
+
+=cut
+sub _default_cache_dir {
+    if (defined $ENV{LIBBI_CACHE} && $ENV{LIBBI_CACHE} ne '') {
+        return $ENV{LIBBI_CACHE};
+    } elsif (defined $ENV{HOME} && $ENV{HOME} ne '') {
+        return File::Spec->catdir($ENV{HOME}, '.libbi', 'cache');
+    } else {
+        return undef;
+    }
+}
+
+=item B<_exeext>
+
+File name extension of executables.
+
+=cut
+sub _exeext {
+    return ($^O eq 'cygwin' || $^O eq 'MSWin32') ? '.exe' : '';
 }
 
 =item B<_stamp>(I<filename>)
@@ -29,6 +29,41 @@ Pseudorandom number generator seed.
 Run with C<N> threads. If zero, the number of threads used is the
 default for OpenMP on the platform.
 
+=item C<--schedule> (default C<static>)
+
+OpenMP schedule for loops over particles whose cost varies from particle to
+particle, such as those of the adaptive ODE integrators in the L<ode> block;
+one of C<static>, C<dynamic> or C<guided>. Loops that draw pseudorandom
+numbers always use static scheduling, so that results are reproducible
+regardless of this setting.
+
+=item C<--schedule-chunk> (default 0)
+
+Chunk size for C<--schedule>. If zero, the default for OpenMP on the platform
+is used.
+
+=item C<--ancestry-memory> (default 0)
+
+Memory budget, in MB, for the particle ancestry tree kept by methods that
+output trajectories. When the tree would exceed it, the ancestral path common
+to all particles is moved to a memory-mapped temporary file in C<TMPDIR>, and
+read back when trajectories are output. Useful for long time series. If zero,
+there is no budget.
+
+=item C<--read-ahead> (default 32)
+
+Number of time points to read at once from the input and observation files.
+Reading ahead replaces many small reads with few large ones, which helps for
+files with many time points. If zero or one, only one time point is read at a
+time.
+
+=item C<--output-queue> (default 2)
+
+Number of writes to the output file that may be queued while computation
+continues. Writes are performed in the background, with each queued write
+holding a copy of its data, so that the default buffers output doubly. If
+zero, output is written synchronously.
+
 =item C<--with-gdb> (default off)
 
 Run within the C<gdb> debugger.
@@ -263,6 +298,31 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 0
     },
+    {
+      name => 'schedule',
+      type => 'string',
+      default => 'static'
+    },
+    {
+      name => 'schedule-chunk',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'ancestry-memory',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'read-ahead',
+      type => 'int',
+      default => 32
+    },
+    {
+      name => 'output-queue',
+      type => 'int',
+      default => 2
+    },
     {
       name => 'gperftools-file',
       type => 'string',
@@ -549,9 +609,45 @@ sub get_named_arg {
     my $self = shift;
     my $name = shift;
     
+    if (defined $self->{_recorded}) {
+        $self->{_recorded}->{$name} = 1;
+    }
     return $self->get_args->{$name};
 }
 
+=item B<record_named_args>
+
+Start recording the names of named arguments read with B<get_named_arg>, so
+that those used in generating code can later be retrieved with
+B<get_recorded_args>.
+
+=cut
+sub record_named_args {
+    my $self = shift;
+    
+    $self->{_recorded} = {};
+}
+
+=item B<get_recorded_args>
+
+Get the named arguments read since the last call to B<record_named_args>, as
+a string of C<name=value> lines in order of name. Returns an empty string if
+not recording.
+
+=cut
+sub get_recorded_args {
+    my $self = shift;
+    
+    my $str = '';
+    if (defined $self->{_recorded}) {
+        foreach my $name (sort keys %{$self->{_recorded}}) {
+            my $value = $self->get_args->{$name};
+            $str .= "$name=" . (defined $value ? $value : '') . "\n";
+        }
+    }
+    return $str;
+}
+
 =item B<set_named_arg>(I<name>, I<value>)
 
 Set named argument.
@@ -96,6 +96,34 @@ Number of samples to draw.
 
 =back
 
+=head2 MH-specific options
+
+=over 4
+
+=item C<--nchains> (default 1)
+
+Number of independent chains to run. Each chain draws C<--nsamples> samples.
+When the filter is small relative to the number of threads, the chains are
+run concurrently, one per thread; otherwise they take turns to use all
+threads. Samples are interleaved in the output file, so that sample C<c> of
+chain C<i> is at index C<c*nchains + i> along the C<np> dimension.
+
+=item C<--with-early-rejection> (default 0)
+
+Draw the uniform variate for each accept/reject step before filtering the
+proposal, and stop the filter as soon as the proposal is certain to be
+rejected, given C<--early-rejection-bound>, which must also be given.
+
+=item C<--early-rejection-bound> (no default)
+
+Upper bound on the log-likelihood increment at any one observation, used by
+C<--with-early-rejection>. Zero is valid when all observations are discrete.
+For continuous observations, a larger value is needed for the accept/reject
+decision to be unchanged; C<libbi test_early_rejection> can be used to check
+a bound.
+
+=back
+
 =head2 SIR-specific options
 
 =over 4
@@ -188,6 +216,20 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 1
     },
+    {
+      name => 'nchains',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'with-early-rejection',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'early-rejection-bound',
+      type => 'float'
+    },
     {
       name => 'conditional-pf',
       type => 'int',
@@ -278,6 +320,10 @@ sub process_args {
             $self->set_named_arg('with-transform-obs-to-state', 1);
         }
     } else {
+        if ($self->get_named_arg('with-early-rejection') &&
+                !$self->is_named_arg('early-rejection-bound')) {
+            die("--with-early-rejection requires --early-rejection-bound\n");
+        }
     	if ($sampler eq 'sir' || $sampler eq 'smc2') {
 	    	$self->set_named_arg('sampler', 'sir'); # standardise name
     	}
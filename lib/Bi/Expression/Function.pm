@@ -117,7 +117,9 @@ sub is_math {
     my %MATH_FUNCTIONS = (
       'abs' => 1,
       'log' => 1,
+      'log1p' => 1,
       'exp' => 1,
+      'expm1' => 1,
       'max' => 1,
       'min' => 1,
       'sqrt' => 1,
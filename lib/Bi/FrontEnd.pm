@@ -234,7 +234,7 @@ sub client {
         }
         if (!$self->{_dry_build}) {
             $self->_report("Building...");
-            $builder->build($client->get_binary);
+            $builder->build($client->get_binary, $client->get_recorded_args);
         }
         $self->_unlock;
     }
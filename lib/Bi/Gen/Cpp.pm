@@ -251,6 +251,7 @@ sub process_client {
         $template = File::Spec->catfile('client', $binary);
     }
     $out = File::Spec->catfile('src', $binary);
+    $client->record_named_args;
     $self->process_templates("${template}_cpu", {
         'have_model' => defined $model,
         'model' => $model,
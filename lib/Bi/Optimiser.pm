@@ -33,6 +33,7 @@ use Bi::Visitor::Unroller;
 use Bi::Visitor::Wrapper;
 use Bi::Visitor::StaticExtractor;
 use Bi::Visitor::StaticReplacer;
+use Bi::Visitor::SubexpressionExtractor;
     
 =item B<new>(I<model>)
 
@@ -71,6 +72,7 @@ sub optimise {
     Bi::Visitor::Standardiser->evaluate($model);
     my ($lefts, $rights) = Bi::Visitor::StaticExtractor->evaluate($model);
     Bi::Visitor::StaticReplacer->evaluate($model, $lefts, $rights);        		
+    Bi::Visitor::SubexpressionExtractor->evaluate($model);
     Bi::Visitor::Unroller->evaluate($model);
     Bi::Visitor::Wrapper->evaluate($model);
 }
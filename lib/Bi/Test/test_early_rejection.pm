@@ -0,0 +1,60 @@
+=head1 NAME
+
+test_early_rejection - test early rejection in marginal Metropolis-Hastings.
+
+=head1 SYNOPSIS
+
+    libbi test_early_rejection --early-rejection-bound 0.0 ...
+
+=head1 INHERITS
+
+L<Bi::Client::sample>
+
+=head1 DESCRIPTION
+
+Runs a marginal Metropolis-Hastings chain on the model twice in lockstep,
+once with early rejection and once without, using the same random numbers
+for each proposal in both. Reports the number of proposals accepted and the
+number stopped early, and exits with an error at the first proposal on which
+the two accept/reject decisions differ, which indicates that
+C<--early-rejection-bound> does not hold for the model. The chain length is
+given by C<--nsamples>.
+
+=cut
+
+package Bi::Test::test_early_rejection;
+
+use parent 'Bi::Client::sample';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+The C<test_early_rejection> command inherits all options from C<sample>,
+and requires C<--early-rejection-bound>. Only the bootstrap, bridge,
+lookahead and adaptive filters are supported.
+
+=cut
+
+sub process_args {
+    my $self = shift;
+
+    $self->Bi::Client::sample::process_args(@_);
+    if (!$self->is_named_arg('early-rejection-bound')) {
+        die("--early-rejection-bound is required\n");
+    }
+    if ($self->get_named_arg('filter') eq 'kalman') {
+        die("--filter kalman is not supported\n");
+    }
+    $self->{_binary} = 'test_early_rejection';
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -0,0 +1,69 @@
+=head1 NAME
+
+test_transcendental - test vectorised transcendental functions against libm.
+
+=head1 SYNOPSIS
+
+    libbi test_transcendental ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=head1 DESCRIPTION
+
+Evaluates each of the vectorised transcendental functions on random
+arguments over a number of intervals, and prints the maximum error, in units
+in the last place, against the long double functions of the C library.
+Exits with an error if any maximum exceeds the bound documented in
+F<bi/sse/math/transcendental.hpp>. Use C<--enable-sse>, C<--enable-avx> or
+C<--enable-avx512>, and C<--enable-single>, to choose the vector type
+tested.
+
+=cut
+
+package Bi::Test::test_transcendental;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--reps> (default 1000000)
+
+Number of arguments on each interval.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'reps',
+      type => 'int',
+      default => 1000000
+    }
+);
+
+sub init {
+    my $self = shift;
+
+    $self->{_binary} = 'test_transcendental';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+sub needs_model {
+    return 0;
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -27,7 +27,7 @@ use parent 'Bi::Visitor';
 use warnings;
 use strict;
 
-=item B<evaluate>(I<model>, I<actions>)
+=item B<evaluate>(I<model>, I<lefts>, I<rights>, I<names>)
 
 Evaluate.
 
@@ -37,15 +37,25 @@ Evaluate.
 
 L<Bi::Model> object.
 
-=item I<actions>
+=item I<lefts>
 
-Array ref of L<Bi::Action> objects returned by
-L<Bi::Visitor::StaticEvaluator>.
+Array ref of variable references returned by
+L<Bi::Visitor::StaticExtractor>.
+
+=item I<rights>
+
+Array ref of expressions returned by L<Bi::Visitor::StaticExtractor>.
+
+=item I<names>
+
+Array ref of the names of the top-level blocks in which to replace
+expressions. Optional, defaults to all blocks in which static
+subexpressions are used.
 
 =back
 
-Replaces any occurrences of the right hand side of each action with the
-left hand side (target).
+Replaces any occurrences of each expression in I<rights> with the
+corresponding variable reference in I<lefts>.
 
 =cut
 sub evaluate {
@@ -53,11 +63,16 @@ sub evaluate {
     my $model = shift;
     my $lefts = shift;
     my $rights = shift;
+    my $names = shift;
+    
+    if (!defined $names) {
+        $names = [ 'transition', 'lookahead_transition', 'observation', 'lookahead_observation', 'bridge' ];
+    }
 
     my $self = new Bi::Visitor; 
     bless $self, $class;
 
-    foreach my $name ('transition', 'lookahead_transition', 'observation', 'lookahead_observation', 'bridge') {
+    foreach my $name (@$names) {
         my $block = $model->get_block($name);
         if (defined $block) {
     	    $block->accept($self, $model, $lefts, $rights);
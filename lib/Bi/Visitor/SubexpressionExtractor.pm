@@ -0,0 +1,405 @@
+=head1 NAME
+
+Bi::Visitor::SubexpressionExtractor - visitor for hoisting common
+subexpressions and eliminating repeated subexpressions in dynamic blocks.
+
+=head1 SYNOPSIS
+
+    use Bi::Visitor::SubexpressionExtractor;
+
+    Bi::Visitor::SubexpressionExtractor->evaluate($model);
+
+=head1 INHERITS
+
+L<Bi::Visitor>
+
+=head1 DESCRIPTION
+
+Two transformations are applied to the actions of each of the
+C<transition> and C<lookahead_transition> blocks:
+
+=over 4
+
+=item 1.
+
+Maximal subexpressions that depend only on parameters, inputs and builtin
+variables (e.g. C<t_now>) are common to all trajectories and unchanged over
+the time step. Each is moved into a new auxiliary parameter, computed once
+per time step in a C<common_eval_> block, rather than once per trajectory in
+every action in which it appears.
+
+=item 2.
+
+Subexpressions that are not common, contain at least one function call and
+appear more than once in the block are each moved into a new auxiliary state
+variable, computed once per trajectory in an C<eval_> block.
+
+=back
+
+Common subexpressions are only extracted if no child of the block writes
+any of the variables on which they depend. The new actions are inserted at
+the start of the block, where they are wrapped into C<common_eval_> blocks
+that are evaluated once, before any sweep over trajectories (see
+L<Bi::Block/get_common_blocks>).
+
+Repeated subexpressions are only extracted if no child from the first that
+uses them onward writes any of the variables on which they depend, so that
+they have the same value in every place in which they are used. The new
+action is inserted immediately before that first child.
+
+This should be run after L<Bi::Visitor::StaticExtractor> and
+L<Bi::Visitor::StaticReplacer>, so that static subexpressions have already
+been moved into the C<parameter> block, and before
+L<Bi::Visitor::Wrapper>.
+
+=head1 METHODS
+
+=over 4
+
+=cut
+
+package Bi::Visitor::SubexpressionExtractor;
+
+use parent 'Bi::Visitor';
+use warnings;
+use strict;
+
+use Carp::Assert;
+
+use Bi::Utility qw(contains set_intersect);
+use Bi::Visitor::StaticReplacer;
+
+=item B<evaluate>(I<model>)
+
+Evaluate.
+
+=over 4
+
+=item I<model> L<Bi::Model> object.
+
+=back
+
+=cut
+sub evaluate {
+    my $class = shift;
+    my $model = shift;
+
+    my $self = new Bi::Visitor;
+    bless $self, $class;
+
+    foreach my $name ('transition', 'lookahead_transition') {
+        my $block = $model->get_block($name);
+        if (defined $block) {
+            $self->_hoist($model, $block);
+            $self->_eliminate($model, $block);
+        }
+    }
+}
+
+=item B<_hoist>(I<model>, I<block>)
+
+Hoist maximal common subexpressions of I<block> into C<common_eval_>
+actions at the start of the block.
+
+=cut
+sub _hoist {
+    my $self = shift;
+    my $model = shift;
+    my $block = shift;
+
+    my ($commons, $nodes) = $self->_collect($block);
+    my $groups = _group([ map { _is_trivial($_->{expr}) ? () : $_ } @$commons ]);
+
+    my $lefts = [];
+    my $rights = [];
+    my $actions = [];
+    foreach my $group (@$groups) {
+        if (_is_invariant($block, $group->{expr}, 0)) {
+            my $action = _extract($model, 'param_aux_', $group->{expr});
+            $action->set_parent('common_eval_');
+
+            push(@$lefts, $action->get_left);
+            push(@$rights, $group->{expr});
+            push(@$actions, [ $action, 0 ]);
+        }
+    }
+
+    Bi::Visitor::StaticReplacer->evaluate($model, $lefts, $rights, [ $block->get_name ]);
+    _insert($block, $actions);
+}
+
+=item B<_eliminate>(I<model>, I<block>)
+
+Eliminate repeated subexpressions of I<block> that contain function calls,
+largest first.
+
+=cut
+sub _eliminate {
+    my $self = shift;
+    my $model = shift;
+    my $block = shift;
+
+    my $found;
+    do {
+        my ($commons, $nodes) = $self->_collect($block);
+        my $groups = _group([ map { ($_->{func} && !$_->{common}) ? $_ : () } @$nodes ]);
+        my @groups = sort { $b->{size} <=> $a->{size} } @$groups;
+
+        $found = 0;
+        foreach my $group (@groups) {
+            if ($group->{count} > 1 && _is_invariant($block, $group->{expr}, $group->{first})) {
+                my $action = _extract($model, 'state_aux_', $group->{expr});
+
+                Bi::Visitor::StaticReplacer->evaluate($model, [ $action->get_left ], [ $group->{expr} ], [ $block->get_name ]);
+                _insert($block, [ [ $action, $group->{first} ] ]);
+                $found = 1;
+                last;
+            }
+        }
+    } while ($found);
+}
+
+=item B<_collect>(I<block>)
+
+Collect candidate subexpressions from the children of I<block>. Returns two
+array refs of hashes, each hash giving a subexpression (C<expr>), the index
+of the child of I<block> in which it appears (C<first>), its number of
+nodes (C<size>), whether it contains a function call (C<func>) and whether
+it is common to all trajectories (C<common>). The
+first array ref gives maximal common subexpressions, the second all
+candidate subexpressions.
+
+=cut
+sub _collect {
+    my $self = shift;
+    my $block = shift;
+
+    my $commons = [];
+    my $nodes = [];
+    my $children = $block->get_children;
+    for (my $k = 0; $k < @$children; ++$k) {
+        my $stack = [];
+        my $marks = [];
+        $children->[$k]->accept($self, $stack, $marks, $commons, $nodes, $k);
+    }
+
+    return ($commons, $nodes);
+}
+
+=item B<_group>(I<candidates>)
+
+Group equal candidate subexpressions, returning an array ref of hashes,
+each giving the subexpression (C<expr>), its number of nodes (C<size>), the
+number of times that it appears (C<count>) and the index of the first child
+in which it appears (C<first>).
+
+=cut
+sub _group {
+    my $candidates = shift;
+
+    my $groups = [];
+    foreach my $candidate (@$candidates) {
+        my $group;
+        foreach my $group1 (@$groups) {
+            if ($group1->{expr}->equals($candidate->{expr})) {
+                $group = $group1;
+                last;
+            }
+        }
+        if (defined $group) {
+            ++$group->{count};
+            if ($candidate->{first} < $group->{first}) {
+                $group->{first} = $candidate->{first};
+            }
+        } else {
+            push(@$groups, {
+                'expr' => $candidate->{expr},
+                'size' => $candidate->{size},
+                'count' => 1,
+                'first' => $candidate->{first}
+            });
+        }
+    }
+
+    return $groups;
+}
+
+=item B<_is_trivial>(I<expr>)
+
+Is there nothing to be gained by extracting I<expr>? Indexes and ranges are
+never extracted themselves, only the expressions within them.
+
+=cut
+sub _is_trivial {
+    my $expr = shift;
+
+    return $expr->isa('Bi::Expression::VarIdentifier') ||
+            $expr->isa('Bi::Expression::Index') ||
+            $expr->isa('Bi::Expression::Range') || $expr->is_const;
+}
+
+=item B<_is_invariant>(I<block>, I<expr>, I<first>)
+
+Is I<expr> unchanged by all children of I<block> from index I<first>
+onward?
+
+=cut
+sub _is_invariant {
+    my $block = shift;
+    my $expr = shift;
+    my $first = shift;
+
+    my $vars = [ map { $_->get_var } @{$expr->get_all_var_refs} ];
+    my $children = $block->get_children;
+    for (my $k = $first; $k < @$children; ++$k) {
+        if (@{set_intersect($vars, $children->[$k]->get_all_left_vars)} > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+=item B<_extract>(I<model>, I<type>, I<expr>)
+
+Create a new variable of type I<type> to hold the value of I<expr>, and
+return an action that computes it.
+
+=cut
+sub _extract {
+    my $model = shift;
+    my $type = shift;
+    my $expr = shift;
+
+    my $dims = [ map { $model->lookup_dim($_) } @{$expr->get_shape->get_sizes} ];
+    my $var = new Bi::Model::Var($type, undef, $dims, [], {
+        'has_input' => new Bi::Expression::IntegerLiteral(0),
+        'has_output' => new Bi::Expression::IntegerLiteral(0)
+    });
+    $model->push_var($var);
+
+    my $action = new Bi::Action;
+    $action->set_aliases($var->gen_aliases);
+    $action->set_left(new Bi::Expression::VarIdentifier($var, $var->gen_ranges));
+    $action->set_op('<-');
+    $action->set_right($expr->clone);
+    $action->validate;
+
+    return $action;
+}
+
+=item B<_insert>(I<block>, I<actions>)
+
+Insert actions into I<block>. I<actions> is an array ref of pairs, each
+giving an action and the index of the child before which it is to be
+inserted.
+
+=cut
+sub _insert {
+    my $block = shift;
+    my $actions = shift;
+
+    my $children = [ @{$block->get_children} ];
+    foreach my $pair (sort { $b->[1] <=> $a->[1] } @$actions) {
+        splice(@$children, $pair->[1], 0, $pair->[0]);
+    }
+    $block->set_children($children);
+}
+
+=item B<visit_before>(I<node>, I<stack>, I<marks>, I<commons>, I<nodes>, I<k>)
+
+Visit node.
+
+=cut
+sub visit_before {
+    my $self = shift;
+    my $node = shift;
+    my $stack = shift;
+    my $marks = shift;
+
+    push(@$marks, scalar(@$stack));
+
+    return $node;
+}
+
+=item B<visit_after>(I<node>, I<stack>, I<marks>, I<commons>, I<nodes>, I<k>)
+
+Visit node.
+
+=cut
+sub visit_after {
+    my $self = shift;
+    my $node = shift;
+    my $stack = shift;
+    my $marks = shift;
+    my $commons = shift;
+    my $nodes = shift;
+    my $k = shift;
+
+    my @children = splice(@$stack, pop(@$marks));
+    my $is_ok = 1;
+    my $is_common = 1;
+    my $size = 1;
+    my $func = $node->isa('Bi::Expression::Function');
+    my $num_commons = 0;
+    foreach my $child (@children) {
+        $is_ok = $is_ok && $child->{ok};
+        $is_common = $is_common && $child->{common};
+        $size += $child->{size};
+        $func = $func || $child->{func};
+        $num_commons += $child->{common};
+    }
+
+    if ($node->isa('Bi::Expression::VarIdentifier')) {
+        $is_common = $is_common && contains([ 'param', 'param_aux_', 'input', 'builtin_' ], $node->get_var->get_type);
+    } elsif (!($node->isa('Bi::Expression::BinaryOperator') ||
+            $node->isa('Bi::Expression::UnaryOperator') ||
+            $node->isa('Bi::Expression::TernaryOperator') ||
+            ($node->isa('Bi::Expression::Function') && $node->is_math) ||
+            $node->isa('Bi::Expression::Index') ||
+            $node->isa('Bi::Expression::Range') ||
+            $node->isa('Bi::Expression::ConstIdentifier') ||
+            $node->isa('Bi::Expression::Literal') ||
+            $node->isa('Bi::Expression::IntegerLiteral'))) {
+        $is_ok = 0;
+    }
+    $is_common = $is_common && $is_ok;
+
+    push(@$stack, {
+        'ok' => $is_ok,
+        'common' => $is_common,
+        'size' => $size,
+        'func' => $func
+    });
+    if ($is_common) {
+        splice(@$commons, -$num_commons, $num_commons) if $num_commons > 0;
+        push(@$commons, {
+            'expr' => $node->clone,
+            'first' => $k,
+            'size' => $size,
+            'func' => $func
+        });
+    }
+    if ($is_ok && !_is_trivial($node)) {
+        push(@$nodes, {
+            'expr' => $node->clone,
+            'first' => $k,
+            'size' => $size,
+            'func' => $func,
+            'common' => $is_common
+        });
+    }
+
+    return $node;
+}
+
+1;
+
+=back
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -70,8 +70,13 @@ sub _wrap {
 
         my $vars = [ @{$child->get_all_left_vars}, @{$child->get_all_right_vars} ];
         foreach my $vertex (@vertices) {
+            # child reads or writes what vertex writes, or child writes what
+            # vertex reads; the latter must also be ordered, as actions
+            # combined into one block may be evaluated concurrently
             my $left_vars = $vertex->get_all_left_vars;
-            if (@{set_intersect($vars, $left_vars)} > 0) {
+            my $right_vars = $vertex->get_all_right_vars;
+            if (@{set_intersect($vars, $left_vars)} > 0 ||
+                    @{set_intersect($child->get_all_left_vars, $right_vars)} > 0) {
                 $graph->add_edge($vertex, $child);
             }
         }
@@ -12,6 +12,9 @@
 #include "../misc/exception.hpp"
 #include "../math/vector.hpp"
 #include "../math/matrix.hpp"
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
 
 namespace bi {
 /**
@@ -32,6 +35,15 @@ public:
   GaussianAdapter(const bool local = false, const double scale = 0.25,
       const double essRel = 0.25);
 
+  /**
+   * Is the ESS high enough to adapt the proposal?
+   *
+   * @param s State.
+   * @param P Total number of particles, across all processes.
+   */
+  template<class S1>
+  bool ready(const S1& s, const int P) const;
+
   /**
    * Adapt the proposal.
    *
@@ -43,8 +55,38 @@ public:
   bool adapt(const S1& s);
 
 #ifdef ENABLE_MPI
+  /**
+   * Adapt the proposal, with moments reduced across processes in one
+   * collective.
+   *
+   * @param s State.
+   *
+   * @return Was the adaptation successful?
+   */
   template<class S1>
   bool distributedAdapt(const S1& s);
+
+  /**
+   * Add weighted moments of parameters to a reduction across processes, so
+   * that they may be reduced together with the statistics of other
+   * components.
+   *
+   * @param s State.
+   * @param[in,out] red Reduction, to which log-weights have been added.
+   */
+  template<class S1>
+  void contribute(const S1& s, StepReduction& red);
+
+  /**
+   * Adapt the proposal from a finished reduction.
+   *
+   * @param s State.
+   * @param red Reduction, to which #contribute has added.
+   *
+   * @return Was the adaptation successful?
+   */
+  template<class S1>
+  bool distributedAdapt(const S1& s, const StepReduction& red);
 #endif
 
   /**
@@ -97,6 +139,13 @@ private:
    * Minimum relative ESS to be considered ready.
    */
   double essRel;
+
+#ifdef ENABLE_MPI
+  /**
+   * Reduction for #distributedAdapt.
+   */
+  StepReduction red;
+#endif
 };
 }
 
@@ -112,12 +161,17 @@ private:
 #include "../cuda/cuda.hpp"
 #include "../mpi/mpi.hpp"
 
+template<class S1>
+inline bool bi::GaussianAdapter::ready(const S1& s, const int P) const {
+  return s.ess >= essRel * P;
+}
+
 template<class S1>
 bool bi::GaussianAdapter::adapt(const S1& s) {
   const int NP = s.s1s[0]->get(P_VAR).size2();
   const int P = s.size();
 
-  bool ready = s.ess >= essRel * P;
+  bool ready = this->ready(s, P);
   if (ready) {
     try {
       typename temp_host_matrix<real>::type X(P, NP);
@@ -159,47 +213,49 @@ bool bi::GaussianAdapter::adapt(const S1& s) {
 template<class S1>
 bool bi::GaussianAdapter::distributedAdapt(const S1& s) {
   boost::mpi::communicator world;
-  const int rank = world.rank();
   const int size = world.size();
-  const int NP = s.s1s[0]->get(P_VAR).size2();
   const int P = s.size();
 
-  bool ready = s.ess >= essRel * P * size;
+  bool ready = this->ready(s, P * size);
   if (ready) {
-    try {
-      typename temp_host_matrix<real>::type X(P, NP), Y(P,NP), Z(P,NP), Smu(NP, size), SSigma(NP*NP, size);
-      typename temp_host_vector<real>::type ws(P), vs(P);
+    red.clear();
+    red.logWeights(s.logWeights());
+    contribute(s, red);
+    red.reduce();
+    ready = distributedAdapt(s, red);
+  }
+  return ready;
+}
 
-      /* copy samples into single matrix */
-      for (int p = 0; p < P; ++p) {
-        row(X, p) = vec(s.s1s[p]->get(P_VAR));
-      }
-      synchronize();
+template<class S1>
+void bi::GaussianAdapter::contribute(const S1& s, StepReduction& red) {
+  const int NP = s.s1s[0]->get(P_VAR).size2();
+  const int P = s.size();
 
-      /* weights */
-      ws = s.logWeights();
-      double Wmax = max_reduce(ws);
-      Wmax = boost::mpi::all_reduce(world, Wmax, boost::mpi::maximum<double>());
-      subscal_elements(ws, Wmax, ws);
-      exp_elements(ws, ws);
-      double Wt = sum_reduce(ws);
-      Wt = boost::mpi::all_reduce(world, Wt, std::plus<double>());
+  typename temp_host_matrix<real>::type X(P, NP);
 
-      /* mean */
-      mu.resize(NP);
-      gemv(1.0/Wt, X, ws, 0.0, mu, 'T');
-      boost::mpi::all_gather(world, mu.buf(), NP, vec(Smu).buf());
-      sum_columns(Smu, mu);
+  /* copy samples into single matrix */
+  for (int p = 0; p < P; ++p) {
+    row(X, p) = vec(s.s1s[p]->get(P_VAR));
+  }
+  synchronize();
 
-      /* covariance */
+  red.moments(s.logWeights(), X);
+}
+
+template<class S1>
+bool bi::GaussianAdapter::distributedAdapt(const S1& s,
+    const StepReduction& red) {
+  const int NP = red.getDims();
+
+  bool ready = this->ready(s, red.getSize());
+  if (ready) {
+    try {
+      /* moments */
+      mu.resize(NP);
+      red.getMean(mu);
       Sigma.resize(NP, NP);
-      Y = X;
-      sub_rows(Y, mu);
-      sqrt_elements(ws, vs);
-      gdmm(1.0, vs, Y, 0.0, Z);
-      syrk(1.0/Wt, Z, 0.0, Sigma, 'U', 'T');
-      boost::mpi::all_gather(world, Sigma.buf(), NP*NP, vec(SSigma).buf());
-      sum_columns(SSigma, vec(Sigma));
+      red.getCov(Sigma);
 
       /* Cholesky factor of covariance */
       U.resize(NP, NP);
@@ -107,6 +107,16 @@ public:
    */
   void flush();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   typedef typename loc_matrix<CL,real>::type matrix_type;
   typedef typename loc_vector<CL,real>::type vector_type;
@@ -344,4 +354,15 @@ void bi::AdaptivePFCache<CL,IO1>::load(Archive& ar, const unsigned version) {
   ar & P;
 }
 
+template<bi::Location CL, class IO1>
+template<class W>
+void bi::AdaptivePFCache<CL,IO1>::wire(W& w) {
+  parent_type::wire(w);
+  particleCache.wire(w);
+  logWeightCache.wire(w);
+  ancestorCache.wire(w);
+  w.scalar(base);
+  w.scalar(P);
+}
+
 #endif
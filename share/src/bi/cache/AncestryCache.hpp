@@ -13,6 +13,7 @@
 #include "../misc/location.hpp"
 #include "../misc/TicToc.hpp"
 #include "../state/State.hpp"
+#include "SpillCache.hpp"
 #include "../model/Model.hpp"
 
 #include <vector>
@@ -25,6 +26,12 @@ namespace bi {
  * @ingroup io_cache
  *
  * @tparam CL Cache location.
+ *
+ * For long time series the tree may be given a memory budget with
+ * setMaxBytes(). When the budget would be exceeded, the coalesced stem of
+ * the tree (the ancestral path common to all surviving particles) is
+ * spilled to a memory-mapped file and its slots released, and readPath()
+ * pages it back in as required.
  */
 template<Location CL = ON_HOST>
 class AncestryCache {
@@ -105,6 +112,23 @@ public:
   void report() const;
   //@}
 
+  /**
+   * Set the memory budget of all ancestry caches at this location.
+   *
+   * @param bytes Budget, in bytes, or zero for no budget.
+   */
+  static void setMaxBytes(const long bytes);
+
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Initialise the ancestry tree with the first generation of particles.
@@ -142,6 +166,32 @@ private:
    */
   void enlarge(const int N);
 
+  /**
+   * Number of slots to which enlarge() will grow the cache.
+   *
+   * @param N Number of new particles for which to make room.
+   *
+   * Under a memory budget, growth is capped at the larger of the budget and
+   * the bare minimum needed for @p N new particles.
+   */
+  int enlargedSize(const int N) const;
+
+  /**
+   * Spill the coalesced stem of the tree to #spill.
+   *
+   * @return Number of nodes spilled.
+   *
+   * Nodes are spilled from the root downward for as long as the tree has a
+   * single root with a single surviving child. The youngest generation is
+   * never spilled.
+   */
+  int spillStem();
+
+  /**
+   * Size of the cache, in bytes, for a given number of slots.
+   */
+  long footprint(const int size) const;
+
   /**
    * Implementation of writeState().
    *
@@ -180,6 +230,12 @@ private:
    */
   int_vector_type ls;
 
+  /**
+   * Spilled stem. Row @c t gives the single surviving particle at time
+   * index @c t, for all @c t less than the time index of the root.
+   */
+  SpillCache spill;
+
   /**
    * Number of surviving nodes in the cache.
    */
@@ -195,6 +251,11 @@ private:
    */
   long usecs;
 
+  /**
+   * Memory budget, in bytes, zero for no budget.
+   */
+  static long maxBytes;
+
   /**
    * Serialize.
    */
@@ -230,6 +291,9 @@ private:
 
 #include <iomanip>
 
+template<bi::Location CL>
+long bi::AncestryCache<CL>::maxBytes = 0;
+
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache() :
     m(0), q(0), usecs(0) {
@@ -238,7 +302,8 @@ bi::AncestryCache<CL>::AncestryCache() :
 
 template<bi::Location CL>
 bi::AncestryCache<CL>::AncestryCache(const AncestryCache<CL>& o) :
-    Xs(o.Xs), as(o.as), os(o.os), ls(o.ls), m(o.m), q(o.q), usecs(o.usecs) {
+    Xs(o.Xs), as(o.as), os(o.os), ls(o.ls), spill(o.spill), m(o.m), q(o.q),
+    usecs(o.usecs) {
   //
 }
 
@@ -254,6 +319,7 @@ bi::AncestryCache<CL>& bi::AncestryCache<CL>::operator=(
   as = o.as;
   os = o.os;
   ls = o.ls;
+  spill = o.spill;
   m = o.m;
   q = o.q;
   usecs = o.usecs;
@@ -267,6 +333,7 @@ void bi::AncestryCache<CL>::swap(AncestryCache<CL>& o) {
   as.swap(o.as);
   os.swap(o.os);
   ls.swap(o.ls);
+  spill.swap(o.spill);
   std::swap(m, o.m);
   std::swap(q, o.q);
   std::swap(usecs, o.usecs);
@@ -276,6 +343,7 @@ template<bi::Location CL>
 void bi::AncestryCache<CL>::clear() {
   os.clear();
   ls.resize(0, false);
+  spill.clear();
   m = 0;
   q = 0;
   usecs = 0;
@@ -287,6 +355,7 @@ void bi::AncestryCache<CL>::empty() {
   as.resize(0, false);
   os.resize(0, false);
   ls.resize(0, false);
+  spill.empty();
   m = 0;
   q = 0;
   usecs = 0;
@@ -311,6 +380,16 @@ void bi::AncestryCache<CL>::readPath(const int p, M1 X) const {
     a = as1(a);
     --t;
   } while (a != -1);
+
+  /* page in spilled stem */
+  if (t >= 0) {
+    BI_ASSERT(t < spill.size());
+    typename temp_host_vector<real>::type x(spill.width());
+    for (; t >= 0; --t) {
+      spill.read(t, x);
+      column(X, t) = x;
+    }
+  }
 }
 
 template<bi::Location CL>
@@ -384,11 +463,7 @@ void bi::AncestryCache<CL>::enlarge(const int N) {
    *      have memory sizes much smaller than main memory.
    */
   int oldSize = Xs.size1();
-#ifdef ENABLE_CUDA
-  int newSize = oldSize + N;
-#else
-  int newSize = 2 * bi::max(oldSize, N);
-#endif
+  int newSize = enlargedSize(N);
 
   Xs.resize(newSize, Xs.size2(), true);
   as.resize(newSize, true);
@@ -402,6 +477,76 @@ void bi::AncestryCache<CL>::enlarge(const int N) {
   BI_ASSERT(Xs.size1() == os.size());
 }
 
+template<bi::Location CL>
+int bi::AncestryCache<CL>::enlargedSize(const int N) const {
+  /* see enlarge() for the heuristics */
+  const int oldSize = Xs.size1();
+#ifdef ENABLE_CUDA
+  int newSize = oldSize + N;
+#else
+  int newSize = 2 * bi::max(oldSize, N);
+#endif
+  if (maxBytes > 0 && footprint(newSize) > maxBytes) {
+    newSize = bi::max(oldSize + N,
+        static_cast<int>(maxBytes/footprint(1)));
+  }
+  return newSize;
+}
+
+template<bi::Location CL>
+int bi::AncestryCache<CL>::spillStem() {
+  typename temp_host_vector<int>::type as1(as.size()), os1(os.size());
+  as1 = as;
+  os1 = os;
+  synchronize(as.on_device);
+
+  /* walk from a leaf to the root; all paths share the root if only one */
+  std::vector<int> path;
+  int a = *(ls.begin());
+  do {
+    path.push_back(a);
+    a = as1(a);
+  } while (a != -1);
+
+  int root = path.back(), j, n = 0, numRoots = 0;
+  for (j = 0; j < as1.size(); ++j) {
+    if (as1(j) == -1 && os1(j) > 0) {
+      ++numRoots;
+    }
+  }
+
+  if (numRoots == 1 && path.size() > 1) {
+    typename temp_host_vector<real>::type x(Xs.size2());
+    j = path.size() - 1;
+    while (j > 0 && os1(path[j]) == 1) {
+      x = row(Xs, path[j]);
+      synchronize(Xs.on_device);
+      spill.push(x);
+      os1(path[j]) = 0;
+      --j;
+      ++n;
+    }
+    root = path[j];
+    as1(root) = -1;
+
+    as = as1;
+    os = os1;
+    synchronize(as.on_device);
+  }
+
+  return n;
+}
+
+template<bi::Location CL>
+long bi::AncestryCache<CL>::footprint(const int size) const {
+  return static_cast<long>(size)*(Xs.size2()*sizeof(real) + 2*sizeof(int));
+}
+
+template<bi::Location CL>
+void bi::AncestryCache<CL>::setMaxBytes(const long bytes) {
+  maxBytes = bytes;
+}
+
 template<bi::Location CL>
 template<class M1, class V1>
 void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
@@ -424,6 +569,10 @@ void bi::AncestryCache<CL>::writeState(const M1 X, const V1 as,
     if (r) {
       prune();
     }
+    if (Xs.size1() - m < X.size1() && maxBytes > 0 &&
+        footprint(enlargedSize(X.size1())) > maxBytes) {
+      m -= spillStem();
+    }
     if (Xs.size1() - m < X.size1()) {
       enlarge(X.size1());
     }
@@ -441,6 +590,7 @@ void bi::AncestryCache<CL>::report() const {
   std::cerr << "AncestryCache: ";
   std::cerr << Xs.size1() << " slots, ";
   std::cerr << m << " nodes, ";
+  std::cerr << spill.size() << " spilled, ";
   std::cerr << usecs << " us last write.";
   std::cerr << std::endl;
 }
@@ -452,6 +602,7 @@ void bi::AncestryCache<CL>::save(Archive& ar, const unsigned version) const {
   save_resizable_vector(ar, version, as);
   save_resizable_vector(ar, version, os);
   save_resizable_vector(ar, version, ls);
+  ar & spill;
   ar & m;
   ar & q;
   ar & usecs;
@@ -464,9 +615,23 @@ void bi::AncestryCache<CL>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, as);
   load_resizable_vector(ar, version, os);
   load_resizable_vector(ar, version, ls);
+  ar & spill;
   ar & m;
   ar & q;
   ar & usecs;
 }
 
+template<bi::Location CL>
+template<class W>
+void bi::AncestryCache<CL>::wire(W& w) {
+  w.matrix(Xs);
+  w.vector(as);
+  w.vector(os);
+  w.vector(ls);
+  spill.wire(w);
+  w.scalar(m);
+  w.scalar(q);
+  w.scalar(usecs);
+}
+
 #endif
@@ -105,6 +105,16 @@ public:
    */
   void flush();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Ancestry cache.
@@ -256,4 +266,12 @@ void bi::BootstrapPFCache<CL,IO1>::load(Archive& ar, const unsigned version) {
   ar & logWeightsCache;
 }
 
+template<bi::Location CL, class IO1>
+template<class W>
+void bi::BootstrapPFCache<CL,IO1>::wire(W& w) {
+  parent_type::wire(w);
+  ancestryCache.wire(w);
+  logWeightsCache.wire(w);
+}
+
 #endif
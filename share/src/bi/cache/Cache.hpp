@@ -9,6 +9,7 @@
 #define BI_CACHE_CACHE_HPP
 
 #include "../math/vector.hpp"
+#include "../math/wire.hpp"
 
 namespace bi {
 /**
@@ -135,6 +136,16 @@ public:
    */
   void empty();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Validity of each page.
@@ -210,4 +221,10 @@ void bi::Cache::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, dirties);
 }
 
+template<class W>
+void bi::Cache::wire(W& w) {
+  w.vector(valids);
+  w.vector(dirties);
+}
+
 #endif
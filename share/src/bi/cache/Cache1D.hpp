@@ -105,6 +105,16 @@ public:
    */
   void empty();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Pages.
@@ -230,4 +240,11 @@ void bi::Cache1D<T1,CL>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, pages);
 }
 
+template<class T1, bi::Location CL>
+template<class W>
+void bi::Cache1D<T1,CL>::wire(W& w) {
+  Cache::wire(w);
+  w.vector(pages);
+}
+
 #endif
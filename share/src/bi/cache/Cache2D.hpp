@@ -94,6 +94,16 @@ public:
    */
   void empty();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Pages.
@@ -212,4 +222,11 @@ void bi::Cache2D<T1,CL>::load(Archive& ar, const unsigned version) {
   load_resizable_matrix(ar, version, pages);
 }
 
+template<class T1, bi::Location CL>
+template<class W>
+void bi::Cache2D<T1,CL>::wire(W& w) {
+  Cache::wire(w);
+  w.matrix(pages);
+}
+
 #endif
@@ -115,6 +115,16 @@ public:
    */
   void empty();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Contents of cache.
@@ -243,4 +253,11 @@ void bi::CacheCross<T1,CL>::load(Archive& ar, const unsigned version) {
   load_resizable_matrix(ar, version, X);
 }
 
+template<class T1, bi::Location CL>
+template<class W>
+void bi::CacheCross<T1,CL>::wire(W& w) {
+  Cache::wire(w);
+  w.matrix(X);
+}
+
 #endif
@@ -76,6 +76,16 @@ public:
    */
   void empty();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Pages.
@@ -215,4 +225,34 @@ void bi::CacheObject<T1>::load(Archive& ar, const unsigned version) {
   ar & pages;
 }
 
+template<class T1>
+template<class W>
+void bi::CacheObject<T1>::wire(W& w) {
+  Cache::wire(w);
+
+  int size = pages.size(), present, i;
+  w.dim(size);
+  if (W::is_loading) {
+    for (i = size; i < static_cast<int>(pages.size()); ++i) {
+      delete pages[i];
+    }
+    pages.resize(size, NULL);
+  }
+
+  /* each page is preceded by a flag indicating whether it is present */
+  for (i = 0; i < size; ++i) {
+    present = (pages[i] != NULL) ? 1 : 0;
+    w.dim(present);
+    if (present) {
+      if (pages[i] == NULL) {
+        pages[i] = new T1();
+      }
+      w.value(*pages[i]);
+    } else if (pages[i] != NULL) {
+      delete pages[i];
+      pages[i] = NULL;
+    }
+  }
+}
+
 #endif
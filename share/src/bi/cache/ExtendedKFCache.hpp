@@ -153,6 +153,16 @@ public:
    */
   void flush();
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Vector type for caches.
@@ -407,4 +417,15 @@ void bi::ExtendedKFCache<CL,IO1>::load(Archive& ar, const unsigned version) {
   ar & CCache;
 }
 
+template<bi::Location CL, class IO1>
+template<class W>
+void bi::ExtendedKFCache<CL,IO1>::wire(W& w) {
+  parent_type::wire(w);
+  mu1Cache.wire(w);
+  U1Cache.wire(w);
+  mu2Cache.wire(w);
+  U2Cache.wire(w);
+  CCache.wire(w);
+}
+
 #endif
@@ -104,6 +104,16 @@ public:
    */
   int len;
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Serialize.
@@ -238,4 +248,11 @@ void bi::SimulatorCache<CL,IO1>::load(Archive& ar, const unsigned version) {
   ar & len;
 }
 
+template<bi::Location CL, class IO1>
+template<class W>
+void bi::SimulatorCache<CL,IO1>::wire(W& w) {
+  timeCache.wire(w);
+  w.scalar(len);
+}
+
 #endif
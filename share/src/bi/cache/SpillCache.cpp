@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "SpillCache.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+
+bi::SpillFile::SpillFile() : fd(-1), ptr(NULL), capacity(0) {
+  const char* dir = getenv("TMPDIR");
+  std::string path((dir != NULL) ? dir : "/tmp");
+  path += "/libbi-spill-XXXXXX";
+
+  std::vector<char> tmpl(path.begin(), path.end());
+  tmpl.push_back('\0');
+  fd = mkstemp(&tmpl[0]);
+  BI_ERROR_MSG(fd >= 0, "Could not create spill file " << &tmpl[0]);
+  unlink(&tmpl[0]);
+}
+
+bi::SpillFile::~SpillFile() {
+  if (ptr != NULL) {
+    munmap(ptr, capacity);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+void bi::SpillFile::reserve(const size_t bytes) {
+  if (bytes > capacity) {
+    const size_t page = sysconf(_SC_PAGESIZE);
+    size_t newCapacity = (capacity > 0) ? 2*capacity : 16*page;
+    while (newCapacity < bytes) {
+      newCapacity *= 2;
+    }
+
+    if (ptr != NULL) {
+      munmap(ptr, capacity);
+      ptr = NULL;
+    }
+    int err = ftruncate(fd, newCapacity);
+    BI_ERROR_MSG(err == 0, "Could not enlarge spill file to " <<
+        newCapacity << " bytes");
+    void* p = mmap(NULL, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0);
+    BI_ERROR_MSG(p != MAP_FAILED, "Could not map spill file");
+    ptr = static_cast<char*>(p);
+    capacity = newCapacity;
+  }
+}
+
+bi::SpillCache::SpillCache() : rows(0), cols(0) {
+  //
+}
+
+bi::SpillCache::SpillCache(const SpillCache& o) : file(o.file), rows(o.rows),
+    cols(o.cols) {
+  //
+}
+
+bi::SpillCache& bi::SpillCache::operator=(const SpillCache& o) {
+  if (o.file.get() != file.get()) {
+    rows = 0;
+    cols = o.cols;
+    if (o.rows > 0) {
+      if (file.get() == NULL) {
+        file.reset(new SpillFile());
+      }
+      file->reserve(o.rows*o.cols*sizeof(real));
+      memcpy(file->buf(), o.file->buf(), o.rows*o.cols*sizeof(real));
+    }
+  }
+  rows = o.rows;
+  cols = o.cols;
+
+  return *this;
+}
+
+void bi::SpillCache::swap(SpillCache& o) {
+  file.swap(o.file);
+  std::swap(rows, o.rows);
+  std::swap(cols, o.cols);
+}
+
+void bi::SpillCache::clear() {
+  rows = 0;
+}
+
+void bi::SpillCache::empty() {
+  file.reset();
+  rows = 0;
+  cols = 0;
+}
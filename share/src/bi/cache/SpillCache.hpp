@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_CACHE_SPILLCACHE_HPP
+#define BI_CACHE_SPILLCACHE_HPP
+
+#include "../math/scalar.hpp"
+#include "../misc/assert.hpp"
+
+#include "boost/shared_ptr.hpp"
+#include "boost/serialization/split_member.hpp"
+
+#include <cstddef>
+#include <limits>
+
+namespace bi {
+/**
+ * Memory-mapped temporary file.
+ *
+ * @ingroup io_cache
+ *
+ * The file is created in the directory given by the @c TMPDIR environment
+ * variable, or @c /tmp if that is not set, and is unlinked immediately, so
+ * that it is removed when closed, even on abnormal termination.
+ */
+class SpillFile {
+public:
+  /**
+   * Constructor.
+   */
+  SpillFile();
+
+  /**
+   * Destructor.
+   */
+  ~SpillFile();
+
+  /**
+   * Ensure capacity.
+   *
+   * @param bytes Minimum size of file, in bytes.
+   *
+   * The file grows geometrically, and is remapped when it grows.
+   */
+  void reserve(const size_t bytes);
+
+  /**
+   * Start of mapping.
+   */
+  char* buf();
+
+  /**
+   * Start of mapping.
+   */
+  const char* buf() const;
+
+private:
+  /**
+   * Copy constructor, disabled.
+   */
+  SpillFile(const SpillFile& o);
+
+  /**
+   * Assignment operator, disabled.
+   */
+  SpillFile& operator=(const SpillFile& o);
+
+  /**
+   * File descriptor.
+   */
+  int fd;
+
+  /**
+   * Start of mapping.
+   */
+  char* ptr;
+
+  /**
+   * Size of file and mapping, in bytes.
+   */
+  size_t capacity;
+};
+
+/**
+ * Append-only store of fixed-width rows, held in a memory-mapped temporary
+ * file rather than in memory.
+ *
+ * @ingroup io_cache
+ *
+ * Pages of the mapping are backed by the file, not by swap, so the
+ * operating system is free to evict them under memory pressure, and reads
+ * page them back in as required. The file is not created until the first
+ * row is written.
+ */
+class SpillCache {
+public:
+  /**
+   * Constructor.
+   */
+  SpillCache();
+
+  /**
+   * Shallow copy constructor.
+   */
+  SpillCache(const SpillCache& o);
+
+  /**
+   * Deep assignment operator.
+   */
+  SpillCache& operator=(const SpillCache& o);
+
+  /**
+   * Swap the contents of the cache with that of another.
+   */
+  void swap(SpillCache& o);
+
+  /**
+   * Number of rows.
+   */
+  int size() const;
+
+  /**
+   * Number of columns.
+   */
+  int width() const;
+
+  /**
+   * Append row.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param x Row.
+   */
+  template<class V1>
+  void push(const V1 x);
+
+  /**
+   * Read row.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param i Row index.
+   * @param[out] x Row.
+   */
+  template<class V1>
+  void read(const int i, V1 x) const;
+
+  /**
+   * Clear the cache, retaining the file for reuse.
+   */
+  void clear();
+
+  /**
+   * Empty the cache, closing the file.
+   */
+  void empty();
+
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
+private:
+  /**
+   * File.
+   */
+  boost::shared_ptr<SpillFile> file;
+
+  /**
+   * Number of rows.
+   */
+  int rows;
+
+  /**
+   * Number of columns.
+   */
+  int cols;
+
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+inline char* bi::SpillFile::buf() {
+  return ptr;
+}
+
+inline const char* bi::SpillFile::buf() const {
+  return ptr;
+}
+
+inline int bi::SpillCache::size() const {
+  return rows;
+}
+
+inline int bi::SpillCache::width() const {
+  return cols;
+}
+
+template<class V1>
+void bi::SpillCache::push(const V1 x) {
+  /* pre-conditions */
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(rows == 0 || x.size() == cols);
+
+  if (file.get() == NULL) {
+    file.reset(new SpillFile());
+  }
+  if (rows == 0) {
+    cols = x.size();
+  }
+  file->reserve((rows + 1)*cols*sizeof(real));
+
+  real* row = reinterpret_cast<real*>(file->buf()) + rows*cols;
+  for (int j = 0; j < cols; ++j) {
+    row[j] = x(j);
+  }
+  ++rows;
+}
+
+template<class V1>
+void bi::SpillCache::read(const int i, V1 x) const {
+  /* pre-conditions */
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(i >= 0 && i < rows);
+  BI_ASSERT(x.size() == cols);
+
+  const real* row = reinterpret_cast<const real*>(file->buf()) + i*cols;
+  for (int j = 0; j < cols; ++j) {
+    x(j) = row[j];
+  }
+}
+
+template<class Archive>
+void bi::SpillCache::save(Archive& ar, const unsigned version) const {
+  ar & rows;
+  ar & cols;
+  if (rows > 0) {
+    const real* row = reinterpret_cast<const real*>(file->buf());
+    for (int k = 0; k < rows*cols; ++k) {
+      ar & row[k];
+    }
+  }
+}
+
+template<class Archive>
+void bi::SpillCache::load(Archive& ar, const unsigned version) {
+  int rows1;
+  ar & rows1;
+  ar & cols;
+  clear();
+  if (rows1 > 0) {
+    if (file.get() == NULL) {
+      file.reset(new SpillFile());
+    }
+    file->reserve(rows1*cols*sizeof(real));
+    real* row = reinterpret_cast<real*>(file->buf());
+    for (int k = 0; k < rows1*cols; ++k) {
+      ar & row[k];
+    }
+  }
+  rows = rows1;
+}
+
+template<class W>
+void bi::SpillCache::wire(W& w) {
+  int rows1 = rows;
+  w.dim(rows1);
+  w.dim(cols);
+  BI_ERROR_MSG(cols == 0 ||
+      (size_t)rows1 <= std::numeric_limits<size_t>::max()/sizeof(real)/cols,
+      "Spill cache in wire format has dimensions " << rows1 << "x" << cols <<
+      " that are too large");
+  const size_t bytes = (size_t)rows1*cols*sizeof(real);
+  w.expect(bytes);
+  if (W::is_loading) {
+    clear();
+    if (rows1 > 0) {
+      if (file.get() == NULL) {
+        file.reset(new SpillFile());
+      }
+      file->reserve(bytes);
+    }
+  }
+  if (rows1 > 0) {
+    w.block(file->buf(), bytes);
+  }
+  rows = rows1;
+}
+
+#endif
@@ -24,6 +24,10 @@ class DynamicUpdaterGPU {
 public:
   template<class T1>
   static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s,
+      const int p);
 };
 }
 
@@ -49,4 +53,25 @@ void bi::DynamicUpdaterGPU<B,S>::update(const T1 t1, const T1 t2,
   }
 }
 
+template<class B, class S>
+template<class T1>
+void bi::DynamicUpdaterGPU<B,S>::update(const T1 t1, const T1 t2,
+    State<B,ON_DEVICE>& s, const int p) {
+  /* pre-condition */
+  BI_ASSERT(p >= 0 && p < s.size());
+
+  const int N = (block_is_matrix<S>::value) ? block_count<S>::value : block_size<S>::value;
+  dim3 Db, Dg;
+
+  Db.x = 1;
+  Db.y = 1;
+  Dg.x = 1;
+  Dg.y = N;
+
+  if (N > 0) {
+    kernelDynamicUpdater<B,S,T1><<<Dg,Db>>>(t1, t2, s, p);
+    CUDA_CHECK;
+  }
+}
+
 #endif
@@ -26,6 +26,22 @@ template<class B, class S, class T1>
 CUDA_FUNC_GLOBAL void kernelDynamicUpdater(const T1 t1, const T1 t2,
     State<B,ON_DEVICE> s);
 
+/**
+ * Kernel function for dynamic update of single trajectory.
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam T1 Scalar type.
+ *
+ * @param t1 Start time.
+ * @param t2 End time.
+ * @param[in,out] s State.
+ * @param p Trajectory index.
+ */
+template<class B, class S, class T1>
+CUDA_FUNC_GLOBAL void kernelDynamicUpdater(const T1 t1, const T1 t2,
+    State<B,ON_DEVICE> s, const int p);
+
 }
 
 #include "DynamicUpdaterMatrixVisitorGPU.cuh"
@@ -57,4 +73,22 @@ CUDA_FUNC_GLOBAL void bi::kernelDynamicUpdater(const T1 t1, const T1 t2,
   }
 }
 
+template<class B, class S, class T1>
+CUDA_FUNC_GLOBAL void bi::kernelDynamicUpdater(const T1 t1, const T1 t2,
+    State<B,ON_DEVICE> s, const int p) {
+  typedef Pa<ON_DEVICE,B,global,global,global,global> PX;
+  typedef Ou<ON_DEVICE,B,global> OX;
+  typedef DynamicUpdaterMatrixVisitorGPU<B,S,T1,PX,OX> MatrixVisitor;
+  typedef DynamicUpdaterVisitorGPU<B,S,T1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  const int i = blockIdx.y*blockDim.y + threadIdx.y;
+  PX pax;
+  OX x;
+
+  /* update */
+  Visitor::accept(t1, t2, s, p, i, pax, x);
+}
+
 #endif
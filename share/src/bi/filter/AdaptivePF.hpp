@@ -99,6 +99,15 @@ private:
    */
   int blockP;
 };
+
+/**
+ * AdaptivePF adds the log-likelihood increment of each observation at the
+ * start of the following step.
+ */
+template<class B, class F, class O, class R, class S2>
+struct filter_likelihood_lags<AdaptivePF<B,F,O,R,S2> > {
+  static const bool value = true;
+};
 }
 
 #include "../primitive/vector_primitive.hpp"
@@ -144,13 +153,17 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
 
   const int P = s.size();
   const int N = s.getDyn().size2();
+  const int M = s.getStep().size2();
 
   /* state at current time */
-  matrix_type X(P, N);
+  matrix_type X(P, N), Xs(P, M);
   vector_type lws(P);
   int_vector_type as(P);
 
   X = s.getDyn();
+  if (M > 0) {
+    Xs = s.getStep();
+  }
   lws = s.logWeights();
   as = s.ancestors();
 
@@ -159,8 +172,9 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
   BOOST_AUTO(iter1, iter);
 
   /* marginal log-likelihood increment */
-  s.logLikelihood += logsumexp_reduce(s.logWeights())
-      - bi::log(static_cast<double>(s.size()));
+  double lW;
+  logweight_reduce(s.logWeights(), NULL, &lW);
+  s.logLikelihood += lW - bi::log(static_cast<double>(s.size()));
 
   /* prepare resampler */
   if (iter->isObserved() && resampler_needs_max<R>::value) {
@@ -184,10 +198,16 @@ void bi::AdaptivePF<B,F,O,R,S2>::step(Random& rng, ScheduleIterator& iter,
         if (iter1->hasOutput()) {
           this->resam.ancestors(rng, lws, s.ancestors(), pre);
           this->resam.copy(s.ancestors(), X, s.getDyn());
+          if (M > 0) {
+            this->resam.copy(s.ancestors(), Xs, s.getStep());
+          }
         } else {
           typename S1::temp_int_vector_type as1(blockP);
           this->resam.ancestors(rng, lws, as1, pre);
           this->resam.copy(as1, X, s.getDyn());
+          if (M > 0) {
+            this->resam.copy(as1, Xs, s.getStep());
+          }
           bi::gather(as1, as, s.ancestors());
         }
         s.logWeights().clear();
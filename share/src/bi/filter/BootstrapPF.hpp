@@ -96,6 +96,28 @@ public:
   template<class S1>
   void correct(Random& rng, const ScheduleElement now, S1& s);
 
+  /**
+   * Predict, then update particle weights using observations at the new
+   * time.
+   *
+   * @tparam S1 State type.
+   *
+   * @param rng Random number generator.
+   * @param next Next step in time schedule.
+   * @param s State.
+   *
+   * Equivalent to predict() followed by correct(). On host, where @p next
+   * is observed, and where the model permits it (see
+   * Model::TRANSITION_CAN_TILE), the part of the transition common to all
+   * particles is computed first, then particles are divided into tiles,
+   * and each thread takes a tile at a time through the rest of the
+   * transition, observation log-density and a partial reduction of
+   * log-weights while it remains in cache. The partial reductions are
+   * combined at the end.
+   */
+  template<class S1>
+  void predictCorrect(Random& rng, const ScheduleElement next, S1& s);
+
   /**
    * Resample.
    *
@@ -134,10 +156,20 @@ protected:
    */
   R& resam;
 };
+
+/**
+ * BootstrapPF is reentrant.
+ */
+template<class B, class F, class O, class R>
+struct filter_is_reentrant<BootstrapPF<B,F,O,R> > {
+  static const bool value = true;
+};
 }
 
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
+#include "../math/temp_vector.hpp"
+#include "../misc/omp.hpp"
 #include "../traits/resampler_traits.hpp"
 
 template<class B, class F, class O, class R>
@@ -163,8 +195,7 @@ void bi::BootstrapPF<B,F,O,R>::step(Random& rng, ScheduleIterator& iter,
   do {
     this->resample(rng, *iter, s);
     ++iter;
-    this->predict(rng, *iter, s);
-    this->correct(rng, *iter, s);
+    this->predictCorrect(rng, *iter, s);
     this->output(*iter, s, out);
   } while (iter + 1 != last && !iter->isObserved());
 }
@@ -183,6 +214,83 @@ void bi::BootstrapPF<B,F,O,R>::correct(Random& rng, const ScheduleElement now,
   }
 }
 
+template<class B, class F, class O, class R>
+template<class S1>
+void bi::BootstrapPF<B,F,O,R>::predictCorrect(Random& rng,
+    const ScheduleElement next, S1& s) {
+  if (S1::on_device || !next.isObserved() || !B::TRANSITION_CAN_TILE) {
+    this->predict(rng, next, s);
+    this->correct(rng, next, s);
+  } else {
+    typedef typename temp_host_vector<double>::type vector_type;
+
+    const int P = s.size();
+    const int Q = tile_size(P, s.getDyn().size2());
+    const int T = (P + Q - 1)/Q;
+    vector_type lW1s(T), lW2s(T);
+
+    if (next.hasInput()) {
+      this->in.update(next.indexInput(), s);
+    }
+    if (next.hasObs()) {
+      this->obs.update(next.indexObs(), s);
+    }
+
+    /* common to all trajectories, so once only, before tiles */
+    this->m.transitionCommonSamples(rng, next.getFrom(), next.getTo(),
+        next.hasDelta(), s);
+
+    #pragma omp parallel
+    {
+      int t, i, start;
+      double mx, W1, W2, w;
+
+      #pragma omp for schedule(static)
+      for (t = 0; t < T; ++t) {
+        /* shallow copy for own active range, and own builtins, so that
+         * the time of one tile is not seen by another */
+        S1 s1(s);
+        start = t*Q;
+        s1.setRange(s.start() + start, bi::min(Q, P - start));
+
+        /* predict and correct */
+        this->m.transitionTrajectorySamples(rng, next.getFrom(),
+            next.getTo(), next.hasDelta(), s1);
+        s1.setTime(next.getTime());
+        this->m.observationLogDensities(s1,
+            this->obs.getMask(next.indexObs()), s1.logWeights());
+
+        /* partial reduction of log-weights, NaN give zero weight */
+        BOOST_AUTO(lws, s1.logWeights());
+        mx = -BI_INF;
+        for (i = 0; i < lws.size(); ++i) {
+          mx = (lws(i) > mx) ? lws(i) : mx;
+        }
+        W1 = 0.0;
+        W2 = 0.0;
+        if (mx > -BI_INF) {
+          for (i = 0; i < lws.size(); ++i) {
+            w = bi::nanexp(lws(i) - mx);
+            W1 += w;
+            W2 += w*w;
+          }
+        }
+        lW1s(t) = mx + bi::log(W1);
+        lW2s(t) = 2.0*mx + bi::log(W2);
+      }
+    }
+    s.setTime(next.getTime());
+
+    /* combine partial reductions */
+    double lW1, lW2, lW;
+    logweight_reduce(lW1s, NULL, &lW1);
+    logweight_reduce(lW2s, NULL, &lW2);
+    s.ess = resam.reduce(P, lW1, lW2, &lW);
+    s.logIncrements(next.indexObs()) = lW - s.logLikelihood;
+    s.logLikelihood = lW;
+  }
+}
+
 template<class B, class F, class O, class R>
 template<class S1>
 void bi::BootstrapPF<B,F,O,R>::resample(Random& rng,
@@ -194,8 +302,9 @@ void bi::BootstrapPF<B,F,O,R>::resample(Random& rng,
 template<class B, class F, class O, class R>
 template<class S1>
 void bi::BootstrapPF<B,F,O,R>::term(S1& s) {
-  s.logLikelihood = logsumexp_reduce(s.logWeights())
-      - bi::log(double(s.size()));
+  double lW;
+  logweight_reduce(s.logWeights(), NULL, &lW);
+  s.logLikelihood = lW - bi::log(double(s.size()));
   Simulator<B,F,O>::term(s);
 }
 
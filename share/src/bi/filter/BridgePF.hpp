@@ -88,6 +88,14 @@ protected:
   template<class S1>
   double getMaxLogWeightBridge(const ScheduleElement now, S1& s);
 };
+
+/**
+ * BridgePF is reentrant.
+ */
+template<class B, class F, class O, class R>
+struct filter_is_reentrant<BridgePF<B,F,O,R> > {
+  static const bool value = true;
+};
 }
 
 #include "../primitive/vector_primitive.hpp"
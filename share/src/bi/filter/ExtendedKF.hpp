@@ -100,6 +100,14 @@ protected:
   static const int NO = B::NO;
   static const int M = NR + ND;
 };
+
+/**
+ * ExtendedKF is reentrant.
+ */
+template<class B, class F, class O>
+struct filter_is_reentrant<ExtendedKF<B,F,O> > {
+  static const bool value = true;
+};
 }
 
 #include "../math/view.hpp"
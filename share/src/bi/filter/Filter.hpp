@@ -12,6 +12,7 @@
 #include "../state/Schedule.hpp"
 #include "../misc/TicToc.hpp"
 #include "../misc/macro.hpp"
+#include "../traits/filter_traits.hpp"
 
 namespace bi {
 /**
@@ -52,6 +53,43 @@ public:
   void filter(Random& rng, const ScheduleIterator first,
       const ScheduleIterator last, S1& s, IO1& out, TicToc& clock,
       const long deadline);
+
+  /**
+   * %Filter, with early rejection.
+   *
+   * @param threshold Log-likelihood threshold.
+   * @param bound Upper bound on the log-likelihood increment at each
+   * observation.
+   *
+   * Stops at the first observation at which the log-likelihood so far,
+   * plus @p bound for each observation remaining, is no greater than
+   * @p threshold. The log-likelihood is then set to \f$-\infty\f$ and
+   * the output is left incomplete. For filters whose log-likelihood lags by
+   * one observation (see filter_likelihood_lags), the current observation
+   * counts as remaining.
+   *
+   * @return Was the filter run to completion?
+   */
+  template<class S1, class IO1>
+  bool filter(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO1& out, const double threshold,
+      const double bound);
+};
+
+/**
+ * Filter wrapper is reentrant if its base filter is.
+ */
+template<class F>
+struct filter_is_reentrant<Filter<F> > {
+  static const bool value = filter_is_reentrant<F>::value;
+};
+
+/**
+ * Filter wrapper log-likelihood lags if that of its base filter does.
+ */
+template<class F>
+struct filter_likelihood_lags<Filter<F> > {
+  static const bool value = filter_likelihood_lags<F>::value;
 };
 }
 
@@ -93,4 +131,38 @@ void bi::Filter<F>::filter(Random& rng, const ScheduleIterator first,
   }
 }
 
+template<class F>
+template<class S1, class IO1>
+bool bi::Filter<F>::filter(Random& rng, const ScheduleIterator first,
+    const ScheduleIterator last, S1& s, IO1& out, const double threshold,
+    const double bound) {
+  TicToc clock;
+  ScheduleIterator iter = first;
+  const int nobs = (last - 1)->indexObs() + ((last - 1)->isObserved() ? 1 : 0);
+  const int lag = filter_likelihood_lags<F>::value ? 1 : 0;
+  bool reject = false;
+
+  this->output0(s, out);
+  this->correct(rng, *iter, s);
+  this->output(*iter, s, out);
+  do {
+    if (iter->isObserved()) {
+      const int remaining = nobs - iter->indexObs() - 1 + lag;
+      reject = s.logLikelihood + bound*remaining <= threshold;
+    }
+    if (!reject && iter + 1 != last) {
+      this->step(rng, iter, last, s, out);
+    }
+  } while (!reject && iter + 1 != last);
+
+  if (reject) {
+    s.logLikelihood = -BI_INF;
+  } else {
+    this->term(s);
+    s.clock = clock.toc();
+    this->outputT(s, out);
+  }
+  return !reject;
+}
+
 #endif
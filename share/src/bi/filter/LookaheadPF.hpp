@@ -66,6 +66,14 @@ public:
       const ScheduleIterator last, S1& s);
   //@}
 };
+
+/**
+ * LookaheadPF is reentrant.
+ */
+template<class B, class F, class O, class R>
+struct filter_is_reentrant<LookaheadPF<B,F,O,R> > {
+  static const bool value = true;
+};
 }
 
 #include "../math/loc_temp_matrix.hpp"
@@ -101,7 +109,10 @@ void bi::LookaheadPF<B,F,O,R>::bridge(Random& rng,
     /* save previous state */
     typename loc_temp_matrix<S1::location,real>::type X(s.getDyn().size1(),
         s.getDyn().size2());
+    typename loc_temp_matrix<S1::location,real>::type Xs(
+        s.getStep().size1(), s.getStep().size2());
     X = s.getDyn();
+    Xs = s.getStep();
     real t = s.getTime();
     real tInput = s.getLastInputTime();
     real tObs = s.getNextObsTime();
@@ -117,6 +128,7 @@ void bi::LookaheadPF<B,F,O,R>::bridge(Random& rng,
 
     /* restore previous state */
     s.getDyn() = X;
+    s.getStep() = Xs;
     s.setTime(t);
     s.setLastInputTime(tInput);
     s.setNextObsTime(tObs);
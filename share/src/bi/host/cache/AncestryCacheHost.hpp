@@ -9,6 +9,22 @@
 #define BI_HOST_CACHE_ANCESTRYCACHEHOST_HPP
 
 namespace bi {
+/**
+ * AncestryCache implementation on host.
+ *
+ * Offspring counts serve as reference counts on nodes of the tree. Pruning
+ * is performed in parallel over leaves, with each thread walking up the
+ * tree from a leaf with no offspring, atomically decrementing the count of
+ * each ancestor and stopping at the first that remains referenced. No
+ * locks are required, as only the thread that takes a count to zero
+ * proceeds to that node's ancestor.
+ *
+ * Freed slots are not collected eagerly. Insertion instead sweeps a cursor
+ * around the storage, as a next-fit allocator, compacting the indices of
+ * free slots found in each subrange with a parallel scan. The cost of
+ * collection is thus amortised over steps, and proportional to the number
+ * of particles inserted rather than to the size of the storage.
+ */
 class AncestryCacheHost {
 public:
   /**
@@ -54,22 +70,36 @@ public:
 #include "../../math/view.hpp"
 #include "../../primitive/vector_primitive.hpp"
 #include "../../primitive/matrix_primitive.hpp"
+#include "../../misc/omp.hpp"
 
 template<class V1>
 int bi::AncestryCacheHost::prune(V1& as, V1& os, V1& ls) {
   /* pre-condition */
   BI_ASSERT(!V1::on_device);
 
-  int i, j, numRemoved = 0;
-  for (i = 0; i < ls.size(); ++i) {
-    j = ls(i);
-    while (os(j) == 0) {
-      ++numRemoved;
-      j = as(j);
-      if (j >= 0) {
-        --os(j);
-      } else {
-        break;
+  int numRemoved = 0;
+
+  #pragma omp parallel
+  {
+    int i, j, o;
+
+    #pragma omp for reduction(+:numRemoved)
+    for (i = 0; i < ls.size(); ++i) {
+      j = ls(i);
+      if (os(j) == 0) {
+        ++numRemoved;
+        j = as(j);
+        while (j >= 0) {
+          int& oj = os(j);
+          #pragma omp atomic capture
+          o = --oj;
+
+          if (o > 0) {
+            break;
+          }
+          ++numRemoved;
+          j = as(j);
+        }
       }
     }
   }
@@ -87,22 +117,65 @@ int bi::AncestryCacheHost::insert(M1& X, V1& as, V1& os, V1& ls, const int start
   typedef typename temp_host_vector<int>::type host_int_vector_type;
 
   const int N = X1.size1();
-  host_int_vector_type bs(N);
-  int i, q = start;
+  const int S = X.size1();
+  host_int_vector_type bs(N), Zs(bi_omp_max_threads + 1);
+  int q = start, len, numDone = 0;
 
   bi::gather(as1, ls, bs);
   ls.resize(N, false);
 
-  for (i = 0; i < N; ++i) {
-    while (os(q) > 0) {
-      ++q;
-      if (q == X.size1()) {
-        q = 0;
+  /* next fit, a subrange of storage at a time */
+  while (numDone < N) {
+    len = bi::min(S - q, bi::max(2*(N - numDone), 1024));
+    Zs.clear();
+
+    #pragma omp parallel
+    {
+      const int T = bi_omp_team_size(), tid = bi_omp_team_tid();
+      int Q = len/T;
+      int first = q + tid*Q + bi::min(tid, len % T);
+      if (tid < len % T) {
+        ++Q;
+      }
+      int i, k, z = 0;
+
+      /* count free slots in block */
+      for (i = first; i < first + Q; ++i) {
+        if (os(i) == 0) {
+          ++z;
+        }
+      }
+      Zs(tid + 1) = z;
+
+      #pragma omp barrier
+      #pragma omp single
+      {
+        Zs(0) = 0;
+        for (i = 1; i < Zs.size(); ++i) {
+          Zs(i) += Zs(i - 1);
+        }
+      }
+
+      /* allocate free slots in block */
+      k = numDone + Zs(tid);
+      for (i = first; i < first + Q && k < N; ++i) {
+        if (os(i) == 0) {
+          ls(k++) = i;
+        }
       }
     }
-    ls(i) = q;
-    ++q;
-    if (q == X.size1()) {
+
+    numDone = bi::min(N, numDone + *(Zs.end() - 1));
+    q += len;
+    if (q == S) {
+      q = 0;
+    }
+  }
+
+  /* resume from slot after last allocated */
+  if (N > 0) {
+    q = *(ls.end() - 1) + 1;
+    if (q == S) {
       q = 0;
     }
   }
@@ -27,14 +27,17 @@ public:
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
+   * @param k Index of ode block, for its step size controller state.
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
 };
 }
 
 #include "DOPRI5VisitorHost.hpp"
 #include "IntegratorConstants.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
@@ -43,7 +46,7 @@ public:
 
 template<class B, class S, class T1>
 void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+    State<B,ON_HOST>& s, const int k) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -58,16 +61,23 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
   {
     vector_type x0(N), x1(N), x2(N), x3(N), x4(N), x5(N), x6(N), err(N), k1(
         N), k7(N);
-    real t, h, e, e2, logfacold, logfac11, fac;
+    real t, h, h1, e, e2, logfacold, logfac11, fac;
     int n, id, p;
     bool k1in;
     PX pax;
 
-#pragma omp for
+#pragma omp for schedule(runtime) nowait
     for (p = 0; p < P; ++p) {
       t = t1;
-      h = h_h0;
-      logfacold = bi::log(BI_REAL(1.0e-4));
+      if (s.getStepSize(p, k) > BI_REAL(0.0)) {
+        /* resume from last integration */
+        h = s.getStepSize(p, k);
+        logfacold = s.getStepFactor(p, k);
+      } else {
+        h = h_h0;
+        logfacold = bi::log(BI_REAL(1.0e-4));
+      }
+      h1 = h;
       k1in = false;
       n = 0;
       host_load<B,S>(s, p, x0);
@@ -77,6 +87,7 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
           // step size too small
         }
+        h1 = h;  // step size before any truncation at end of interval
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
           h = t2 - t;
           if (h <= BI_REAL(0.0)) {
@@ -139,7 +150,11 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
 
         ++n;
       }
+      s.getStepSize(p, k) = (t < t2) ? h : h1;
+      s.getStepFactor(p, k) = logfacold;
     }
+
+    bi_omp_barrier();
   }
 }
 
@@ -31,14 +31,17 @@ public:
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
+   * @param k Index of ode block, for its step size controller state.
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
 };
 }
 
 #include "RK43VisitorHost.hpp"
 #include "IntegratorConstants.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
@@ -48,7 +51,7 @@ public:
 
 template<class B, class S, class T1>
 void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+    State<B,ON_HOST>& s, const int k) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
@@ -62,15 +65,22 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
   #pragma omp parallel
   {
     vector_type r1(N), r2(N), err(N), old(N);
-    real t, h, e, e2, logfacold, logfac11, fac;
+    real t, h, h1, e, e2, logfacold, logfac11, fac;
     int n, id, p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(runtime) nowait
     for (p = 0; p < P; ++p) {
       t = t1;
-      h = h_h0;
-      logfacold = bi::log(BI_REAL(1.0e-4));
+      if (s.getStepSize(p, k) > BI_REAL(0.0)) {
+        /* resume from last integration */
+        h = s.getStepSize(p, k);
+        logfacold = s.getStepFactor(p, k);
+      } else {
+        h = h_h0;
+        logfacold = bi::log(BI_REAL(1.0e-4));
+      }
+      h1 = h;
       n = 0;
       host_load<B,S>(s, p, old);
       r1 = old;
@@ -80,6 +90,7 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
           // step size too small
         }
+        h1 = h;  // step size before any truncation at end of interval
         if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
           h = t2 - t;
           if (h <= BI_REAL(0.0)) {
@@ -141,7 +152,11 @@ void bi::RK43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
 
         ++n;
       }
+      s.getStepSize(p, k) = (t < t2) ? h : h1;
+      s.getStepFactor(p, k) = logfacold;
     }
+
+    bi_omp_barrier();
   }
 }
 
@@ -35,6 +35,7 @@ public:
 #include "RK4VisitorHost.hpp"
 #include "IntegratorConstants.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
@@ -61,7 +62,7 @@ void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
     int p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(runtime) nowait
     for (p = 0; p < P; ++p) {
       t = t1;
       h = h_h0;
@@ -98,6 +99,8 @@ void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
         t += h;
       }
     }
+
+    bi_omp_barrier();
   }
 }
 
@@ -0,0 +1,285 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROS43INTEGRATORHOST_HPP
+#define BI_HOST_ODE_ROS43INTEGRATORHOST_HPP
+
+namespace bi {
+/**
+ * Rosenbrock 4(3) linearly implicit integrator for stiff systems.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam T1 Scalar type.
+ *
+ * Each step evaluates the Jacobian of the system once, takes the LU
+ * decomposition of @f$I/(\gamma h) - J@f$, then solves four linear systems
+ * with it, for three evaluations of the time derivative. See ROS43Step for
+ * the coefficients.
+ */
+template<class B, class S, class T1>
+class ROS43IntegratorHost {
+public:
+  /**
+   * Integrate.
+   *
+   * @param t1 Start of time interval.
+   * @param t2 End of time interval.
+   * @param[in,out] s State.
+   * @param k Index of ode block, for its step size controller state.
+   */
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
+
+  /**
+   * LU decomposition with partial pivoting of small dense matrix, in place.
+   *
+   * @param N Size of matrix.
+   * @param[in,out] A Column-major matrix.
+   * @param ld Leading dimension of @p A.
+   * @param[out] piv Row interchanges, of length @p N.
+   *
+   * @return False if the matrix is singular, true otherwise.
+   */
+  static bool factor(const int N, real* A, const int ld, int* piv);
+
+  /**
+   * Solve linear system, given LU decomposition from #factor.
+   *
+   * @param N Size of matrix.
+   * @param A LU decomposition.
+   * @param ld Leading dimension of @p A.
+   * @param piv Row interchanges.
+   * @param[in,out] b On input, right-hand side, on output, solution.
+   */
+  static void solve(const int N, const real* A, const int ld,
+      const int* piv, real* b);
+};
+}
+
+#include "ROS43VisitorHost.hpp"
+#include "IntegratorConstants.hpp"
+#include "../host.hpp"
+#include "../../ode/ROS43Step.hpp"
+#include "../../misc/omp.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+#include "../../traits/block_traits.hpp"
+#include "../../math/constant.hpp"
+#include "../../math/misc.hpp"
+#include "../../math/temp_vector.hpp"
+#include "../../math/temp_matrix.hpp"
+
+#include <algorithm>
+
+template<class B, class S, class T1>
+void bi::ROS43IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s, const int k) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef typename temp_host_vector<real>::type vector_type;
+  typedef typename temp_host_matrix<real>::type matrix_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef ROS43VisitorHost<B,S,S,real,PX,real> Visitor;
+  typedef ROS43Step<real,real> step;
+
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+
+  #pragma omp parallel
+  {
+    vector_type y0(N), y(N), f(N), g1(N), g2(N), g3(N), g4(N), err(N);
+    matrix_type A(N, N);
+    int_vector_type piv(N);
+    real t, h, h1, e, e2, fac;
+    int n, id, j, p;
+    PX pax;
+
+    #pragma omp for schedule(runtime) nowait
+    for (p = 0; p < P; ++p) {
+      t = t1;
+      h = (s.getStepSize(p, k) > BI_REAL(0.0)) ? s.getStepSize(p, k) : h_h0;
+      h1 = h;
+      n = 0;
+      host_load<B,S>(s, p, y0);
+
+      /* integrate */
+      while (t < t2 && n < h_nsteps) {
+        h1 = h;  // step size before any truncation at end of interval
+        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+          h = t2 - t;
+          if (h <= BI_REAL(0.0)) {
+            t = t2;
+            break;
+          }
+        }
+        host_store<B,S>(s, p, y0);
+
+        /* Jacobian and time derivative at start of step */
+        A.clear();
+        Visitor::jacobian(t, s, p, pax, A.buf(), A.lead());
+        Visitor::dfdt(t, s, p, pax, g1.buf());
+        for (j = 0; j < N; ++j) {
+          for (id = 0; id < N; ++id) {
+            A(id, j) = -A(id, j);
+          }
+          A(j, j) += step::shift(h);
+        }
+
+        if (factor(N, A.buf(), A.lead(), piv.buf())) {
+          /* stages */
+          solve(N, A.buf(), A.lead(), piv.buf(), g1.buf());
+          for (id = 0; id < N; ++id) {
+            step::state2(y0(id), g1(id), y(id));
+          }
+          host_store<B,S>(s, p, y);
+          Visitor::dfdt(step::time2(t, h), s, p, pax, f.buf());
+          for (id = 0; id < N; ++id) {
+            step::rhs2(h, f(id), g1(id), g2(id));
+          }
+
+          solve(N, A.buf(), A.lead(), piv.buf(), g2.buf());
+          for (id = 0; id < N; ++id) {
+            step::state3(y0(id), g1(id), g2(id), y(id));
+          }
+          host_store<B,S>(s, p, y);
+          Visitor::dfdt(step::time3(t, h), s, p, pax, f.buf());
+          for (id = 0; id < N; ++id) {
+            step::rhs3(h, f(id), g1(id), g2(id), g3(id));
+          }
+
+          solve(N, A.buf(), A.lead(), piv.buf(), g3.buf());
+          for (id = 0; id < N; ++id) {
+            step::rhs4(h, f(id), g1(id), g2(id), g3(id), g4(id));
+          }
+
+          solve(N, A.buf(), A.lead(), piv.buf(), g4.buf());
+          for (id = 0; id < N; ++id) {
+            step::finish(y0(id), g1(id), g2(id), g3(id), g4(id), y(id),
+                err(id));
+          }
+
+          /* compute error */
+          e2 = BI_REAL(0.0);
+          for (id = 0; id < N; ++id) {
+            e = err(id)/(h_atoler + h_rtoler*bi::max(bi::abs(y0(id)), bi::abs(y(id))));
+            e2 += e*e;
+          }
+          e2 /= N;
+        } else {
+          /* singular, treat as rejected */
+          e2 = BI_INF;
+        }
+
+        if (e2 <= BI_REAL(1.0)) {
+          /* accept */
+          t += h;
+          y0.swap(y);
+        }
+
+        /* compute next step size, error estimate is third order */
+        if (t < t2) {
+          fac = bi::exp(h_logsafe - BI_REAL(0.125)*bi::log(e2));
+          if (!(fac >= h_facl)) {
+            fac = h_facl; // also catches NaN
+          } else if (fac > h_facr) {
+            fac = h_facr;
+          }
+          h *= fac;
+        }
+
+        ++n;
+      }
+      host_store<B,S>(s, p, y0);
+      s.getStepSize(p, k) = (t < t2) ? h : h1;
+    }
+
+    bi_omp_barrier();
+  }
+}
+
+template<class B, class S, class T1>
+bool bi::ROS43IntegratorHost<B,S,T1>::factor(const int N, real* A,
+    const int ld, int* piv) {
+  int i, j, k, m;
+  real a, amax;
+
+  for (k = 0; k < N; ++k) {
+    /* pivot */
+    m = k;
+    amax = bi::abs(A[k + k*ld]);
+    for (i = k + 1; i < N; ++i) {
+      a = bi::abs(A[i + k*ld]);
+      if (a > amax) {
+        m = i;
+        amax = a;
+      }
+    }
+    piv[k] = m;
+    if (!(amax > BI_REAL(0.0)) || !bi::is_finite(amax)) {
+      return false;
+    }
+    if (m != k) {
+      for (j = 0; j < N; ++j) {
+        std::swap(A[k + j*ld], A[m + j*ld]);
+      }
+    }
+
+    /* eliminate */
+    a = BI_REAL(1.0)/A[k + k*ld];
+    for (i = k + 1; i < N; ++i) {
+      A[i + k*ld] *= a;
+    }
+    for (j = k + 1; j < N; ++j) {
+      a = A[k + j*ld];
+      if (a != BI_REAL(0.0)) {
+        for (i = k + 1; i < N; ++i) {
+          A[i + j*ld] -= A[i + k*ld]*a;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template<class B, class S, class T1>
+void bi::ROS43IntegratorHost<B,S,T1>::solve(const int N, const real* A,
+    const int ld, const int* piv, real* b) {
+  int i, j;
+  real a;
+
+  /* row interchanges */
+  for (j = 0; j < N; ++j) {
+    if (piv[j] != j) {
+      std::swap(b[j], b[piv[j]]);
+    }
+  }
+
+  /* forward substitution with unit lower triangle */
+  for (j = 0; j < N; ++j) {
+    a = b[j];
+    for (i = j + 1; i < N; ++i) {
+      b[i] -= A[i + j*ld]*a;
+    }
+  }
+
+  /* back substitution with upper triangle */
+  for (j = N - 1; j >= 0; --j) {
+    b[j] /= A[j + j*ld];
+    a = b[j];
+    for (i = 0; i < j; ++i) {
+      b[i] -= A[i + j*ld]*a;
+    }
+  }
+}
+
+#endif
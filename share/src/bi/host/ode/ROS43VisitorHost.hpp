@@ -0,0 +1,86 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROS43VISITORHOST_HPP
+#define BI_HOST_ODE_ROS43VISITORHOST_HPP
+
+#include "../../ode/ROS43Stage.hpp"
+
+namespace bi {
+/**
+ * Visitor for ROS43Integrator.
+ *
+ * @tparam B Model type.
+ * @tparam S1 Action type list.
+ * @tparam S2 Action type list.
+ * @tparam T1 Scalar type.
+ * @tparam PX Parents type.
+ * @tparam T2 Scalar type.
+ */
+template<class B, class S1, class S2, class T1, class PX, class T2>
+class ROS43VisitorHost {
+public:
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      stage::dfdt(t, s, p, cox, pax, f[id]);
+      ++cox;
+      ++id;
+    }
+    visitor::dfdt(t, s, p, pax, f);
+  }
+
+  static void jacobian(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* J, const int ld) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      stage::jacobian(t, s, p, cox, pax, J + id, ld);
+      ++cox;
+      ++id;
+    }
+    visitor::jacobian(t, s, p, pax, J, ld);
+  }
+
+private:
+  typedef typename front<S2>::type front;
+  typedef typename pop_front<S2>::type pop_front;
+  typedef typename front::coord_type coord_type;
+
+  typedef ROS43Stage<front,S1,T1,B,ON_HOST,coord_type,PX,T2> stage;
+  typedef ROS43VisitorHost<B,S1,pop_front,T1,PX,T2> visitor;
+
+  static const int start = action_start<S1,front>::value;
+  static const int end = action_end<S1,front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of ROS43Visitor.
+ */
+template<class B, class S1, class T1, class PX, class T2>
+class ROS43VisitorHost<B,S1,empty_typelist,T1,PX,T2> {
+public:
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    //
+  }
+
+  static void jacobian(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* J, const int ld) {
+    //
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_PRIMITIVE_VECTORPRIMITIVE_HPP
+#define BI_HOST_PRIMITIVE_VECTORPRIMITIVE_HPP
+
+namespace bi {
+/**
+ * @internal
+ *
+ * Each thread reduces a contiguous block of the vector, in turn dividing
+ * this into short chunks. For each chunk, the maximum is computed first,
+ * then the sums relative to the running maximum, so that the inner loops
+ * contain no branches and may be vectorised by the compiler. Partial
+ * results of threads are combined in order afterward, so that the result
+ * does not depend on the order in which threads finish.
+ */
+template<>
+struct logweight_reduce_impl<ON_HOST> {
+  template<class V1>
+  static void func(const V1 lws, typename V1::value_type& mx,
+      typename V1::value_type& W, typename V1::value_type& W2);
+};
+}
+
+#include "../math/temp_vector.hpp"
+#include "../../misc/omp.hpp"
+#include "../../math/function.hpp"
+#include "../../math/constant.hpp"
+
+template<class V1>
+void bi::logweight_reduce_impl<bi::ON_HOST>::func(const V1 lws,
+    typename V1::value_type& mx, typename V1::value_type& W,
+    typename V1::value_type& W2) {
+  typedef typename V1::value_type T1;
+
+  static const int CHUNK = 64;
+  const int P = lws.size();
+  const T1 inf = BI_INF;
+
+  typename temp_host_vector<T1>::type mxs(bi_omp_max_threads),
+      Ws(bi_omp_max_threads), W2s(bi_omp_max_threads);
+  Ws.clear();
+
+  #pragma omp parallel
+  {
+    const int tid = bi_omp_team_tid();
+    T1 mx1 = -inf, W1 = 0.0, W21 = 0.0, mx2, x, y, z;
+    int start, end, i;
+
+    #pragma omp for schedule(static)
+    for (start = 0; start < P; start += CHUNK) {
+      end = bi::min(start + CHUNK, P);
+
+      /* maximum of chunk, NaN fail comparison so are ignored */
+      mx2 = mx1;
+      for (i = start; i < end; ++i) {
+        x = lws(i);
+        mx2 = (x > mx2) ? x : mx2;
+      }
+
+      /* rescale running sums to new maximum */
+      if (mx2 > mx1) {
+        if (W1 > 0.0) {
+          z = bi::exp(mx1 - mx2);
+          W1 *= z;
+          W21 *= z*z;
+        }
+        mx1 = mx2;
+      }
+
+      /* sums relative to maximum */
+      if (mx1 > -inf) {
+        for (i = start; i < end; ++i) {
+          y = bi::nanexp(lws(i) - mx1);
+          W1 += y;
+          W21 += y*y;
+        }
+      }
+    }
+
+    mxs(tid) = mx1;
+    Ws(tid) = W1;
+    W2s(tid) = W21;
+  }
+
+  /* combine threads, in order */
+  T1 z;
+  mx = -inf;
+  W = 0.0;
+  W2 = 0.0;
+  for (int i = 0; i < bi_omp_max_threads; ++i) {
+    if (Ws(i) > 0.0) {
+      if (W == 0.0) {
+        mx = mxs(i);
+        W = Ws(i);
+        W2 = W2s(i);
+      } else if (mxs(i) > mx) {
+        z = bi::exp(mx - mxs(i));
+        mx = mxs(i);
+        W = z*W + Ws(i);
+        W2 = z*z*W2 + W2s(i);
+      } else {
+        z = bi::exp(mxs(i) - mx);
+        W += z*Ws(i);
+        W2 += z*z*W2s(i);
+      }
+    }
+  }
+}
+
+#endif
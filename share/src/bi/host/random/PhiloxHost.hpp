@@ -0,0 +1,251 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_RANDOM_PHILOXHOST_HPP
+#define BI_HOST_RANDOM_PHILOXHOST_HPP
+
+#include "../../misc/compile.hpp"
+
+#include "boost/cstdint.hpp"
+
+namespace bi {
+/**
+ * Counter-based pseudorandom number generator, on host.
+ *
+ * @ingroup math_rng
+ *
+ * Uses the Philox4x32-10 bijection of @ref Salmon2011 "Salmon et al. (2011)".
+ * Each variate is a pure function of a key and a counter, with no state
+ * carried between variates. This permits the plural methods of Random to
+ * fill vectors in parallel and with SIMD, with output that does not depend
+ * on the number of threads.
+ *
+ * The key is formed from the seed and process rank. The counter is formed
+ * from the index of the element (usually the particle), the stream number
+ * (incremented on each plural call, so usually the time step), a draw index
+ * for samplers that require several bijections, and the id of the calling
+ * host thread.
+ */
+class PhiloxHost {
+public:
+  /**
+   * Word type.
+   */
+  typedef boost::uint32_t word_type;
+
+  /**
+   * Constructor.
+   *
+   * @param key0 First word of key.
+   * @param key1 Second word of key.
+   * @param stream Stream number.
+   * @param tid Thread id.
+   */
+  PhiloxHost(const word_type key0, const word_type key1,
+      const word_type stream, const word_type tid);
+
+  /**
+   * Apply bijection.
+   *
+   * @param p Element index.
+   * @param draw Draw index.
+   * @param[out] out Four pseudorandom words.
+   */
+  void bijection(const word_type p, const word_type draw, word_type out[4]) const;
+
+  /**
+   * Generate a random number from a uniform distribution over
+   * \f$[0,1)\f$.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param p Element index.
+   * @param draw Draw index.
+   */
+  template<class T1>
+  T1 uniform(const int p, const word_type draw = 0) const;
+
+  /**
+   * Generate a random number from a standard Gaussian distribution.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param p Element index.
+   * @param draw Draw index.
+   */
+  template<class T1>
+  T1 gaussian(const int p, const word_type draw = 0) const;
+
+  /**
+   * Generate a random number from a gamma distribution with given shape and
+   * unit scale.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param p Element index.
+   * @param alpha Shape.
+   * @param draw Draw index of first bijection.
+   *
+   * Uses the squeeze and rejection sampling method of
+   * @ref Marsaglia2000 "Marsaglia & Tsang (2000)", as in RngGPU::gamma. Each
+   * attempt uses two bijections, with draw indices counting up from
+   * @p draw.
+   */
+  template<class T1>
+  T1 gamma(const int p, const T1 alpha, const word_type draw = 0) const;
+
+  /**
+   * Convert two words to a uniform variate on \f$[0,1)\f$ with 53 bits of
+   * precision.
+   */
+  static double u01(const word_type hi, const word_type lo);
+
+  /**
+   * Convert words of a bijection to a uniform variate on \f$[0,1)\f$ with
+   * the full precision of @p T1.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param w Words, of which the first two are used for double precision
+   * and the first alone for single precision.
+   *
+   * Single precision variates are built from the top 24 bits of the first
+   * word, rather than rounded from a double precision variate, which can
+   * round up to one.
+   */
+  template<class T1>
+  static T1 u01(const word_type* w);
+
+private:
+  /**
+   * Key.
+   */
+  word_type key0, key1;
+
+  /**
+   * Stream number.
+   */
+  word_type stream;
+
+  /**
+   * Thread id.
+   */
+  word_type tid;
+};
+}
+
+#include "../../math/function.hpp"
+#include "../../math/constant.hpp"
+
+inline bi::PhiloxHost::PhiloxHost(const word_type key0,
+    const word_type key1, const word_type stream, const word_type tid) :
+    key0(key0), key1(key1), stream(stream), tid(tid) {
+  //
+}
+
+inline void bi::PhiloxHost::bijection(const word_type p,
+    const word_type draw, word_type out[4]) const {
+  static const boost::uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  static const word_type W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  word_type c0 = p, c1 = stream, c2 = draw, c3 = tid;
+  word_type k0 = key0, k1 = key1;
+  boost::uint64_t prod0, prod1;
+  int round;
+
+  for (round = 0; round < 10; ++round) {
+    prod0 = M0*c0;
+    prod1 = M1*c2;
+    c0 = static_cast<word_type>(prod1 >> 32) ^ c1 ^ k0;
+    c2 = static_cast<word_type>(prod0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<word_type>(prod1);
+    c3 = static_cast<word_type>(prod0);
+    k0 += W0;
+    k1 += W1;
+  }
+
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+template<class T1>
+inline T1 bi::PhiloxHost::uniform(const int p, const word_type draw) const {
+  word_type w[4];
+  bijection(p, draw, w);
+
+  return u01<T1>(w);
+}
+
+template<class T1>
+inline T1 bi::PhiloxHost::gaussian(const int p, const word_type draw) const {
+  word_type w[4];
+  bijection(p, draw, w);
+
+  /* Box-Muller, first variate only, 1 - u so that log argument in (0,1] */
+  double u1 = 1.0 - u01(w[0], w[1]);
+  double u2 = u01(w[2], w[3]);
+
+  return static_cast<T1>(bi::sqrt(-2.0*bi::log(u1))*bi::cos(BI_TWO_PI*u2));
+}
+
+template<class T1>
+inline T1 bi::PhiloxHost::gamma(const int p, const T1 alpha,
+    const word_type draw) const {
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  word_type w[4];
+  word_type k = draw;
+  T1 d = alpha - static_cast<T1>(1.0/3.0);
+  T1 scale;
+  if (alpha < one) {
+    /* boost to alpha > 1 case */
+    bijection(p, k++, w);
+    scale = bi::pow(u01<T1>(w), one/alpha);
+    d += one;
+  } else {
+    scale = one;
+  }
+  T1 c = bi::rsqrt(static_cast<T1>(9.0)*d);
+  T1 x, x2, v, dv, u;
+
+  while (true) {
+    x = gaussian<T1>(p, k++);
+    v = one + c*x;
+    bijection(p, k++, w);
+    if (v > zero) {
+      x2 = x*x;
+      v = v*v*v;
+      dv = d*v;
+      u = u01<T1>(w);
+      if (u < one - static_cast<T1>(0.0331)*x2*x2 ||
+          bi::log(u) < static_cast<T1>(0.5)*x2 + d - dv + d*bi::log(v)) {
+        return scale*dv;
+      }
+    }
+  }
+}
+
+inline double bi::PhiloxHost::u01(const word_type hi, const word_type lo) {
+  return ((hi >> 5)*67108864.0 + (lo >> 6))*(1.0/9007199254740992.0);
+}
+
+template<class T1>
+inline T1 bi::PhiloxHost::u01(const word_type* w) {
+  return static_cast<T1>(u01(w[0], w[1]));
+}
+
+namespace bi {
+template<>
+inline float PhiloxHost::u01<float>(const word_type* w) {
+  return (w[0] >> 8)*(1.0f/16777216.0f);
+}
+}
+
+#endif
@@ -21,9 +21,11 @@ void bi::RandomHost::seeds(Random& rng, const unsigned seed) {
 
     int s = seed*size*bi_omp_max_threads + rank*bi_omp_max_threads + bi_omp_tid;
     #else
+    const int rank = 0;
     int s = seed*bi_omp_max_threads + bi_omp_tid;
     #endif
 
     rng.getHostRng().seed(s);
+    rng.getHostRng().seedStreams(seed, rank);
   }
 }
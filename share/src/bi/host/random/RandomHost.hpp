@@ -78,21 +78,15 @@ void bi::RandomHost::uniforms(Random& rng, V1 x,
   BI_ASSERT(upper >= lower);
 
   typedef typename V1::value_type T1;
-  typedef boost::uniform_real<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+  const T1 range = upper - lower;
+  int j;
 
-    dist_type dist(lower, upper);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
-
-    //#pragma omp for
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = gen();
-    }
-    //}
+  #pragma omp parallel for schedule(static)
+  for (j = 0; j < x.size(); ++j) {
+    x(j) = lower + range*gen.template uniform<T1>(j);
+  }
 }
 
 template<class V1>
@@ -102,21 +96,14 @@ void bi::RandomHost::gaussians(Random& rng, V1 x,
   BI_ASSERT(sigma >= 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::normal_distribution<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+  int j;
 
-    dist_type dist(mu, sigma);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
-
-    //#pragma omp for schedule(static)
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = gen();
-    }
-  //}
+  #pragma omp parallel for schedule(static)
+  for (j = 0; j < x.size(); ++j) {
+    x(j) = mu + sigma*gen.template gaussian<T1>(j);
+  }
 }
 
 template<class V1>
@@ -126,21 +113,14 @@ void bi::RandomHost::gammas(Random& rng, V1 x,
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::gamma_distribution<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+  int j;
 
-    dist_type dist(alpha);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
-
-    //#pragma omp for schedule(static)
-    for (j = 0; j < x.size(); ++j) {
-      x(j) = beta*gen();
-    }
-    //}
+  #pragma omp parallel for schedule(static)
+  for (j = 0; j < x.size(); ++j) {
+    x(j) = beta*gen.gamma(j, alpha);
+  }
 }
 
 template<class V1>
@@ -150,25 +130,22 @@ void bi::RandomHost::betas(Random& rng, V1 x,
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::gamma_distribution<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  /* second gamma variate uses draw indices from the top half of the range,
+   * so as not to overlap with the first */
+  static const PhiloxHost::word_type draw2 = 0x80000000u;
 
-    dist_type dist1(alpha), dist2(beta);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen1(rng1.rng, dist1), gen2(rng1.rng, dist2);
-    T1 y1, y2;
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+  T1 y1, y2;
+  int j;
 
-    //#pragma omp for schedule(static)
-    for (j = 0; j < x.size(); ++j) {
-      y1 = gen1();
-      y2 = gen2();
+  #pragma omp parallel for schedule(static) private(y1, y2)
+  for (j = 0; j < x.size(); ++j) {
+    y1 = gen.gamma(j, alpha);
+    y2 = gen.gamma(j, beta, draw2);
 
-      x(j) = y1/(y1 + y2);
-    }
-    //}
+    x(j) = y1/(y1 + y2);
+  }
 }
 
 template<class V1, class V2>
@@ -178,21 +155,18 @@ void bi::RandomHost::multinomials(Random& rng, const V1 lps, V2 xs) {
 
   typedef typename V1::value_type T1;
 
-  RngHost& rng1 = rng.getHostRng();
   typename sim_temp_vector<V1>::type Ps(lps.size());
   sumexpu_inclusive_scan(lps, Ps);
 
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+  const T1 W = *(Ps.end() - 1);
   T1 u;
-  T1 lower = 0.0;
-  T1 upper = *(Ps.end() - 1);
+  int i;
 
-  int i, p;
+  #pragma omp parallel for schedule(static) private(u)
   for (i = 0; i < xs.size(); ++i) {
-    ///@todo Review implementation, in particular the next two repeated calls
-    u = rng1.uniform(lower, upper);
-    p = thrust::lower_bound(Ps.begin(), Ps.end(), u) - Ps.begin();
-
-    xs(i) = p;
+    u = W*gen.template uniform<T1>(i);
+    xs(i) = thrust::lower_bound(Ps.begin(), Ps.end(), u) - Ps.begin();
   }
 }
 
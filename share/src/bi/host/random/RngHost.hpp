@@ -8,6 +8,8 @@
 #ifndef BI_HOST_RANDOM_RNG_HPP
 #define BI_HOST_RANDOM_RNG_HPP
 
+#include "PhiloxHost.hpp"
+
 #include "boost/random/mersenne_twister.hpp"
 
 namespace bi {
@@ -17,7 +19,9 @@ namespace bi {
  * @ingroup math_rng
  *
  * Uses the Mersenne Twister algorithm for generating pseudorandom variates,
- * as implemented in Boost.Random.
+ * as implemented in Boost.Random. Also holds the key and stream counter of
+ * the counter-based generator PhiloxHost, used by the plural methods of
+ * Random.
  *
  * @section RngHost_references References
  *
@@ -28,6 +32,11 @@ namespace bi {
  */
 class RngHost {
 public:
+  /**
+   * Constructor.
+   */
+  RngHost();
+
   /**
    * Seed random number generator.
    *
@@ -35,6 +44,23 @@ public:
    */
   void seed(const unsigned seed);
 
+  /**
+   * Seed counter-based generator.
+   *
+   * @param seed Seed value.
+   * @param rank Process rank.
+   *
+   * Unlike #seed, which is given a different value for each thread, this is
+   * given the same value for all threads, so that plural methods produce
+   * the same output regardless of the number of threads.
+   */
+  void seedStreams(const unsigned seed, const unsigned rank = 0);
+
+  /**
+   * Get counter-based generator for the next stream.
+   */
+  PhiloxHost nextStream();
+
   /**
    * @copydoc Random::uniformInt
    */
@@ -80,6 +106,16 @@ public:
    * Random number generator.
    */
   rng_type rng;
+
+  /**
+   * Key of counter-based generator.
+   */
+  PhiloxHost::word_type key[2];
+
+  /**
+   * Number of streams of counter-based generator used so far.
+   */
+  PhiloxHost::word_type nstreams;
 };
 }
 
@@ -95,8 +131,25 @@ public:
 
 #include "thrust/binary_search.h"
 
+inline bi::RngHost::RngHost() : nstreams(0) {
+  key[0] = 0;
+  key[1] = 0;
+}
+
 inline void bi::RngHost::seed(const unsigned seed) {
   rng.seed(seed);
+  seedStreams(seed);
+}
+
+inline void bi::RngHost::seedStreams(const unsigned seed,
+    const unsigned rank) {
+  key[0] = seed;
+  key[1] = rank;
+  nstreams = 0;
+}
+
+inline bi::PhiloxHost bi::RngHost::nextStream() {
+  return PhiloxHost(key[0], key[1], nstreams++, bi_omp_tid);
 }
 
 template<class T1>
@@ -42,9 +42,10 @@ void bi::MultinomialResamplerHost::ancestors(Random& rng, const V1 lws, V2 as,
 
     #pragma omp parallel
     {
-      int Q = P/bi_omp_max_threads;
-      int start = bi_omp_tid*Q + bi::min(bi_omp_tid, P % bi_omp_max_threads); // min() handles leftovers
-      if (bi_omp_tid < P % bi_omp_max_threads) {
+      const int T = bi_omp_team_size(), tid = bi_omp_team_tid();
+      int Q = P/T;
+      int start = tid*Q + bi::min(tid, P % T); // min() handles leftovers
+      if (tid < P % T) {
         ++Q; // pick up a leftover
       }
 
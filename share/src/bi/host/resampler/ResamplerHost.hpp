@@ -49,10 +49,67 @@ public:
    */
   template<class V1>
   static void permute(V1 as);
+
+  /**
+   * Compute inclusive prefix sum of weights from log-weights.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param[out] Ws Cumulative weights, unnormalised and scaled by the
+   * exponential of the maximum log-weight.
+   *
+   * @return Maximum log-weight.
+   *
+   * Equivalent to sumexpu_inclusive_scan(), but with the scan blocked over
+   * host threads.
+   */
+  template<class V1, class V2>
+  static typename V1::value_type sumexpuInclusiveScan(const V1 lws, V2 Ws);
+
+private:
+  /**
+   * Get number of offspring of particle.
+   *
+   * @tparam cumulative Is @p xs cumulative offspring, rather than offspring?
+   * @tparam V1 Integral vector type.
+   *
+   * @param xs Offspring or cumulative offspring.
+   * @param i Index of particle.
+   */
+  template<bool cumulative, class V1>
+  static int offspring(const V1 xs, const int i);
+
+  /**
+   * Common implementation of offspringToAncestorsPermute() and
+   * cumulativeOffspringToAncestorsPermute().
+   *
+   * @tparam cumulative Is @p xs cumulative offspring, rather than offspring?
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   *
+   * @param xs Offspring or cumulative offspring.
+   * @param[out] as Ancestors.
+   *
+   * Particles are partitioned into contiguous blocks, one per thread. Each
+   * thread places the first offspring of each particle in its block in the
+   * same position as its parent, counting the remaining offspring and the
+   * free positions (those of particles with no offspring) in its block. An
+   * exclusive scan of these counts across threads then gives, for each
+   * thread, the rank of the free position into which its first remaining
+   * offspring is to be written, from which it proceeds as in the serial
+   * algorithm. The result is identical to that of the serial algorithm.
+   */
+  template<bool cumulative, class V1, class V2>
+  static void toAncestorsPermute(const V1 xs, V2 as);
 };
 }
 
+#include "../math/temp_vector.hpp"
 #include "../../primitive/vector_primitive.hpp"
+#include "../../math/function.hpp"
+#include "../../misc/omp.hpp"
 
 template<class V1, class V2>
 void bi::ResamplerHost::ancestorsToOffspring(const V1 as, V2 os) {
@@ -61,7 +118,10 @@ void bi::ResamplerHost::ancestorsToOffspring(const V1 as, V2 os) {
   BI_ASSERT(!V2::on_device);
 
   os.clear();
+
+  #pragma omp parallel for
   for (int p = 0; p < as.size(); ++p) {
+    #pragma omp atomic
     ++os(as(p));
   }
 
@@ -89,23 +149,11 @@ template<class V1, class V2>
 void bi::ResamplerHost::offspringToAncestorsPermute(const V1 os, V2 as) {
   /* pre-conditions */
   BI_ASSERT(sum_reduce(os) == as.size());
+  BI_ASSERT(os.size() == as.size());
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o;
-  for (i = 0; i < os.size(); ++i) {
-    o = os(i);
-    if (o > 0) {
-      as(i) = i;
-      --o;
-    }
-    for (j = 0; j < o; ++j) {
-      while (os(k) > 0) {
-        ++k;
-      }
-      as(k++) = i;
-    }
-  }
+  toAncestorsPermute<false>(os, as);
 }
 
 template<class V1, class V2>
@@ -137,56 +185,180 @@ void bi::ResamplerHost::cumulativeOffspringToAncestorsPermute(const V1 Os,
     V2 as) {
   /* pre-conditions */
   BI_ASSERT(*(Os.end() - 1) == as.size());
+  BI_ASSERT(Os.size() == as.size());
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o, O1, O2;
-  for (i = 0; i < Os.size(); ++i) {
-    O1 = (i > 0) ? Os(i - 1) : 0;
-    O2 = Os(i);
-    o = O2 - O1;
+  toAncestorsPermute<true>(Os, as);
+}
+
+template<class V1>
+void bi::ResamplerHost::permute(V1 as) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+
+  const int P = as.size();
 
-    if (o > 0) {
-      as(i) = i;
-      --o;
+  if (max_reduce(as) < P) {
+    /* the in-place swaps of the serial algorithm do not parallelise well;
+     * instead count offspring and regenerate the ancestors from these, which
+     * gives the same ancestors in permuted order */
+    typename temp_host_vector<typename V1::value_type>::type os(P);
+    ancestorsToOffspring(as, os);
+    offspringToAncestorsPermute(os, as);
+  } else {
+    /* ancestors drawn from a larger population than the number of
+     * offspring, so those beyond the end cannot be placed at their own
+     * index; fall back to serial swaps, which leave them where they are */
+    typename V1::size_type i;
+    typename V1::value_type j, k;
+
+    for (i = 0; i < as.size(); ++i) {
+      k = as(i);
+      if (k < P && k != i && as(k) != k) {
+        /* swap */
+        j = as(k);
+        as(k) = k;
+        as(i) = j;
+        --i; // repeat for new value
+      }
     }
+  }
+}
 
-    if (k == 0 && o > 0) { // deal with special case here rather than in loop
-      if (Os(k) > 0) {
-        ++k;
-      } else {
-        as(k++) = i;
-        --o;
+template<class V1, class V2>
+typename V1::value_type bi::ResamplerHost::sumexpuInclusiveScan(
+    const V1 lws, V2 Ws) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == Ws.size());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!V2::on_device);
+
+  typedef typename V1::value_type T1;
+
+  const int P = lws.size();
+  const T1 mx = max_reduce(lws);
+  typename temp_host_vector<T1>::type sums(bi_omp_max_threads + 1);
+  sums.clear();
+
+  #pragma omp parallel
+  {
+    const int T = bi_omp_team_size(), tid = bi_omp_team_tid();
+    int Q = P/T;
+    int start = tid*Q + bi::min(tid, P % T);
+    if (tid < P % T) {
+      ++Q;
+    }
+    int i;
+    T1 W = 0.0;
+
+    /* scan within block */
+    for (i = start; i < start + Q; ++i) {
+      W += bi::nanexp(lws(i) - mx);
+      Ws(i) = W;
+    }
+    sums(tid + 1) = W;
+
+    #pragma omp barrier
+    #pragma omp single
+    {
+      sums(0) = 0.0;
+      for (i = 1; i < sums.size(); ++i) {
+        sums(i) += sums(i - 1);
       }
     }
 
-    for (j = 0; j < o; ++j) {
-      while (Os(k) - Os(k - 1) > 0) {
-        ++k;
+    /* add offset of block */
+    W = sums(tid);
+    if (W > 0.0) {
+      for (i = start; i < start + Q; ++i) {
+        Ws(i) += W;
       }
-      as(k++) = i;
     }
   }
+
+  return mx;
 }
 
-template<class V1>
-void bi::ResamplerHost::permute(V1 as) {
-  /* pre-condition */
-  BI_ASSERT(!V1::on_device);
+template<bool cumulative, class V1>
+inline int bi::ResamplerHost::offspring(const V1 xs, const int i) {
+  if (cumulative) {
+    return (i > 0) ? xs(i) - xs(i - 1) : xs(i);
+  } else {
+    return xs(i);
+  }
+}
 
+template<bool cumulative, class V1, class V2>
+void bi::ResamplerHost::toAncestorsPermute(const V1 xs, V2 as) {
   const int P = as.size();
+  typename temp_host_vector<int>::type holes(bi_omp_max_threads + 1),
+      extras(bi_omp_max_threads + 1);
+  holes.clear();
+  extras.clear();
+
+  #pragma omp parallel
+  {
+    const int T = bi_omp_team_size(), tid = bi_omp_team_tid();
+    int Q = P/T;
+    int start = tid*Q + bi::min(tid, P % T);
+    if (tid < P % T) {
+      ++Q;
+    }
+    int i, j, k, b, o, nholes = 0, nextras = 0;
+
+    /* first offspring of each particle stays in place */
+    for (i = start; i < start + Q; ++i) {
+      o = offspring<cumulative>(xs, i);
+      if (o > 0) {
+        as(i) = i;
+        nextras += o - 1;
+      } else {
+        ++nholes;
+      }
+    }
+    holes(tid + 1) = nholes;
+    extras(tid + 1) = nextras;
 
-  typename V1::size_type i;
-  typename V1::value_type j, k;
-
-  for (i = 0; i < as.size(); ++i) {
-    k = as(i);
-    if (k < P && k != i && as(k) != k) {
-      /* swap */
-      j = as(k);
-      as(k) = k;
-      as(i) = j;
-      --i; // repeat for new value
+    #pragma omp barrier
+    #pragma omp single
+    {
+      holes(0) = 0;
+      extras(0) = 0;
+      for (i = 1; i < holes.size(); ++i) {
+        holes(i) += holes(i - 1);
+        extras(i) += extras(i - 1);
+      }
+    }
+
+    if (nextras > 0) {
+      /* find block containing the first free position for this thread */
+      j = extras(tid);
+      b = 0;
+      while (holes(b + 1) <= j) {
+        ++b;
+      }
+      j -= holes(b);
+
+      /* ...then that position within the block */
+      k = b*(P/T) + bi::min(b, P % T);
+      while (offspring<cumulative>(xs, k) > 0 || j > 0) {
+        if (offspring<cumulative>(xs, k) == 0) {
+          --j;
+        }
+        ++k;
+      }
+
+      /* remaining offspring go into free positions, in order */
+      for (i = start; i < start + Q; ++i) {
+        o = offspring<cumulative>(xs, i);
+        for (j = 1; j < o; ++j) {
+          as(k++) = i;
+          while (k < P && offspring<cumulative>(xs, k) > 0) {
+            ++k;
+          }
+        }
+      }
     }
   }
 }
@@ -0,0 +1,62 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_UPDATER_DYNAMICUPDATERBATCHHOST_HPP
+#define BI_HOST_UPDATER_DYNAMICUPDATERBATCHHOST_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Dynamic updater for blocks of batch matrix actions, each evaluated for
+ * all trajectories at once.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class DynamicUpdaterBatchHost {
+public:
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+};
+
+/**
+ * @internal
+ *
+ * Base case of DynamicUpdaterBatchHost.
+ */
+template<class B>
+class DynamicUpdaterBatchHost<B,empty_typelist> {
+public:
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s) {
+    //
+  }
+};
+}
+
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+
+template<class B, class S>
+template<class T1>
+inline void bi::DynamicUpdaterBatchHost<B,S>::update(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 <= t2);
+
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  front::simulates(t1, t2, s);
+  DynamicUpdaterBatchHost<B,pop_front>::update(t1, t2, s);
+}
+
+#endif
@@ -34,6 +34,7 @@ public:
 #include "DynamicUpdaterVisitorHost.hpp"
 #include "DynamicUpdaterMatrixVisitorHost.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../state/Ou.hpp"
 #include "../../traits/block_traits.hpp"
@@ -60,10 +61,12 @@ void bi::DynamicUpdaterHost<B,S>::update(const T1 t1, const T1 t2,
     OX x;
     int p;
 
-    #pragma omp for
+    #pragma omp for schedule(runtime) nowait
     for (p = 0; p < s.size(); ++p) {
       Visitor::accept(t1, t2, s, p, pax, x);
     }
+
+    bi_omp_barrier();
   }
 }
 
@@ -50,8 +50,8 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
   typedef RngHost R1;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
-  typedef SparseStaticSamplerMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
-  typedef SparseStaticSamplerVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef SparseStaticSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef SparseStaticSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
@@ -64,7 +64,7 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
 
 #pragma omp for
     for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(rng, s, mask, p, pax, x);
+      Visitor::accept(rng1, s, mask, p, pax, x);
     }
   }
 }
@@ -72,10 +72,11 @@ void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
 template<class B, class S>
 void bi::SparseStaticSamplerHost<B,S>::samples(Random& rng,
     State<B,ON_HOST>& s, const int p, const Mask<ON_HOST>& mask) {
+  typedef RngHost R1;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
-  typedef SparseStaticSamplerMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
-  typedef SparseStaticSamplerVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef SparseStaticSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef SparseStaticSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
@@ -12,10 +12,10 @@ namespace bi {
 /**
  * Visitor for SparseStaticSamplerHost.
  */
-template<class B, class S, class PX, class OX>
+template<class B, class S, class R1, class PX, class OX>
 class SparseStaticSamplerVisitorHost {
 public:
-  static void accept(Random& rng, State<B,ON_HOST>& s,
+  static void accept(R1& rng, State<B,ON_HOST>& s,
       const Mask<ON_HOST>& mask, const int p, const PX& pax, OX& x);
 };
 
@@ -24,10 +24,10 @@ public:
  *
  * Base case of SparseStaticSamplerVisitorHost.
  */
-template<class B, class PX, class OX>
-class SparseStaticSamplerVisitorHost<B,empty_typelist,PX,OX> {
+template<class B, class R1, class PX, class OX>
+class SparseStaticSamplerVisitorHost<B,empty_typelist,R1,PX,OX> {
 public:
-  static void accept(Random& rng, State<B,ON_HOST>& s,
+  static void accept(R1& rng, State<B,ON_HOST>& s,
       const Mask<ON_HOST>& mask, const int p, const PX& pax, OX& x) {
     //
   }
@@ -38,8 +38,8 @@ public:
 #include "../../typelist/pop_front.hpp"
 #include "../../traits/action_traits.hpp"
 
-template<class B, class S, class PX, class OX>
-void bi::SparseStaticSamplerVisitorHost<B,S,PX,OX>::accept(Random& rng,
+template<class B, class S, class R1, class PX, class OX>
+void bi::SparseStaticSamplerVisitorHost<B,S,R1,PX,OX>::accept(R1& rng,
     State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, const int p,
     const PX& pax, OX& x) {
   typedef typename front<S>::type front;
@@ -63,7 +63,7 @@ void bi::SparseStaticSamplerVisitorHost<B,S,PX,OX>::accept(Random& rng,
       ++ix;
     }
   }
-  SparseStaticSamplerVisitorHost<B,pop_front,PX,OX>::accept(rng, s, mask, p,
+  SparseStaticSamplerVisitorHost<B,pop_front,R1,PX,OX>::accept(rng, s, mask, p,
       pax, x);
 }
 
@@ -0,0 +1,55 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_UPDATER_STATICUPDATERBATCHHOST_HPP
+#define BI_HOST_UPDATER_STATICUPDATERBATCHHOST_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Static updater for blocks of batch matrix actions, each evaluated for
+ * all trajectories at once.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class StaticUpdaterBatchHost {
+public:
+  static void update(State<B,ON_HOST>& s);
+};
+
+/**
+ * @internal
+ *
+ * Base case of StaticUpdaterBatchHost.
+ */
+template<class B>
+class StaticUpdaterBatchHost<B,empty_typelist> {
+public:
+  static void update(State<B,ON_HOST>& s) {
+    //
+  }
+};
+}
+
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+
+template<class B, class S>
+inline void bi::StaticUpdaterBatchHost<B,S>::update(State<B,ON_HOST>& s) {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  front::simulates(s);
+  StaticUpdaterBatchHost<B,pop_front>::update(s);
+}
+
+#endif
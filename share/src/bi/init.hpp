@@ -10,13 +10,25 @@
 #ifndef BI_INIT_HPP
 #define BI_INIT_HPP
 
+#include <string>
+
 namespace bi {
 /**
  * Initialise LibBi.
  *
  * @param threads Number of threads.
+ * @param schedule Schedule for particle loops of variable cost.
+ * @param chunk Chunk size for @p schedule.
+ *
+ * @see bi_omp_init()
  */
-void bi_init(const int threads = 0);
+void bi_init(const int threads = 0, const std::string& schedule = "static",
+    const int chunk = 0);
+
+/**
+ * Terminate LibBi.
+ */
+void bi_term();
 }
 
 #include "misc/omp.hpp"
@@ -32,8 +44,9 @@ void bi_init(const int threads = 0);
 #endif
 
 // need to keep in same compilation unit as caller for bi_ode_init()
-inline void bi::bi_init(const int threads) {
-  bi_omp_init(threads);
+inline void bi::bi_init(const int threads, const std::string& schedule,
+    const int chunk) {
+  bi_omp_init(threads, schedule, chunk);
 
   #ifdef ENABLE_CUDA
   #ifdef ENABLE_MPI
@@ -50,4 +63,8 @@ inline void bi::bi_init(const int threads) {
   bi_ode_init();
 }
 
+inline void bi::bi_term() {
+  bi_omp_term();
+}
+
 #endif
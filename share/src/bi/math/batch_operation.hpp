@@ -0,0 +1,365 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MATH_BATCHOPERATION_HPP
+#define BI_MATH_BATCHOPERATION_HPP
+
+#include "operation.hpp"
+
+/**
+ * Number of trajectories processed together by batch operations, chosen so
+ * that one column of each operand stays in L1 cache across a whole small
+ * matrix operation.
+ */
+#define BI_BATCH_SIZE 256
+
+namespace bi {
+/**
+ * @name Batch operations
+ *
+ * These operate on one small matrix per trajectory, stored as in State:
+ * each row of a batch matrix holds the elements of one trajectory's matrix
+ * in column-major order, so that element \f$(i,j)\f$ of every trajectory's
+ * matrix, with leading dimension @c ld, is found in column
+ * \f$i + j\cdot\mathrm{ld}\f$. The trajectories for the same element are
+ * then contiguous, and the operations are vectorised across trajectories.
+ *
+ * An input batch matrix with a single row is shared by all trajectories, as
+ * for a common variable. Outputs determine the number of trajectories.
+ */
+//@{
+/**
+ * Batch matrix-matrix multiply, \f$Y_p = A_pX_p\f$ for each trajectory
+ * \f$p\f$.
+ *
+ * @ingroup math_multi_op
+ *
+ * @tparam M1 Matrix type.
+ * @tparam M2 Matrix type.
+ * @tparam M3 Matrix type.
+ *
+ * @param M Number of rows of @p A and @p Y.
+ * @param N Number of columns of @p X and @p Y.
+ * @param K Number of columns of @p A and rows of @p X.
+ * @param A Batch matrix.
+ * @param ldA Leading dimension of @p A.
+ * @param X Batch matrix.
+ * @param ldX Leading dimension of @p X.
+ * @param[out] Y Batch matrix.
+ * @param ldY Leading dimension of @p Y.
+ */
+template<class M1, class M2, class M3>
+void batch_gemm(const int M, const int N, const int K, const M1 A,
+    const int ldA, const M2 X, const int ldX, M3 Y, const int ldY);
+
+/**
+ * Batch matrix-vector multiply, \f$\mathbf{y}_p = A_p\mathbf{x}_p\f$ for each
+ * trajectory \f$p\f$.
+ *
+ * @ingroup math_multi_op
+ *
+ * @tparam M1 Matrix type.
+ * @tparam M2 Matrix type.
+ * @tparam M3 Matrix type.
+ *
+ * @param M Number of rows of @p A and size of @p y.
+ * @param K Number of columns of @p A and size of @p x.
+ * @param A Batch matrix.
+ * @param ldA Leading dimension of @p A.
+ * @param x Batch vector.
+ * @param[out] y Batch vector.
+ */
+template<class M1, class M2, class M3>
+void batch_gemv(const int M, const int K, const M1 A, const int ldA,
+    const M2 x, M3 y);
+
+/**
+ * Batch transpose, \f$B_p = A_p^T\f$ for each trajectory \f$p\f$.
+ *
+ * @ingroup math_multi_op
+ *
+ * @tparam M1 Matrix type.
+ * @tparam M2 Matrix type.
+ *
+ * @param M Number of rows of @p A.
+ * @param N Number of columns of @p A.
+ * @param A Batch matrix.
+ * @param ldA Leading dimension of @p A.
+ * @param[out] B Batch matrix.
+ * @param ldB Leading dimension of @p B.
+ */
+template<class M1, class M2>
+void batch_transpose(const int M, const int N, const M1 A, const int ldA,
+    M2 B, const int ldB);
+
+/**
+ * Batch Cholesky factorisation of symmetric positive definite matrices.
+ *
+ * @ingroup math_multi_op
+ *
+ * @tparam M1 Matrix type.
+ * @tparam M2 Matrix type.
+ *
+ * @param N Number of rows and columns of @p A.
+ * @param A Batch matrix.
+ * @param ldA Leading dimension of @p A.
+ * @param[out] U Batch matrix, upper- or lower-triangular factor, with the
+ * remainder set to zero.
+ * @param ldU Leading dimension of @p U.
+ * @param uplo 'U' for the upper-triangular factor, 'L' for the
+ * lower-triangular factor.
+ * @param strat Strategy for matrices that are not positive definite.
+ *
+ * The triangle of @p A given by @p uplo is read. Matrices for which the
+ * factorisation breaks down are factorised again individually with #chol,
+ * using @p strat.
+ */
+template<class M1, class M2>
+void batch_chol(const int N, const M1 A, const int ldA, M2 U, const int ldU,
+    const char uplo = 'U', const CholeskyStrategy strat = ADJUST_DIAGONAL)
+    throw (CholeskyException);
+//@}
+}
+
+#include "temp_matrix.hpp"
+#include "function.hpp"
+#include "../misc/assert.hpp"
+
+#include <algorithm>
+
+namespace bi {
+/**
+ * @internal
+ *
+ * Batch multiply-add of two operands into @p c, each operand either one
+ * value per trajectory (increment one) or shared (increment zero).
+ */
+template<class T1>
+inline void batch_fma(const int n, const T1* a, const int inca, const T1* b,
+    const int incb, T1* c) {
+  int p;
+  if (inca && incb) {
+    for (p = 0; p < n; ++p) {
+      c[p] += a[p]*b[p];
+    }
+  } else if (inca) {
+    const T1 b0 = *b;
+    for (p = 0; p < n; ++p) {
+      c[p] += a[p]*b0;
+    }
+  } else if (incb) {
+    const T1 a0 = *a;
+    for (p = 0; p < n; ++p) {
+      c[p] += a0*b[p];
+    }
+  } else {
+    const T1 ab = (*a)*(*b);
+    for (p = 0; p < n; ++p) {
+      c[p] += ab;
+    }
+  }
+}
+
+/**
+ * @internal
+ *
+ * Column of element \f$(i,j)\f$ of an upper-triangular batch matrix, or of
+ * element \f$(j,i)\f$ of a lower-triangular one.
+ */
+inline int batch_tri(const char uplo, const int i, const int j,
+    const int ld) {
+  return (uplo == 'U') ? i + j*ld : j + i*ld;
+}
+
+/**
+ * @internal
+ *
+ * Batch copy of @p a into @p c, @p a either one value per trajectory
+ * (increment one) or shared (increment zero).
+ */
+template<class T1>
+inline void batch_copy(const int n, const T1* a, const int inca, T1* c) {
+  int p;
+  if (inca) {
+    for (p = 0; p < n; ++p) {
+      c[p] = a[p];
+    }
+  } else {
+    const T1 a0 = *a;
+    for (p = 0; p < n; ++p) {
+      c[p] = a0;
+    }
+  }
+}
+}
+
+template<class M1, class M2, class M3>
+void bi::batch_gemm(const int M, const int N, const int K, const M1 A,
+    const int ldA, const M2 X, const int ldX, M3 Y, const int ldY) {
+  typedef typename M3::value_type T3;
+
+  const int P = Y.size1();
+  const int incA = (A.size1() == 1) ? 0 : 1;
+  const int incX = (X.size1() == 1) ? 0 : 1;
+
+  /* pre-conditions */
+  BI_ASSERT(!M1::on_device && !M2::on_device && !M3::on_device);
+  BI_ASSERT(A.size1() == 1 || A.size1() == P);
+  BI_ASSERT(X.size1() == 1 || X.size1() == P);
+  BI_ASSERT(A.size2() >= (K - 1)*ldA + M);
+  BI_ASSERT(X.size2() >= (N - 1)*ldX + K);
+  BI_ASSERT(Y.size2() >= (N - 1)*ldY + M);
+
+  #pragma omp parallel
+  {
+    int q, n, i, j, k;
+    T3* y;
+
+    #pragma omp for schedule(static)
+    for (q = 0; q < P; q += BI_BATCH_SIZE) {
+      n = bi::min(BI_BATCH_SIZE, P - q);
+      for (j = 0; j < N; ++j) {
+        for (i = 0; i < M; ++i) {
+          y = Y.buf() + q + (i + j*ldY)*Y.lead();
+          std::fill(y, y + n, static_cast<T3>(0.0));
+          for (k = 0; k < K; ++k) {
+            batch_fma(n, A.buf() + incA*q + (i + k*ldA)*A.lead(), incA,
+                X.buf() + incX*q + (k + j*ldX)*X.lead(), incX, y);
+          }
+        }
+      }
+    }
+  }
+}
+
+template<class M1, class M2, class M3>
+inline void bi::batch_gemv(const int M, const int K, const M1 A,
+    const int ldA, const M2 x, M3 y) {
+  batch_gemm(M, 1, K, A, ldA, x, K, y, M);
+}
+
+template<class M1, class M2>
+void bi::batch_transpose(const int M, const int N, const M1 A,
+    const int ldA, M2 B, const int ldB) {
+  const int P = B.size1();
+  const int incA = (A.size1() == 1) ? 0 : 1;
+
+  /* pre-conditions */
+  BI_ASSERT(!M1::on_device && !M2::on_device);
+  BI_ASSERT(A.size1() == 1 || A.size1() == P);
+  BI_ASSERT(A.size2() >= (N - 1)*ldA + M);
+  BI_ASSERT(B.size2() >= (M - 1)*ldB + N);
+
+  #pragma omp parallel
+  {
+    int q, n, i, j;
+
+    #pragma omp for schedule(static)
+    for (q = 0; q < P; q += BI_BATCH_SIZE) {
+      n = bi::min(BI_BATCH_SIZE, P - q);
+      for (j = 0; j < N; ++j) {
+        for (i = 0; i < M; ++i) {
+          batch_copy(n, A.buf() + incA*q + (i + j*ldA)*A.lead(), incA,
+              B.buf() + q + (j + i*ldB)*B.lead());
+        }
+      }
+    }
+  }
+}
+
+template<class M1, class M2>
+void bi::batch_chol(const int N, const M1 A, const int ldA, M2 U,
+    const int ldU, const char uplo, const CholeskyStrategy strat)
+    throw (CholeskyException) {
+  typedef typename M2::value_type T2;
+  typedef typename temp_host_matrix<T2>::type temp_matrix_type;
+
+  const int P = U.size1();
+
+  /* pre-conditions */
+  BI_ASSERT(!M1::on_device && !M2::on_device);
+  BI_ASSERT(uplo == 'U' || uplo == 'L');
+  BI_ASSERT(A.size1() == P);
+  BI_ASSERT(A.size2() >= (N - 1)*ldA + N);
+  BI_ASSERT(U.size2() >= (N - 1)*ldU + N);
+
+  #pragma omp parallel
+  {
+    temp_matrix_type A1(N, N), U1(N, N);
+    bool ok[BI_BATCH_SIZE];
+    T2 *a, *b, *u, *d;
+    int q, n, i, j, k, p;
+
+    #pragma omp for schedule(static)
+    for (q = 0; q < P; q += BI_BATCH_SIZE) {
+      n = bi::min(BI_BATCH_SIZE, P - q);
+      std::fill(ok, ok + n, true);
+
+      /* column by column of the upper-triangular factor, the
+       * lower-triangular factor being its transpose */
+      for (j = 0; j < N; ++j) {
+        /* off-diagonal elements */
+        for (i = 0; i < j; ++i) {
+          u = U.buf() + q + batch_tri(uplo, i, j, ldU)*U.lead();
+          batch_copy(n, A.buf() + q + batch_tri(uplo, i, j, ldA)*A.lead(), 1,
+              u);
+          for (k = 0; k < i; ++k) {
+            a = U.buf() + q + batch_tri(uplo, k, i, ldU)*U.lead();
+            b = U.buf() + q + batch_tri(uplo, k, j, ldU)*U.lead();
+            for (p = 0; p < n; ++p) {
+              u[p] -= a[p]*b[p];
+            }
+          }
+          d = U.buf() + q + batch_tri(uplo, i, i, ldU)*U.lead();
+          for (p = 0; p < n; ++p) {
+            u[p] /= d[p];
+          }
+        }
+
+        /* diagonal element */
+        d = U.buf() + q + batch_tri(uplo, j, j, ldU)*U.lead();
+        batch_copy(n, A.buf() + q + batch_tri(uplo, j, j, ldA)*A.lead(), 1,
+            d);
+        for (k = 0; k < j; ++k) {
+          u = U.buf() + q + batch_tri(uplo, k, j, ldU)*U.lead();
+          for (p = 0; p < n; ++p) {
+            d[p] -= u[p]*u[p];
+          }
+        }
+        for (p = 0; p < n; ++p) {
+          ok[p] = ok[p] && d[p] > static_cast<T2>(0.0);
+          d[p] = bi::sqrt(bi::max(d[p], static_cast<T2>(0.0)));
+        }
+
+        /* remainder of column */
+        for (i = j + 1; i < N; ++i) {
+          u = U.buf() + q + batch_tri(uplo, i, j, ldU)*U.lead();
+          std::fill(u, u + n, static_cast<T2>(0.0));
+        }
+      }
+
+      /* factorise again individually where the factorisation broke down */
+      for (p = 0; p < n; ++p) {
+        if (!ok[p]) {
+          for (j = 0; j < N; ++j) {
+            for (i = 0; i < N; ++i) {
+              A1(i, j) = *(A.buf() + q + p + (i + j*ldA)*A.lead());
+            }
+          }
+          chol(A1, U1, uplo, strat);
+          for (j = 0; j < N; ++j) {
+            for (i = 0; i < N; ++i) {
+              *(U.buf() + q + p + (i + j*ldU)*U.lead()) = U1(i, j);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif
@@ -28,10 +28,14 @@ CUDA_FUNC_BOTH double log(const double x);
 CUDA_FUNC_BOTH float log(const float x);
 CUDA_FUNC_BOTH double nanlog(const double x);
 CUDA_FUNC_BOTH float nanlog(const float x);
+CUDA_FUNC_BOTH double log1p(const double x);
+CUDA_FUNC_BOTH float log1p(const float x);
 CUDA_FUNC_BOTH double exp(const double x);
 CUDA_FUNC_BOTH float exp(const float x);
 CUDA_FUNC_BOTH double nanexp(const double x);
 CUDA_FUNC_BOTH float nanexp(const float x);
+CUDA_FUNC_BOTH double expm1(const double x);
+CUDA_FUNC_BOTH float expm1(const float x);
 CUDA_FUNC_BOTH double max(const double x, const double y);
 CUDA_FUNC_BOTH float max(const float x, const float y);
 CUDA_FUNC_BOTH double min(const double x, const double y);
@@ -84,6 +88,9 @@ CUDA_FUNC_BOTH double erf(const double x);
 CUDA_FUNC_BOTH float erf(const float x);
 CUDA_FUNC_BOTH double erfc(const double x);
 CUDA_FUNC_BOTH float erfc(const float x);
+CUDA_FUNC_BOTH double select(const bool mask, const double x,
+    const double y);
+CUDA_FUNC_BOTH float select(const bool mask, const float x, const float y);
 
 template<class T>
 CUDA_FUNC_BOTH bool isnan(const T x);
@@ -139,6 +146,14 @@ inline float bi::nanlog(const float x) {
   return bi::isnan(x) ? bi::log(0.0f) : bi::log(x);
 }
 
+inline double bi::log1p(const double x) {
+  return ::log1p(x);
+}
+
+inline float bi::log1p(const float x) {
+  return ::log1pf(x);
+}
+
 inline double bi::exp(const double x) {
   return ::exp(x);
 }
@@ -155,6 +170,14 @@ inline float bi::nanexp(const float x) {
   return bi::isnan(x) ? 0.0f : bi::exp(x);
 }
 
+inline double bi::expm1(const double x) {
+  return ::expm1(x);
+}
+
+inline float bi::expm1(const float x) {
+  return ::expm1f(x);
+}
+
 inline double bi::max(const double x, const double y) {
   return ::fmax(x, y);
 }
@@ -371,6 +394,14 @@ inline float bi::erfc(const float x) {
   return ::erfcf(x);
 }
 
+inline double bi::select(const bool mask, const double x, const double y) {
+  return mask ? x : y;
+}
+
+inline float bi::select(const bool mask, const float x, const float y) {
+  return mask ? x : y;
+}
+
 template<class T>
 inline bool bi::isnan(const T x) {
   // there is no ::isnan(), isnan() is a macro, and std::isnan() is host only
@@ -0,0 +1,610 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MATH_WIRE_HPP
+#define BI_MATH_WIRE_HPP
+
+#include "scalar.hpp"
+#include "sim_temp_vector.hpp"
+#include "sim_temp_matrix.hpp"
+#include "../misc/assert.hpp"
+#include "../cuda/cuda.hpp"
+
+#include "boost/mpl/bool.hpp"
+#include "boost/mpl/has_xxx.hpp"
+#include "boost/cstdint.hpp"
+
+#include <vector>
+#include <limits>
+#include <cstring>
+
+/**
+ * @def BI_WIRE_MAGIC
+ *
+ * First four bytes of any object in wire format, the characters "LBiW" when
+ * read in the byte order of the writer.
+ */
+#define BI_WIRE_MAGIC 0x5769424c
+
+/**
+ * @def BI_WIRE_VERSION
+ *
+ * Version of the wire format. Increment whenever the fields listed by any
+ * <tt>wire()</tt> member function change.
+ */
+#define BI_WIRE_VERSION 1
+
+namespace bi {
+/**
+ * Header of an object in wire format.
+ *
+ * @ingroup math_matvec
+ *
+ * @section wire_format Wire format
+ *
+ * The wire format is a flat, contiguous binary layout of states and caches,
+ * intended for transfers between processes and for checkpoint files. An
+ * object is written as a WireHeader followed by its fields, in the order
+ * listed by its <tt>wire()</tt> member function, with no padding:
+ *
+ * @li scalars in their native representation,
+ * @li vectors as an @c int length followed by the elements, and
+ * @li matrices as @c int rows and columns followed by the elements in
+ * column-major order, without any lead.
+ *
+ * Contiguous vectors and matrices are written or read with a single copy,
+ * rather than element by element as with Boost.Serialization archives.
+ * Byte order is that of the writer; a reader with a different byte order,
+ * a different format version or a different precision for @c real rejects
+ * the object.
+ */
+struct WireHeader {
+  /**
+   * Magic number, #BI_WIRE_MAGIC.
+   */
+  boost::int32_t magic;
+
+  /**
+   * Format version, #BI_WIRE_VERSION.
+   */
+  boost::int32_t version;
+
+  /**
+   * Size of @c real, in bytes.
+   */
+  boost::int32_t realSize;
+
+  /**
+   * Reserved, zero.
+   */
+  boost::int32_t reserved;
+
+  /**
+   * Size of the object, in bytes, including this header.
+   */
+  boost::int64_t bytes;
+};
+
+/**
+ * @internal
+ *
+ * Does type have a nested matrix_reference_type? True for matrices, false
+ * for vectors.
+ */
+BOOST_MPL_HAS_XXX_TRAIT_DEF(matrix_reference_type)
+
+/**
+ * Base of wire archives, listing fields as blocks of bytes.
+ *
+ * @ingroup math_matvec
+ *
+ * @tparam A Derived type, which provides <tt>block(void*, size_t)</tt> to
+ * visit each block of bytes, and may hide #dim and #expect.
+ * @tparam loading Does the archive read into the objects that it visits?
+ */
+template<class A, bool loading>
+class WireArchive {
+public:
+  /**
+   * Does the archive read into the objects that it visits?
+   */
+  static const bool is_loading = loading;
+
+  /**
+   * May vectors and matrices on device be staged through temporaries on
+   * host? False for archives that retain the addresses of blocks.
+   */
+  static const bool staging = true;
+
+  /**
+   * Scalar field.
+   */
+  template<class T1>
+  void scalar(T1& x);
+
+  /**
+   * Array field of fixed length.
+   */
+  template<class T1>
+  void array(T1* x, const int n);
+
+  /**
+   * Vector field, resized on loading.
+   */
+  template<class V1>
+  void vector(V1& x);
+
+  /**
+   * Matrix field, resized on loading.
+   */
+  template<class M1>
+  void matrix(M1& X);
+
+  /**
+   * Vector or matrix field.
+   */
+  template<class X1>
+  void value(X1& x);
+
+  /**
+   * Dimension of a vector or matrix field, or other count held in a local
+   * variable. Use this rather than #scalar for locals, as archives that
+   * retain the addresses of blocks copy it.
+   */
+  void dim(int& n);
+
+  /**
+   * Announce the number of bytes of the next vector or matrix field, before
+   * it is resized on loading. Archives reading from a span hide this to
+   * check that enough bytes remain.
+   */
+  void expect(const size_t n);
+
+private:
+  /**
+   * Derived object.
+   */
+  A& derived();
+
+  /**
+   * Number of bytes of a vector or matrix field, failing if this overflows
+   * @c size_t.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param size Size of each element, in bytes.
+   */
+  static size_t extent(const int rows, const int cols, const size_t size);
+
+  /**
+   * Dispatch for vector.
+   */
+  template<class X1>
+  void value(X1& x, const boost::mpl::false_);
+
+  /**
+   * Dispatch for matrix.
+   */
+  template<class X1>
+  void value(X1& x, const boost::mpl::true_);
+};
+
+/**
+ * Archive computing the size of objects in wire format.
+ *
+ * @ingroup math_matvec
+ */
+class WireSizer: public WireArchive<WireSizer,false> {
+public:
+  /**
+   * Constructor.
+   */
+  WireSizer();
+
+  /**
+   * Visit block.
+   */
+  void block(const void* x, const size_t n);
+
+  /**
+   * Number of bytes visited.
+   */
+  size_t size() const;
+
+private:
+  /**
+   * Number of bytes visited.
+   */
+  size_t bytes;
+};
+
+/**
+ * Archive writing objects in wire format to a byte span.
+ *
+ * @ingroup math_matvec
+ */
+class WireWriter: public WireArchive<WireWriter,false> {
+public:
+  /**
+   * Constructor.
+   *
+   * @param buf Start of span, which must be large enough for the objects
+   * to be written (see WireSizer).
+   */
+  WireWriter(char* buf);
+
+  /**
+   * Visit block.
+   */
+  void block(const void* x, const size_t n);
+
+  /**
+   * Number of bytes written.
+   */
+  size_t size() const;
+
+private:
+  /**
+   * Start of span.
+   */
+  char* buf;
+
+  /**
+   * Current position in span.
+   */
+  char* ptr;
+};
+
+/**
+ * Archive reading objects in wire format from a byte span.
+ *
+ * @ingroup math_matvec
+ */
+class WireReader: public WireArchive<WireReader,true> {
+public:
+  /**
+   * Constructor.
+   *
+   * @param buf Start of span.
+   * @param len Length of span, in bytes.
+   */
+  WireReader(const char* buf, const size_t len);
+
+  /**
+   * Visit block.
+   */
+  void block(void* x, const size_t n);
+
+  /**
+   * Visit dimension, checking that it is non-negative before it is used to
+   * resize a vector or matrix.
+   */
+  void dim(int& n);
+
+  /**
+   * Check that at least @p n bytes remain, before a vector or matrix is
+   * resized to hold them.
+   */
+  void expect(const size_t n);
+
+  /**
+   * Number of bytes read.
+   */
+  size_t size() const;
+
+private:
+  /**
+   * Start of span.
+   */
+  const char* buf;
+
+  /**
+   * Current position in span.
+   */
+  const char* ptr;
+
+  /**
+   * End of span.
+   */
+  const char* end;
+};
+
+/**
+ * Size of object in wire format.
+ *
+ * @tparam X Type with <tt>wire()</tt> member function template.
+ *
+ * @param x Object.
+ *
+ * @return Size of @p x in wire format, in bytes, including its header.
+ */
+template<class X>
+size_t wire_size(const X& x);
+
+/**
+ * Write object in wire format.
+ *
+ * @tparam X Type with <tt>wire()</tt> member function template.
+ *
+ * @param x Object.
+ * @param[out] buf Byte span, of at least <tt>wire_size(x)</tt> bytes.
+ *
+ * @return Number of bytes written.
+ */
+template<class X>
+size_t wire_pack(const X& x, char* buf);
+
+/**
+ * Read object in wire format.
+ *
+ * @tparam X Type with <tt>wire()</tt> member function template.
+ *
+ * @param[out] x Object.
+ * @param buf Byte span.
+ * @param len Length of @p buf, in bytes.
+ *
+ * @return Number of bytes read, so that several objects written one after
+ * the other, as in a checkpoint file, may be read in turn.
+ */
+template<class X>
+size_t wire_unpack(X& x, const char* buf, const size_t len);
+
+/**
+ * Make header for object in wire format.
+ *
+ * @param bytes Size of object, in bytes, excluding the header.
+ */
+WireHeader wire_header(const size_t bytes);
+}
+
+template<class A, bool loading>
+inline A& bi::WireArchive<A,loading>::derived() {
+  return static_cast<A&>(*this);
+}
+
+template<class A, bool loading>
+template<class T1>
+inline void bi::WireArchive<A,loading>::scalar(T1& x) {
+  derived().block(&x, sizeof(T1));
+}
+
+template<class A, bool loading>
+template<class T1>
+inline void bi::WireArchive<A,loading>::array(T1* x, const int n) {
+  derived().block(x, n*sizeof(T1));
+}
+
+template<class A, bool loading>
+inline void bi::WireArchive<A,loading>::dim(int& n) {
+  scalar(n);
+}
+
+template<class A, bool loading>
+inline void bi::WireArchive<A,loading>::expect(const size_t n) {
+  //
+}
+
+template<class A, bool loading>
+inline size_t bi::WireArchive<A,loading>::extent(const int rows,
+    const int cols, const size_t size) {
+  /* pre-condition */
+  BI_ASSERT(rows >= 0 && cols >= 0);
+
+  const size_t max = std::numeric_limits<size_t>::max();
+  BI_ERROR_MSG(cols == 0 || (size_t)rows <= max/cols,
+      "Object in wire format has dimensions " << rows << "x" << cols <<
+      " that are too large");
+  const size_t n = (size_t)rows*cols;
+  BI_ERROR_MSG(n <= max/size, "Object in wire format has dimensions " <<
+      rows << "x" << cols << " that are too large");
+
+  return n*size;
+}
+
+template<class A, bool loading>
+template<class V1>
+void bi::WireArchive<A,loading>::vector(V1& x) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device || A::staging);
+
+  typedef typename V1::value_type T1;
+  typedef typename sim_temp_host_vector<V1>::type temp_vector_type;
+
+  int size = x.size();
+  derived().dim(size);
+  const size_t bytes = extent(size, 1, sizeof(T1));
+  derived().expect(bytes);
+  if (loading) {
+    x.resize(size, false);
+  }
+  if (V1::on_device) {
+    temp_vector_type x1(size);
+    if (!loading) {
+      x1 = x;
+      synchronize();
+    }
+    derived().block(x1.buf(), bytes);
+    if (loading) {
+      x = x1;
+    }
+  } else if (x.contiguous()) {
+    derived().block(x.buf(), bytes);
+  } else {
+    for (int i = 0; i < size; ++i) {
+      derived().block(&x(i), sizeof(T1));
+    }
+  }
+}
+
+template<class A, bool loading>
+template<class M1>
+void bi::WireArchive<A,loading>::matrix(M1& X) {
+  /* pre-condition */
+  BI_ASSERT(!M1::on_device || A::staging);
+
+  typedef typename M1::value_type T1;
+  typedef typename sim_temp_host_matrix<M1>::type temp_matrix_type;
+
+  int rows = X.size1(), cols = X.size2();
+  derived().dim(rows);
+  derived().dim(cols);
+  const size_t bytes = extent(rows, cols, sizeof(T1));
+  derived().expect(bytes);
+  if (loading) {
+    X.resize(rows, cols, false);
+  }
+  if (M1::on_device) {
+    temp_matrix_type X1(rows, cols);
+    if (!loading) {
+      X1 = X;
+      synchronize();
+    }
+    derived().block(X1.buf(), bytes);
+    if (loading) {
+      X = X1;
+    }
+  } else if (X.contiguous()) {
+    derived().block(X.buf(), bytes);
+  } else if (X.inc() == 1) {
+    for (int j = 0; j < cols; ++j) {
+      derived().block(X.buf() + j*X.lead(), rows*sizeof(T1));
+    }
+  } else {
+    for (int j = 0; j < cols; ++j) {
+      for (int i = 0; i < rows; ++i) {
+        derived().block(&X(i, j), sizeof(T1));
+      }
+    }
+  }
+}
+
+template<class A, bool loading>
+template<class X1>
+inline void bi::WireArchive<A,loading>::value(X1& x) {
+  value(x, boost::mpl::bool_<has_matrix_reference_type<X1>::value>());
+}
+
+template<class A, bool loading>
+template<class X1>
+inline void bi::WireArchive<A,loading>::value(X1& x,
+    const boost::mpl::false_) {
+  vector(x);
+}
+
+template<class A, bool loading>
+template<class X1>
+inline void bi::WireArchive<A,loading>::value(X1& x,
+    const boost::mpl::true_) {
+  matrix(x);
+}
+
+inline bi::WireSizer::WireSizer() : bytes(0) {
+  //
+}
+
+inline void bi::WireSizer::block(const void* x, const size_t n) {
+  bytes += n;
+}
+
+inline size_t bi::WireSizer::size() const {
+  return bytes;
+}
+
+inline bi::WireWriter::WireWriter(char* buf) : buf(buf), ptr(buf) {
+  //
+}
+
+inline void bi::WireWriter::block(const void* x, const size_t n) {
+  memcpy(ptr, x, n);
+  ptr += n;
+}
+
+inline size_t bi::WireWriter::size() const {
+  return ptr - buf;
+}
+
+inline bi::WireReader::WireReader(const char* buf, const size_t len) :
+    buf(buf), ptr(buf), end(buf + len) {
+  //
+}
+
+inline void bi::WireReader::block(void* x, const size_t n) {
+  BI_ERROR_MSG(n <= (size_t)(end - ptr), "Object in wire format is truncated");
+  memcpy(x, ptr, n);
+  ptr += n;
+}
+
+inline void bi::WireReader::dim(int& n) {
+  scalar(n);
+  BI_ERROR_MSG(n >= 0, "Object in wire format has negative dimension " << n);
+}
+
+inline void bi::WireReader::expect(const size_t n) {
+  BI_ERROR_MSG(n <= (size_t)(end - ptr), "Object in wire format is truncated");
+}
+
+inline size_t bi::WireReader::size() const {
+  return ptr - buf;
+}
+
+inline bi::WireHeader bi::wire_header(const size_t bytes) {
+  WireHeader header;
+  header.magic = BI_WIRE_MAGIC;
+  header.version = BI_WIRE_VERSION;
+  header.realSize = sizeof(real);
+  header.reserved = 0;
+  header.bytes = sizeof(WireHeader) + bytes;
+
+  return header;
+}
+
+template<class X>
+size_t bi::wire_size(const X& x) {
+  WireSizer sizer;
+  const_cast<X&>(x).wire(sizer);
+
+  return sizeof(WireHeader) + sizer.size();
+}
+
+template<class X>
+size_t bi::wire_pack(const X& x, char* buf) {
+  WireWriter writer(buf + sizeof(WireHeader));
+  const_cast<X&>(x).wire(writer);
+
+  WireHeader header = wire_header(writer.size());
+  memcpy(buf, &header, sizeof(WireHeader));
+
+  return header.bytes;
+}
+
+template<class X>
+size_t bi::wire_unpack(X& x, const char* buf, const size_t len) {
+  WireHeader header;
+  BI_ERROR_MSG(len >= sizeof(WireHeader), "Object in wire format is truncated");
+  memcpy(&header, buf, sizeof(WireHeader));
+  BI_ERROR_MSG(header.magic == BI_WIRE_MAGIC,
+      "Object not in wire format, or of different byte order");
+  BI_ERROR_MSG(header.version == BI_WIRE_VERSION,
+      "Object in wire format version " << header.version << ", expecting " <<
+      BI_WIRE_VERSION);
+  BI_ERROR_MSG(header.realSize == sizeof(real),
+      "Object in wire format of different precision");
+  BI_ERROR_MSG(header.bytes >= (boost::int64_t)sizeof(WireHeader),
+      "Object in wire format has invalid size " << header.bytes);
+  BI_ERROR_MSG(header.bytes <= (boost::int64_t)len,
+      "Object in wire format is truncated");
+
+  WireReader reader(buf + sizeof(WireHeader),
+      header.bytes - sizeof(WireHeader));
+  x.wire(reader);
+  BI_ERROR_MSG(sizeof(WireHeader) + reader.size() == (size_t)header.bytes,
+      "Object in wire format is of unexpected size");
+
+  return header.bytes;
+}
+
+#endif
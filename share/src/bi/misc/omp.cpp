@@ -6,18 +6,34 @@
  * $Date$
  */
 #include "omp.hpp"
+#include "assert.hpp"
 
 #include "../cuda/cuda.hpp"
 
+#if ENABLE_DIAGNOSTICS == 5
+#include "TicToc.hpp"
+#endif
+
 BI_THREAD int bi_omp_tid;
 int bi_omp_max_threads;
 
+#if ENABLE_DIAGNOSTICS == 5
+BI_THREAD long bi_omp_idle_usecs;
+#endif
+
 #ifdef ENABLE_CUDA
 BI_THREAD cublasHandle_t bi_omp_cublas_handle;
 BI_THREAD cudaStream_t bi_omp_cuda_stream;
 #endif
 
-void bi_omp_init(const int threads) {
+void bi_omp_init(const int threads, const std::string& schedule,
+    const int chunk) {
+  /* pre-condition */
+  BI_ERROR_MSG(schedule.compare("static") == 0 ||
+      schedule.compare("dynamic") == 0 || schedule.compare("guided") == 0,
+      "schedule must be one of static, dynamic or guided");
+  BI_ERROR_MSG(chunk >= 0, "schedule chunk size must be non-negative");
+
   #if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
   /* explicitly turn off dynamic threads, required for threadprivate
    * guarantees */
@@ -26,8 +42,15 @@ void bi_omp_init(const int threads) {
   /* allow nested parallelism */
   //omp_set_nested(1);
 
-  /* use static scheduling for pseudorandom sequence reproducibility */
-  omp_set_schedule(omp_sched_static, 0);
+  /* schedule for schedule(runtime) loops, which do not use pseudorandom
+   * numbers, so reproducibility does not depend on it */
+  if (schedule.compare("dynamic") == 0) {
+    omp_set_schedule(omp_sched_dynamic, chunk);
+  } else if (schedule.compare("guided") == 0) {
+    omp_set_schedule(omp_sched_guided, chunk);
+  } else {
+    omp_set_schedule(omp_sched_static, chunk);
+  }
 
   /* set number of threads */
   if (threads > 0) {
@@ -38,6 +61,9 @@ void bi_omp_init(const int threads) {
   #pragma omp parallel
   {
     bi_omp_tid = omp_get_thread_num();
+    #if ENABLE_DIAGNOSTICS == 5
+    bi_omp_idle_usecs = 0;
+    #endif
     #ifdef ENABLE_CUDA
     CUBLAS_CHECKED_CALL(cublasCreate(&bi_omp_cublas_handle));
     CUDA_CHECKED_CALL(cudaStreamCreate(&bi_omp_cuda_stream));
@@ -46,6 +72,9 @@ void bi_omp_init(const int threads) {
 #else
   bi_omp_max_threads = 1;
   bi_omp_tid = 0;
+  #if ENABLE_DIAGNOSTICS == 5
+  bi_omp_idle_usecs = 0;
+  #endif
   #ifdef ENABLE_CUDA
   CUBLAS_CHECKED_CALL(cublasCreate(&bi_omp_cublas_handle));
   CUDA_CHECKED_CALL(cudaStreamCreate(&bi_omp_cuda_stream));
@@ -60,5 +89,22 @@ void bi_omp_term() {
     CUBLAS_CHECKED_CALL(cublasDestroy(bi_omp_cublas_handle));
     CUDA_CHECKED_CALL(cudaStreamDestroy(bi_omp_cuda_stream));
     #endif
+    #if ENABLE_DIAGNOSTICS == 5
+    #pragma omp critical
+    {
+      std::cerr << "Thread " << bi_omp_tid << ": " << bi_omp_idle_usecs;
+      std::cerr << " us idle." << std::endl;
+    }
+    #endif
   }
 }
+
+void bi_omp_barrier() {
+  #if ENABLE_DIAGNOSTICS == 5
+  bi::TicToc clock;
+  #pragma omp barrier
+  bi_omp_idle_usecs += clock.toc();
+  #else
+  #pragma omp barrier
+  #endif
+}
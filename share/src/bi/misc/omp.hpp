@@ -11,6 +11,8 @@
 #define BI_MISC_OMP_HPP
 
 #include "compile.hpp"
+
+#include <string>
 #ifdef ENABLE_CUDA
 #include "../cuda/cuda.hpp"
 #include "../cuda/math/cublas.hpp"
@@ -51,16 +53,82 @@ extern BI_THREAD cudaStream_t bi_omp_cuda_stream;
 #endif
 #endif
 
+#if ENABLE_DIAGNOSTICS == 5
+/**
+ * Time spent by thread waiting in bi_omp_barrier(), in microseconds.
+ */
+extern BI_THREAD long bi_omp_idle_usecs;
+
+#ifdef __ICC
+#pragma omp threadprivate(bi_omp_idle_usecs)
+#endif
+#endif
+
 /**
  * Initialise OpenMP environment.
  *
  * @param threads Number of threads. Zero for the default.
+ * @param schedule Schedule for particle loops of variable cost, such as
+ * those of adaptive ODE integrators. One of "static", "dynamic" or
+ * "guided".
+ * @param chunk Chunk size for @p schedule. Zero for the default.
+ *
+ * Loops that use a pseudorandom number generator per thread always use
+ * static scheduling, for reproducibility. Only loops declared with
+ * <tt>schedule(runtime)</tt> follow @p schedule.
  */
-void bi_omp_init(const int threads = 0);
+void bi_omp_init(const int threads = 0, const std::string& schedule =
+    "static", const int chunk = 0);
 
 /**
  * Terminate OpenMP environment.
  */
 void bi_omp_term();
 
+/**
+ * Barrier for use at the end of a <tt>schedule(runtime) nowait</tt> loop
+ * within a parallel region. Under <tt>--enable-diagnostics=5</tt>, the time
+ * that each thread waits is accumulated, and reported by bi_omp_term().
+ */
+void bi_omp_barrier();
+
+/**
+ * Number of threads in the current team.
+ *
+ * Within a parallel region this is usually #bi_omp_max_threads, but it is
+ * one where the region is nested within another, and so executed by a single
+ * thread. Loops that partition work into per-thread blocks should use this
+ * and bi_omp_team_tid(), not #bi_omp_max_threads and #bi_omp_tid.
+ */
+inline int bi_omp_team_size() {
+#if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+  return omp_get_num_threads();
+#else
+  return 1;
+#endif
+}
+
+/**
+ * Id of the current thread within its team.
+ */
+inline int bi_omp_team_tid() {
+#if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Is the current thread within an active parallel region, i.e. one that is
+ * executed by more than one thread?
+ */
+inline bool bi_omp_in_parallel() {
+#if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+  return omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
 #endif
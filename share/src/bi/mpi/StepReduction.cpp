@@ -0,0 +1,238 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "StepReduction.hpp"
+
+#include <cmath>
+
+/**
+ * Number of values ahead of the means in a record: number of variables,
+ * number of sums, number of particles, maximum log-weight, sum of weights
+ * and sum of squared weights.
+ */
+#define BI_STEP_REDUCTION_HEAD 6
+
+bi::StepReduction::StepReduction() :
+    P(0), mx(-BI_INF), W(0.0), W2(0.0), NP(0), nodeComm(MPI_COMM_NULL),
+    leaderComm(MPI_COMM_NULL), flat(true), op(MPI_OP_NULL), type(
+        MPI_DATATYPE_NULL), typeLen(0), request(MPI_REQUEST_NULL), initialised(
+        false) {
+  //
+}
+
+bi::StepReduction::~StepReduction() {
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (initialised && !finalized) {
+    if (type != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&type);
+    }
+    MPI_Op_free(&op);
+    if (leaderComm != MPI_COMM_NULL) {
+      MPI_Comm_free(&leaderComm);
+    }
+    MPI_Comm_free(&nodeComm);
+  }
+}
+
+void bi::StepReduction::clear() {
+  P = 0;
+  mx = -BI_INF;
+  W = 0.0;
+  W2 = 0.0;
+  NP = 0;
+  mu.clear();
+  C.clear();
+  sums.clear();
+}
+
+int bi::StepReduction::addSum(const double x) {
+  sums.push_back(x);
+  return sums.size() - 1;
+}
+
+void bi::StepReduction::start() {
+  /* pre-condition */
+  BI_ASSERT(request == MPI_REQUEST_NULL);
+
+  init();
+  pack();
+  if (flat) {
+    MPI_Iallreduce(MPI_IN_PLACE, &buf[0], 1, type, op, MPI_COMM_WORLD,
+        &request);
+  } else {
+    /* combine within node first */
+    int nodeRank;
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    if (nodeRank == 0) {
+      MPI_Ireduce(MPI_IN_PLACE, &buf[0], 1, type, op, 0, nodeComm, &request);
+    } else {
+      MPI_Ireduce(&buf[0], NULL, 1, type, op, 0, nodeComm, &request);
+    }
+  }
+}
+
+void bi::StepReduction::finish() {
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  if (!flat) {
+    /* then across nodes, and back within node */
+    if (leaderComm != MPI_COMM_NULL) {
+      MPI_Allreduce(MPI_IN_PLACE, &buf[0], 1, type, op, leaderComm);
+    }
+    MPI_Bcast(&buf[0], 1, type, 0, nodeComm);
+  }
+  unpack();
+}
+
+void bi::StepReduction::reduce() {
+  start();
+  finish();
+}
+
+int bi::StepReduction::getSize() const {
+  return P;
+}
+
+double bi::StepReduction::getMaxLogWeight() const {
+  return mx;
+}
+
+double bi::StepReduction::getLogSumWeights() const {
+  return mx + bi::log(W);
+}
+
+double bi::StepReduction::getLogSumSquaredWeights() const {
+  return 2.0*mx + bi::log(W2);
+}
+
+double bi::StepReduction::getEss() const {
+  return (W*W)/W2;
+}
+
+int bi::StepReduction::getDims() const {
+  return NP;
+}
+
+double bi::StepReduction::getSum(const int i) const {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i < (int)sums.size());
+
+  return sums[i];
+}
+
+void bi::StepReduction::init() {
+  if (!initialised) {
+    int rank, size, nodeRank, leader, nodes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+        MPI_INFO_NULL, &nodeComm);
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    leader = (nodeRank == 0) ? 1 : 0;
+    MPI_Comm_split(MPI_COMM_WORLD, leader ? 0 : MPI_UNDEFINED, rank,
+        &leaderComm);
+    MPI_Allreduce(&leader, &nodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    flat = nodes == 1 || nodes == size;
+
+    MPI_Op_create(&StepReduction::combine, 1, &op);
+    initialised = true;
+  }
+}
+
+void bi::StepReduction::pack() {
+  const int NS = sums.size();
+  const int len = BI_STEP_REDUCTION_HEAD + mu.size() + C.size() + NS;
+
+  buf.resize(len);
+  buf[0] = NP;
+  buf[1] = NS;
+  buf[2] = P;
+  buf[3] = mx;
+  buf[4] = W;
+  buf[5] = W2;
+  std::copy(mu.begin(), mu.end(), buf.begin() + BI_STEP_REDUCTION_HEAD);
+  std::copy(C.begin(), C.end(), buf.begin() + BI_STEP_REDUCTION_HEAD
+      + mu.size());
+  std::copy(sums.begin(), sums.end(), buf.end() - NS);
+
+  if (typeLen != len) {
+    if (type != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&type);
+    }
+    MPI_Type_contiguous(len, MPI_DOUBLE, &type);
+    MPI_Type_commit(&type);
+    typeLen = len;
+  }
+}
+
+void bi::StepReduction::unpack() {
+  const int NS = sums.size();
+
+  P = (int)buf[2];
+  mx = buf[3];
+  W = buf[4];
+  W2 = buf[5];
+  std::copy(buf.begin() + BI_STEP_REDUCTION_HEAD,
+      buf.begin() + BI_STEP_REDUCTION_HEAD + mu.size(), mu.begin());
+  std::copy(buf.begin() + BI_STEP_REDUCTION_HEAD + mu.size(),
+      buf.end() - NS, C.begin());
+  std::copy(buf.end() - NS, buf.end(), sums.begin());
+}
+
+void bi::StepReduction::combine(void* in, void* inout, int* len,
+    MPI_Datatype* type) {
+  int bytes;
+  MPI_Type_size(*type, &bytes);
+  const int n = bytes/sizeof(double);
+
+  for (int r = 0; r < *len; ++r) {
+    const double* a = static_cast<const double*>(in) + r*n;
+    double* b = static_cast<double*>(inout) + r*n;
+
+    const int NP = (int)b[0];
+    const int NS = (int)b[1];
+    const double mx = std::max(a[3], b[3]);
+
+    /* rescale weights of each to the larger maximum */
+    const double fa = (a[4] > 0.0) ? std::exp(a[3] - mx) : 0.0;
+    const double fb = (b[4] > 0.0) ? std::exp(b[3] - mx) : 0.0;
+    const double Wa = fa*a[4], Wb = fb*b[4], W = Wa + Wb;
+
+    /* merge means and covariances */
+    const double* mua = a + BI_STEP_REDUCTION_HEAD;
+    double* mub = b + BI_STEP_REDUCTION_HEAD;
+    const double* Ca = mua + NP;
+    double* Cb = mub + NP;
+    int i, j, k = 0;
+    if (W > 0.0) {
+      const double c = Wa*Wb/W;
+      for (j = 0; j < NP; ++j) {
+        const double dj = mua[j] - mub[j];
+        for (i = 0; i <= j; ++i, ++k) {
+          const double di = mua[i] - mub[i];
+          Cb[k] = fa*Ca[k] + fb*Cb[k] + c*di*dj;
+        }
+      }
+      for (j = 0; j < NP; ++j) {
+        mub[j] += (mua[j] - mub[j])*Wa/W;
+      }
+    }
+
+    b[2] += a[2];
+    b[3] = mx;
+    b[4] = W;
+    b[5] = fa*fa*a[5] + fb*fb*b[5];
+
+    /* sums */
+    const double* sa = a + n - NS;
+    double* sb = b + n - NS;
+    for (i = 0; i < NS; ++i) {
+      sb[i] += sa[i];
+    }
+  }
+}
@@ -0,0 +1,377 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MPI_STEPREDUCTION_HPP
+#define BI_MPI_STEPREDUCTION_HPP
+
+#include "mpi.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Reduction of the statistics of one step of an SMC method across
+ * processes, in a single collective.
+ *
+ * @ingroup mpi
+ *
+ * Carries together the number of particles, the maximum log-weight, the sums
+ * of weights and squared weights, the weighted mean and covariance of a set
+ * of variables, and any number of further sums, such as the state of a
+ * stopper or counts for reporting. Partial results are combined pairwise,
+ * rescaling weights to the larger of the two maxima and merging means and
+ * covariances, so that no separate collective is required for the maximum
+ * before the sums.
+ *
+ * The reduction is hierarchical. Partial results are first combined across
+ * the processes of each node, which share memory, then across one leader
+ * process per node, and the result broadcast back within each node. Where
+ * all processes are on one node, or each on its own node, a single
+ * allreduce is used instead. The first stage is nonblocking, so that local
+ * work that does not depend on the result may proceed between #start and
+ * #finish.
+ *
+ * To use, call #clear, add local statistics with #logWeights, #moments and
+ * #addSum, then call #start and #finish, or #reduce where there is no such
+ * work, before reading results. All processes must add the same statistics
+ * in the same order, and start reductions in the same order relative to
+ * other collectives.
+ */
+class StepReduction {
+public:
+  /**
+   * Constructor.
+   */
+  StepReduction();
+
+  /**
+   * Destructor.
+   */
+  ~StepReduction();
+
+  /**
+   * Clear local statistics.
+   */
+  void clear();
+
+  /**
+   * Add log-weights.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights of local particles.
+   */
+  template<class V1>
+  void logWeights(const V1 lws);
+
+  /**
+   * Add weighted moments of variables. Must be preceded by #logWeights
+   * with the same log-weights.
+   *
+   * @tparam V1 Vector type.
+   * @tparam M1 Matrix type.
+   *
+   * @param lws Log-weights of local particles.
+   * @param X Variables of local particles, one particle per row.
+   */
+  template<class V1, class M1>
+  void moments(const V1 lws, const M1 X);
+
+  /**
+   * Add sum.
+   *
+   * @param x Local value.
+   *
+   * @return Index of the sum, for #getSum.
+   */
+  int addSum(const double x);
+
+  /**
+   * Start reduction.
+   */
+  void start();
+
+  /**
+   * Finish reduction.
+   */
+  void finish();
+
+  /**
+   * Start and finish reduction.
+   */
+  void reduce();
+
+  /**
+   * Get total number of particles.
+   */
+  int getSize() const;
+
+  /**
+   * Get maximum log-weight.
+   */
+  double getMaxLogWeight() const;
+
+  /**
+   * Get logarithm of sum of weights.
+   */
+  double getLogSumWeights() const;
+
+  /**
+   * Get logarithm of sum of squared weights.
+   */
+  double getLogSumSquaredWeights() const;
+
+  /**
+   * Get ESS.
+   */
+  double getEss() const;
+
+  /**
+   * Get number of variables given to #moments.
+   */
+  int getDims() const;
+
+  /**
+   * Get weighted mean of variables.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param[out] mu Mean.
+   */
+  template<class V1>
+  void getMean(V1 mu) const;
+
+  /**
+   * Get weighted covariance of variables.
+   *
+   * @tparam M1 Matrix type.
+   *
+   * @param[out] Sigma Covariance.
+   */
+  template<class M1>
+  void getCov(M1 Sigma) const;
+
+  /**
+   * Get sum.
+   *
+   * @param i Index of the sum, as returned by #addSum.
+   */
+  double getSum(const int i) const;
+
+private:
+  /**
+   * Copy constructor, disallowed.
+   */
+  StepReduction(const StepReduction& o);
+
+  /**
+   * Assignment operator, disallowed.
+   */
+  StepReduction& operator=(const StepReduction& o);
+
+  /**
+   * Create communicators, operation and datatype on first use.
+   */
+  void init();
+
+  /**
+   * Pack local statistics into #buf.
+   */
+  void pack();
+
+  /**
+   * Unpack reduced statistics from #buf.
+   */
+  void unpack();
+
+  /**
+   * Combine partial results, as MPI user function.
+   */
+  static void combine(void* in, void* inout, int* len, MPI_Datatype* type);
+
+  /**
+   * Number of particles.
+   */
+  int P;
+
+  /**
+   * Maximum log-weight.
+   */
+  double mx;
+
+  /**
+   * Sum of weights, relative to #mx.
+   */
+  double W;
+
+  /**
+   * Sum of squared weights, relative to #mx.
+   */
+  double W2;
+
+  /**
+   * Number of variables.
+   */
+  int NP;
+
+  /**
+   * Mean of variables.
+   */
+  std::vector<double> mu;
+
+  /**
+   * Upper triangle of the sum of weighted outer products of deviations from
+   * #mu, relative to #mx, packed column by column.
+   */
+  std::vector<double> C;
+
+  /**
+   * Sums.
+   */
+  std::vector<double> sums;
+
+  /**
+   * Buffer for reduction.
+   */
+  std::vector<double> buf;
+
+  /**
+   * Communicator of processes on the same node.
+   */
+  MPI_Comm nodeComm;
+
+  /**
+   * Communicator of leader processes, one per node, null on others.
+   */
+  MPI_Comm leaderComm;
+
+  /**
+   * Use single allreduce rather than hierarchy?
+   */
+  bool flat;
+
+  /**
+   * Operation.
+   */
+  MPI_Op op;
+
+  /**
+   * Datatype, one record of the length of #buf.
+   */
+  MPI_Datatype type;
+
+  /**
+   * Length of #type.
+   */
+  int typeLen;
+
+  /**
+   * Request for first stage of reduction.
+   */
+  MPI_Request request;
+
+  /**
+   * Have communicators and operation been created?
+   */
+  bool initialised;
+};
+}
+
+#include "../pdf/misc.hpp"
+#include "../math/temp_vector.hpp"
+#include "../math/temp_matrix.hpp"
+#include "../primitive/vector_primitive.hpp"
+#include "../math/scalar.hpp"
+#include "../math/constant.hpp"
+#include "../misc/assert.hpp"
+#include "../cuda/cuda.hpp"
+
+#include <algorithm>
+
+template<class V1>
+void bi::StepReduction::logWeights(const V1 lws) {
+  typedef typename V1::value_type T1;
+
+  P = lws.size();
+  if (P > 0) {
+    T1 mx1, W1, W21;
+    logweight_reduce_impl<V1::location>::func(lws, mx1, W1, W21);
+    mx = mx1;
+    W = W1;
+    W2 = W21;
+  } else {
+    mx = -BI_INF;
+    W = 0.0;
+    W2 = 0.0;
+  }
+}
+
+template<class V1, class M1>
+void bi::StepReduction::moments(const V1 lws, const M1 X) {
+  /* pre-conditions */
+  BI_ASSERT(X.size1() == lws.size());
+  BI_ASSERT(lws.size() == P);
+
+  NP = X.size2();
+  mu.resize(NP);
+  C.resize(NP*(NP + 1)/2);
+  std::fill(mu.begin(), mu.end(), 0.0);
+  std::fill(C.begin(), C.end(), 0.0);
+
+  if (W > 0.0) {
+    typename temp_host_vector<real>::type ws(P), mu1(NP);
+    typename temp_host_matrix<real>::type X1(P, NP), Sigma1(NP, NP);
+
+    /* weights relative to the maximum, as for the sums */
+    ws = lws;
+    X1 = X;
+    synchronize();
+    subscal_elements(ws, mx, ws);
+    exp_elements(ws, ws);
+
+    bi::mean(X1, ws, mu1);
+    bi::cov(X1, ws, mu1, Sigma1);
+
+    int i, j, k = 0;
+    for (j = 0; j < NP; ++j) {
+      mu[j] = mu1(j);
+      for (i = 0; i <= j; ++i, ++k) {
+        C[k] = W*Sigma1(i, j);
+      }
+    }
+  }
+}
+
+template<class V1>
+void bi::StepReduction::getMean(V1 mu) const {
+  /* pre-condition */
+  BI_ASSERT(mu.size() == NP);
+
+  typename temp_host_vector<real>::type mu1(NP);
+  for (int i = 0; i < NP; ++i) {
+    mu1(i) = this->mu[i];
+  }
+  mu = mu1;
+}
+
+template<class M1>
+void bi::StepReduction::getCov(M1 Sigma) const {
+  /* pre-condition */
+  BI_ASSERT(Sigma.size1() == NP && Sigma.size2() == NP);
+
+  typename temp_host_matrix<real>::type Sigma1(NP, NP);
+  int i, j, k = 0;
+  for (j = 0; j < NP; ++j) {
+    for (i = 0; i <= j; ++i, ++k) {
+      Sigma1(i, j) = C[k]/W;
+      Sigma1(j, i) = Sigma1(i, j);
+    }
+  }
+  Sigma = Sigma1;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MPI_WIREDATATYPE_HPP
+#define BI_MPI_WIREDATATYPE_HPP
+
+#include "mpi.hpp"
+#include "../math/wire.hpp"
+
+#include <deque>
+#include <vector>
+#include <climits>
+
+namespace bi {
+/**
+ * MPI derived datatype for objects in wire format, describing their fields
+ * where they lie in memory, so that they can be sent without first being
+ * copied into a buffer.
+ *
+ * @ingroup mpi
+ *
+ * The datatype is a sequence of blocks of @c MPI_BYTE, sent from
+ * @c MPI_BOTTOM. It may be received as a contiguous span of #size bytes,
+ * to be read object by object with wire_unpack(). Headers and dimensions are
+ * held by the datatype, which must outlive any transfer using it. The
+ * objects must not be modified until the transfer completes. Vectors and
+ * matrices on device are not supported.
+ */
+class WireDatatype: public WireArchive<WireDatatype,false> {
+public:
+  /**
+   * Vectors and matrices on device may not be staged through temporaries,
+   * as the addresses of blocks are retained.
+   */
+  static const bool staging = false;
+
+  /**
+   * Constructor.
+   */
+  WireDatatype();
+
+  /**
+   * Destructor.
+   */
+  ~WireDatatype();
+
+  /**
+   * Append object.
+   *
+   * @tparam X Type with <tt>wire()</tt> member function template.
+   *
+   * @param x Object.
+   */
+  template<class X>
+  void add(const X& x);
+
+  /**
+   * Get datatype, committing it on first use. No objects may be appended
+   * after this.
+   */
+  MPI_Datatype type();
+
+  /**
+   * Size of the objects appended, in bytes, including their headers.
+   */
+  size_t size() const;
+
+  /**
+   * Visit block.
+   */
+  void block(const void* x, const size_t n);
+
+  /**
+   * Visit dimension of a vector or matrix field.
+   */
+  void dim(int& n);
+
+private:
+  /**
+   * Copy constructor, disallowed.
+   */
+  WireDatatype(const WireDatatype& o);
+
+  /**
+   * Assignment operator, disallowed.
+   */
+  WireDatatype& operator=(const WireDatatype& o);
+
+  /**
+   * Headers of objects.
+   */
+  std::deque<WireHeader> headers;
+
+  /**
+   * Dimensions of vector and matrix fields.
+   */
+  std::deque<int> dims;
+
+  /**
+   * Length of each block.
+   */
+  std::vector<int> lens;
+
+  /**
+   * Address of each block.
+   */
+  std::vector<MPI_Aint> displs;
+
+  /**
+   * Datatype.
+   */
+  MPI_Datatype dt;
+
+  /**
+   * Has the datatype been committed?
+   */
+  bool committed;
+
+  /**
+   * Size of the objects appended, in bytes.
+   */
+  size_t bytes;
+};
+}
+
+inline bi::WireDatatype::WireDatatype() : committed(false), bytes(0) {
+  //
+}
+
+inline bi::WireDatatype::~WireDatatype() {
+  if (committed) {
+    MPI_Type_free(&dt);
+  }
+}
+
+template<class X>
+void bi::WireDatatype::add(const X& x) {
+  /* pre-condition */
+  BI_ASSERT(!committed);
+
+  headers.push_back(WireHeader());
+  block(&headers.back(), sizeof(WireHeader));
+  const size_t start = bytes;
+  const_cast<X&>(x).wire(*this);
+  headers.back() = wire_header(bytes - start);
+}
+
+inline MPI_Datatype bi::WireDatatype::type() {
+  if (!committed) {
+    MPI_Type_create_hindexed(lens.size(), &lens[0], &displs[0], MPI_BYTE,
+        &dt);
+    MPI_Type_commit(&dt);
+    committed = true;
+  }
+  return dt;
+}
+
+inline size_t bi::WireDatatype::size() const {
+  return bytes;
+}
+
+inline void bi::WireDatatype::block(const void* x, const size_t n) {
+  BI_ERROR_MSG(n <= INT_MAX, "Block of " << n <<
+      " bytes is too large for an MPI datatype");
+
+  MPI_Aint displ;
+  MPI_Get_address(const_cast<void*>(x), &displ);
+  if (!displs.empty() && displs.back() + lens.back() == displ
+      && lens.back() + n <= INT_MAX) {
+    /* adjacent to previous block, so extend it */
+    lens.back() += n;
+  } else if (n > 0) {
+    lens.push_back(n);
+    displs.push_back(displ);
+  }
+  bytes += n;
+}
+
+inline void bi::WireDatatype::dim(int& n) {
+  dims.push_back(n);
+  block(&dims.back(), sizeof(int));
+}
+
+#endif
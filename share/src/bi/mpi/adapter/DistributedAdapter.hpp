@@ -7,6 +7,7 @@
 #define BI_MPI_ADAPTER_DISTRIBUTEDADAPTER_HPP
 
 #include "../../adapter/Adapter.hpp"
+#include "../StepReduction.hpp"
 
 namespace bi {
 /**
@@ -23,8 +24,45 @@ public:
   DistributedAdapter(const bool local = false, const double scale = 0.25,
       const double essRel = 0.25);
 
+  /**
+   * Adapt the proposal.
+   *
+   * @param s State.
+   *
+   * @return Was the adaptation successful?
+   */
   template<class S1>
   bool adapt(const S1& s);
+
+  /**
+   * Is the ESS high enough to adapt the proposal?
+   *
+   * @param s State.
+   * @param red Finished reduction, giving the total number of particles.
+   */
+  template<class S1>
+  bool ready(const S1& s, const StepReduction& red) const;
+
+  /**
+   * Add the statistics required for adaptation to a reduction across
+   * processes.
+   *
+   * @param s State.
+   * @param[in,out] red Reduction.
+   */
+  template<class S1>
+  void contribute(const S1& s, StepReduction& red);
+
+  /**
+   * Adapt the proposal from a finished reduction.
+   *
+   * @param s State.
+   * @param red Reduction, to which #contribute has added.
+   *
+   * @return Was the adaptation successful?
+   */
+  template<class S1>
+  bool adapt(const S1& s, const StepReduction& red);
 };
 }
 
@@ -41,4 +79,23 @@ bool bi::DistributedAdapter<A>::adapt(const S1& s) {
   return A::distributedAdapt(s);
 }
 
+template<class A>
+template<class S1>
+bool bi::DistributedAdapter<A>::ready(const S1& s,
+    const StepReduction& red) const {
+  return A::ready(s, red.getSize());
+}
+
+template<class A>
+template<class S1>
+void bi::DistributedAdapter<A>::contribute(const S1& s, StepReduction& red) {
+  A::contribute(s, red);
+}
+
+template<class A>
+template<class S1>
+bool bi::DistributedAdapter<A>::adapt(const S1& s, const StepReduction& red) {
+  return A::distributedAdapt(s, red);
+}
+
 #endif
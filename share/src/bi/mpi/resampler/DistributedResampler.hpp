@@ -9,6 +9,12 @@
 #define BI_MPI_RESAMPLER_DISTRIBUTEDRESAMPLER_HPP
 
 #include "../../resampler/Resampler.hpp"
+#include "../mpi.hpp"
+#include "../WireDatatype.hpp"
+#include "../StepReduction.hpp"
+#include "../../math/wire.hpp"
+
+#include "boost/shared_ptr.hpp"
 
 #include <vector>
 
@@ -35,32 +41,100 @@ public:
 
   /**
    * @copydoc Resampler::reduce(const V1, double*)
+   *
+   * The number of particles and sums of weights are reduced across
+   * processes in one collective, see StepReduction.
    */
   template<class V1>
   double reduce(const V1 lws, double* lW);
 
+  /**
+   * Add log-weights to a reduction across processes, so that they may be
+   * reduced together with the statistics of other components.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param[in,out] red Reduction.
+   */
+  template<class V1>
+  void contribute(const V1 lws, StepReduction& red);
+
+  /**
+   * Compute ESS and incremental log-likelihood from a finished reduction.
+   *
+   * @param red Reduction, to which #contribute has added.
+   * @param[out] lW Incremental log-likelihood.
+   *
+   * @return ESS.
+   */
+  double reduce(const StepReduction& red, double* lW);
+
   /**
    * @copydoc Resampler::resample(Random&, V1, V2, O1&)
+   *
+   * Outside of anytime mode, transfers of particles between processes are
+   * left in flight on return, see #ready and #complete.
    */
   template<class S1>
   bool resample(Random& rng, const ScheduleElement now, S1& s)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc Resampler::ready()
+   */
+  template<class S1>
+  int ready(const S1& s) const;
+
+  /**
+   * @copydoc Resampler::complete()
+   */
+  template<class S1>
+  void complete(S1& s);
+
 private:
   /**
    * Redistribute offspring around processes so that all processes have same
    * number of particles.
    *
    * @tparam M1 Matrix type.
-   * @tparam O1 State type.
+   * @tparam S1 State type.
    *
    * @param[in,out] O Offspring matrix. Rows index particles, columns index
    * processes.
-   * @param[in,out] s State.
+   * @param s State.
+   *
+   * Every process constructs the same plan from @p O. Each process with a
+   * surplus of offspring fills the largest deficit among the other
+   * processes in turn. For each transfer it sends the smallest of its
+   * particles, in wire format, with enough offspring to cover the lesser of
+   * its surplus and that deficit, or, if there is none, the particle with
+   * the most offspring. Particles differ in size, as they carry their
+   * outputs, so this reduces the number of bytes moved, not just the number
+   * of transfers.
+   *
+   * Each outgoing particle is packed in wire format (see WireHeader) into a
+   * byte span once, and all transfers are posted without waiting for them
+   * to complete. The sizes of particles are gathered beforehand, so that
+   * receives can be posted straight away.
    */
   template<class M1, class S1>
   void redistribute(M1 O, S1& s);
 
+  /**
+   * Copy particles to their offspring, deferring those of particles still
+   * to arrive from other processes. These are placed at the back.
+   *
+   * @tparam V1 Integer vector type.
+   * @tparam S1 State type.
+   *
+   * @param now Current step in time schedule.
+   * @param as Ancestors.
+   * @param[in,out] s State.
+   */
+  template<class V1, class S1>
+  void gatherLocal(const ScheduleElement now, const V1 as, S1& s);
+
   /**
    * Rotate particles around process so that all processes have a random
    * sample.
@@ -68,10 +142,30 @@ private:
    * @tparam S1 State type.
    *
    * @param[in,out] s State.
+   *
+   * Particles are sent in place, with a WireDatatype, as each remains
+   * untouched until its send completes.
    */
   template<class S1>
   void rotate(S1& s);
 
+  /**
+   * Post send of particle in place, for #rotate.
+   *
+   * @tparam S1 State type.
+   *
+   * @param s State.
+   * @param p Index of particle.
+   * @param dest Destination process.
+   * @param tag Message tag.
+   * @param[out] type Datatype of particle, which must outlive the send.
+   *
+   * @return Request for the send.
+   */
+  template<class S1>
+  MPI_Request sendInPlace(S1& s, const int p, const int dest, const int tag,
+      WireDatatype& type);
+
   /**
    * @name Timing
    */
@@ -86,53 +180,109 @@ private:
    */
   static void reportRedistribute(int timestep, int rank, long usecs);
   //@}
+
+  /**
+   * Reduction for #reduce.
+   */
+  StepReduction red;
+
+  /**
+   * Communicator for transfers of particles. Requests in flight refer to
+   * it, so it must outlive them.
+   */
+  boost::mpi::communicator comm;
+
+  /**
+   * Are transfers of particles in flight?
+   */
+  bool inFlight;
+
+  /**
+   * Number of particles ready while transfers are in flight.
+   */
+  int nready;
+
+  /**
+   * Requests for outgoing particles.
+   */
+  std::vector<MPI_Request> sendReqs;
+
+  /**
+   * Buffers of outgoing particles, in wire format.
+   */
+  std::vector<boost::shared_ptr<std::vector<char> > > sendBufs;
+
+  /**
+   * Requests for incoming particles.
+   */
+  std::vector<MPI_Request> recvReqs;
+
+  /**
+   * Buffers of incoming particles, in wire format.
+   */
+  std::vector<boost::shared_ptr<std::vector<char> > > recvBufs;
+
+  /**
+   * Index of the particle into which each incoming particle is received.
+   */
+  std::vector<int> recvSlots;
+
+  /**
+   * For each particle, the incoming particle of which it is to be a copy,
+   * or -1 if ready.
+   */
+  std::vector<int> srcs;
 };
 }
 
-#include "../mpi.hpp"
 #include "../../math/temp_vector.hpp"
 #include "../../math/temp_matrix.hpp"
 #include "../../math/view.hpp"
 
+#include <algorithm>
+#include <set>
+
 template<class R>
 bi::DistributedResampler<R>::DistributedResampler(const double essRel,
     const bool anytime) :
-    Resampler<R>(essRel, anytime) {
+    Resampler<R>(essRel, anytime), inFlight(false), nready(0) {
   //
 }
 
 template<class R>
 template<class V1>
 double bi::DistributedResampler<R>::reduce(const V1 lws, double* lW) {
-  typedef typename V1::value_type T1;
+  red.clear();
+  contribute(lws, red);
+  red.reduce();
 
-  boost::mpi::communicator world;
-  const int size = world.size();
-  T1 mx, sum1, sum2;
-  int P;
-
-  P = lws.size();
-  P = boost::mpi::all_reduce(world, P, std::plus<int>());
-  mx = max_reduce(lws);
-  mx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<T1>());
+  return reduce(red, lW);
+}
 
-  sum1 = op_reduce(lws, nan_minus_and_exp_functor<T1>(mx), 0.0,
-      thrust::plus<T1>());
-  sum1 = boost::mpi::all_reduce(world, sum1, std::plus<T1>());
+template<class R>
+template<class V1>
+inline void bi::DistributedResampler<R>::contribute(const V1 lws,
+    StepReduction& red) {
+  red.logWeights(lws);
+}
 
-  sum2 = op_reduce(lws, nan_minus_exp_and_square_functor<T1>(mx), 0.0,
-      thrust::plus<T1>());
-  sum2 = boost::mpi::all_reduce(world, sum2, std::plus<T1>());
+template<class R>
+double bi::DistributedResampler<R>::reduce(const StepReduction& red,
+    double* lW) {
+  boost::mpi::communicator world;
+  const int size = world.size();
+  const int P = red.getSize();
 
   if (lW != NULL) {
-    *lW = mx + bi::log(sum1);
+    /* in anytime mode, each process eliminates one active particle */
+    *lW = red.getLogSumWeights();
     if (this->anytime) {
-      *lW -= bi::log(double(size * (P - 1)));
+      *lW -= bi::log(double(P - size));
     } else {
-      *lW -= bi::log(double(size * P));
+      *lW -= bi::log(double(P));
     }
   }
-  return (sum1 * sum1) / sum2;
+  return red.getEss();
 }
 
 template<class R>
@@ -186,10 +336,16 @@ bool bi::DistributedResampler<R>::resample(Random& rng,
     redistribute(O, s);
     offspringToAncestors(column(O, rank), as1);
     permute(as1);
-    s.gather(now, as1);
+    gatherLocal(now, as1, s);
     set_elements(s.logWeights(), s.logLikelihood);
-    this->shuffle(rng, s);
-    rotate(s);
+    if (this->anytime) {
+      /* elimination of the active particle requires a random placement of
+       * particles, so transfers must complete first; otherwise, every
+       * particle is moved and placement does not matter */
+      complete(s);
+      this->shuffle(rng, s);
+      rotate(s);
+    }
   } else if (now.hasOutput()) {
     seq_elements(s.ancestors(), 0);
   }
@@ -206,86 +362,127 @@ void bi::DistributedResampler<R>::reportResample(int timestep, int rank,
 template<class R>
 template<class M1, class S1>
 void bi::DistributedResampler<R>::redistribute(M1 O, S1& s) {
+  /* pre-condition */
+  BI_ASSERT(!inFlight);
+
   typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef std::pair<int,int> pair_type;
 
 #if ENABLE_DIAGNOSTICS == 2
   synchronize();
   TicToc clock;
 #endif
 
-  boost::mpi::communicator world;
-  const int rank = world.rank();
-  const int size = world.size();
+  const int rank = comm.rank();
+  const int size = comm.size();
   const int P = O.size1();
 
-  int sendi, recvi, sendj, recvj, sendn, recvn, n, sendr, recvr, tag = 0;
-
-  int_vector_type Ps(size);  // number of particles in each process
-  int_vector_type ranks(size);  // ranks sorted by number of particles
-  std::list < boost::mpi::request > reqs;
+  int_vector_type Ps(size);  // number of offspring in each process
+  std::vector<int> ns(P), Ns(P*size);  // sizes of particles in wire format
+  std::vector<pair_type> senders;  // (-surplus, rank) of each sender
+  std::set<pair_type> bySize;  // (size, index) of sender's particles
+  std::set<pair_type> byCount;  // (-offspring, index) of sender's particles
+  std::set<pair_type>::iterator iter;
+  std::vector<int> recvis(size, 0);  // next zero of each receiver
+  std::vector<int> packed(P, -1);  // buffer of each outgoing particle
+  int i, j, k, n, sendr, recvr, tag = 0;
 
   sum_rows(O, Ps);
-  seq_elements(ranks, 0);
-  sort_by_key(Ps, ranks);
-
-  /* redistribute offspring */
-  sendj = size - 1;
-  recvj = 0;
-  sendi = 0;
-  recvi = 0;
-
-  while (Ps(sendj) > P) {
-    /* ranks */
-    sendr = ranks(sendj);
-    recvr = ranks(recvj);
-
-    /* advance to next nonzero of sender */
-    while (O(sendi, sendr) == 0) {
-      ++sendi;
+  for (j = 0; j < size; ++j) {
+    if (Ps(j) > P) {
+      senders.push_back(std::make_pair(P - Ps(j), j));
     }
+  }
+  std::sort(senders.begin(), senders.end());
 
-    /* advance to next zero of receiver */
-    while (O(recvi, recvr) > 0) {
-      ++recvi;
+  /* all processes see the same senders, so agree on whether to gather */
+  if (!senders.empty()) {
+    for (i = 0; i < P; ++i) {
+      ns[i] = wire_size(*s.s1s[i]) + wire_size(*s.out1s[i]);
     }
+    boost::mpi::all_gather(comm, &ns[0], P, &Ns[0]);
+  }
 
-    /* determine number of offspring to transfer */
-    recvn = P - Ps(recvj);  // max to receive
-    sendn = bi::min(Ps(sendj) - P, O(sendi, sendr));  // max to send
-    n = bi::min(recvn, sendn);  // actual to transfer
-
-    /* update offspring */
-    O(sendi, sendr) -= n;
-    O(recvi, recvr) += n;
-
-    /* update particle counts */
-    Ps(sendj) -= n;
-    Ps(recvj) += n;
-    BI_ASSERT(Ps(sendj) >= P);
-    BI_ASSERT(Ps(recvj) <= P);
-
-    /* transfer particle */
-    if (rank == recvr) {
-      reqs.push_back(world.irecv(sendr, tag, *s.s1s[recvi]));
-      reqs.push_back(world.irecv(sendr, tag + 1, *s.out1s[recvi]));
-    } else if (rank == sendr) {
-      reqs.push_back(world.isend(recvr, tag, *s.s1s[sendi]));
-      reqs.push_back(world.isend(recvr, tag + 1, *s.out1s[sendi]));
-    }
-    tag += 2;
+  for (k = 0; k < (int)senders.size(); ++k) {
+    sendr = senders[k].second;
 
-    if (Ps(sendj) == P) {
-      --sendj;
-      sendi = 0;
+    bySize.clear();
+    byCount.clear();
+    for (i = 0; i < P; ++i) {
+      if (O(i, sendr) > 0) {
+        bySize.insert(std::make_pair(Ns[sendr*P + i], i));
+        byCount.insert(std::make_pair(-O(i, sendr), i));
+      }
     }
-    if (Ps(recvj) == P) {
-      ++recvj;
-      recvi = 0;
+
+    while (Ps(sendr) > P) {
+      /* receiver with largest deficit */
+      recvr = 0;
+      for (j = 1; j < size; ++j) {
+        if (Ps(j) < Ps(recvr)) {
+          recvr = j;
+        }
+      }
+      BI_ASSERT(Ps(recvr) < P);
+
+      /* advance to next zero of receiver */
+      while (O(recvis[recvr], recvr) > 0) {
+        ++recvis[recvr];
+      }
+
+      /* smallest particle that covers the transfer, if any, otherwise that
+       * with the most offspring */
+      n = bi::min(Ps(sendr) - P, P - Ps(recvr));
+      BI_ASSERT(!byCount.empty());
+      i = byCount.begin()->second;
+      if (O(i, sendr) >= n) {
+        iter = bySize.begin();
+        while (O(iter->second, sendr) < n) {
+          ++iter;
+        }
+        i = iter->second;
+      }
+      n = bi::min(n, O(i, sendr));
+
+      /* update offspring and particle counts */
+      byCount.erase(std::make_pair(-O(i, sendr), i));
+      O(i, sendr) -= n;
+      O(recvis[recvr], recvr) += n;
+      Ps(sendr) -= n;
+      Ps(recvr) += n;
+      if (O(i, sendr) > 0) {
+        byCount.insert(std::make_pair(-O(i, sendr), i));
+      } else {
+        bySize.erase(std::make_pair(Ns[sendr*P + i], i));
+      }
+
+      /* post transfer of particle */
+      if (rank == sendr) {
+        if (packed[i] < 0) {
+          packed[i] = sendBufs.size();
+          sendBufs.push_back(boost::shared_ptr<std::vector<char> >(
+              new std::vector<char>(ns[i])));
+          char* ptr = &sendBufs.back()->front();
+          ptr += wire_pack(*s.s1s[i], ptr);
+          wire_pack(*s.out1s[i], ptr);
+        }
+        std::vector<char>& buf = *sendBufs[packed[i]];
+        sendReqs.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(&buf[0], buf.size(), MPI_BYTE, recvr, tag, comm,
+            &sendReqs.back());
+      } else if (rank == recvr) {
+        recvBufs.push_back(boost::shared_ptr<std::vector<char> >(
+            new std::vector<char>(Ns[sendr*P + i])));
+        std::vector<char>& buf = *recvBufs.back();
+        recvReqs.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(&buf[0], buf.size(), MPI_BYTE, sendr, tag, comm,
+            &recvReqs.back());
+        recvSlots.push_back(recvis[recvr]);
+      }
+      ++tag;
     }
   }
-
-  /* wait for all copies to complete */
-  boost::mpi::wait_all(reqs.begin(), reqs.end());
+  inFlight = !sendReqs.empty() || !recvReqs.empty();
 
 #if ENABLE_DIAGNOSTICS == 2
   long usecs = clock.toc();
@@ -294,24 +491,131 @@ void bi::DistributedResampler<R>::redistribute(M1 O, S1& s) {
 #endif
 }
 
+template<class R>
+template<class V1, class S1>
+void bi::DistributedResampler<R>::gatherLocal(const ScheduleElement now,
+    const V1 as, S1& s) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+
+  const int P = s.size();
+  typename temp_host_vector<int>::type as1(P);
+  std::vector<int> direct(P, -1);  // incoming particle received into each
+  int i, j, k, a;
+
+  /* particles to be copied from incoming particles keep their place for
+   * now */
+  srcs.assign(P, -1);
+  for (k = 0; k < (int)recvSlots.size(); ++k) {
+    direct[recvSlots[k]] = k;
+  }
+  for (i = 0; i < P; ++i) {
+    srcs[i] = direct[as(i)];
+    as1(i) = (srcs[i] >= 0) ? i : as(i);
+  }
+  s.gather(now, as1);
+  for (i = 0; i < P; ++i) {
+    if (srcs[i] >= 0) {
+      s.ancestors()(i) = s.ancestors()(as(i));
+    }
+  }
+
+  /* move them to the back, so that the rest can be used in the meantime */
+  i = 0;
+  j = P - 1;
+  while (true) {
+    while (i < j && srcs[i] < 0) {
+      ++i;
+    }
+    while (i < j && srcs[j] >= 0) {
+      --j;
+    }
+    if (i >= j) {
+      break;
+    }
+    std::swap(s.s1s[i], s.s1s[j]);
+    std::swap(s.out1s[i], s.out1s[j]);
+    std::swap(srcs[i], srcs[j]);
+    std::swap(direct[i], direct[j]);
+    a = s.ancestors()(i);
+    s.ancestors()(i) = s.ancestors()(j);
+    s.ancestors()(j) = a;
+  }
+
+  nready = P;
+  for (i = 0; i < P; ++i) {
+    if (direct[i] >= 0) {
+      recvSlots[direct[i]] = i;
+    }
+    if (srcs[i] >= 0) {
+      --nready;
+    }
+  }
+}
+
+template<class R>
+template<class S1>
+inline int bi::DistributedResampler<R>::ready(const S1& s) const {
+  return inFlight ? nready : s.size();
+}
+
+template<class R>
+template<class S1>
+void bi::DistributedResampler<R>::complete(S1& s) {
+  if (inFlight) {
+    const int P = s.size();
+    int i, k;
+    size_t n;
+
+    /* unpack incoming particles, then copy to their offspring */
+    for (k = 0; k < (int)recvReqs.size(); ++k) {
+      MPI_Wait(&recvReqs[k], MPI_STATUS_IGNORE);
+      std::vector<char>& buf = *recvBufs[k];
+      n = wire_unpack(*s.s1s[recvSlots[k]], &buf[0], buf.size());
+      wire_unpack(*s.out1s[recvSlots[k]], &buf[n], buf.size() - n);
+    }
+    for (i = nready; i < P; ++i) {
+      k = recvSlots[srcs[i]];
+      if (i != k) {
+        *s.s1s[i] = *s.s1s[k];
+        *s.out1s[i] = *s.out1s[k];
+      }
+    }
+
+    /* outgoing buffers can be released once sent */
+    if (!sendReqs.empty()) {
+      MPI_Waitall(sendReqs.size(), &sendReqs[0], MPI_STATUSES_IGNORE);
+    }
+
+    sendReqs.clear();
+    sendBufs.clear();
+    recvReqs.clear();
+    recvBufs.clear();
+    recvSlots.clear();
+    inFlight = false;
+  }
+}
+
 template<class R>
 template<class S1>
 void bi::DistributedResampler<R>::rotate(S1& s) {
-  boost::mpi::communicator world;
-  const int rank = world.rank();
-  const int size = world.size();
+  const int rank = comm.rank();
+  const int size = comm.size();
   const int P = s.size();
 
-  std::vector < boost::mpi::request > sends1(P), sends2(P);
-  int p, sendr, recvr;
+  std::vector<MPI_Request> sends(P, MPI_REQUEST_NULL);
+  std::vector<boost::shared_ptr<WireDatatype> > types(P);
+  std::vector<char> buf1;
+  MPI_Status status;
+  int p, sendr, recvr, n, k;
 
   /* pipeline first round of sends */
   const int buf = 8;
   for (p = 0; p < buf * size && p < P; ++p) {
     if (p % size > 0) {
       recvr = (rank + p) % size;
-      sends1[p] = world.isend(recvr, 2 * rank * p, *s.s1s[p]);
-      sends2[p] = world.isend(recvr, 2 * rank * p + 1, *s.out1s[p]);
+      types[p].reset(new WireDatatype());
+      sends[p] = sendInPlace(s, p, recvr, rank * p, *types[p]);
     }
   }
 
@@ -320,12 +624,17 @@ void bi::DistributedResampler<R>::rotate(S1& s) {
     if (p % size > 0) {
       /* receive new particle for this position */
       sendr = (rank + size - (p % size)) % size;
-      world.recv(sendr, 2 * sendr * p, s.s2);
-      world.recv(sendr, 2 * sendr * p + 1, s.out2);
+      MPI_Probe(sendr, sendr * p, comm, &status);
+      MPI_Get_count(&status, MPI_BYTE, &n);
+      buf1.resize(n);
+      MPI_Recv(&buf1[0], n, MPI_BYTE, sendr, sendr * p, comm,
+          MPI_STATUS_IGNORE);
+      k = wire_unpack(s.s2, &buf1[0], n);
+      wire_unpack(s.out2, &buf1[k], n - k);
 
       /* ensure old particle in this position has been sent */
-      sends1[p].wait();
-      sends2[p].wait();
+      MPI_Wait(&sends[p], MPI_STATUS_IGNORE);
+      types[p].reset();
 
       /* replace the old particle with the new particle */
       s.s2.swap(*s.s1s[p]);
@@ -334,15 +643,27 @@ void bi::DistributedResampler<R>::rotate(S1& s) {
       /* continue the pipeline */
       recvr = (rank + p) % size;
       if (p + buf * size < P) {
-        sends1[p + buf * size] = world.isend(recvr,
-            2 * rank * (p + buf * size), *s.s1s[p]);
-        sends2[p + buf * size] = world.isend(recvr,
-            2 * rank * (p + buf * size) + 1, *s.out1s[p]);
+        k = p + buf * size;
+        types[k].reset(new WireDatatype());
+        sends[k] = sendInPlace(s, k, recvr, rank * k, *types[k]);
       }
     }
   }
 }
 
+template<class R>
+template<class S1>
+MPI_Request bi::DistributedResampler<R>::sendInPlace(S1& s, const int p,
+    const int dest, const int tag, WireDatatype& type) {
+  MPI_Request request;
+
+  type.add(*s.s1s[p]);
+  type.add(*s.out1s[p]);
+  MPI_Isend(MPI_BOTTOM, 1, type.type(), dest, tag, comm, &request);
+
+  return request;
+}
+
 template<class R>
 void bi::DistributedResampler<R>::reportRedistribute(int timestep, int rank,
     long usecs) {
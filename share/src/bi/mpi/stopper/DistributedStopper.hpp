@@ -8,6 +8,7 @@
 #define BI_MPI_STOPPER_DISTRIBUTEDSTOPPER_HPP
 
 #include "../../stopper/Stopper.hpp"
+#include "../StepReduction.hpp"
 
 namespace bi {
 /**
@@ -29,13 +30,20 @@ public:
 
   /**
    * Stop?
+   *
+   * The number of particles and the sums of the stopper are reduced across
+   * processes in one collective, see StepReduction.
    */
   bool stop(const double maxlw = BI_INF);
+
+private:
+  /**
+   * Reduction for #stop.
+   */
+  StepReduction red;
 };
 }
 
-#include "../mpi.hpp"
-
 template<class S>
 bi::DistributedStopper<S>::DistributedStopper(const double threshold, const int maxP,
     const int T) : Stopper<S>(threshold, maxP, T) {
@@ -44,10 +52,13 @@ bi::DistributedStopper<S>::DistributedStopper(const double threshold, const int
 
 template<class S>
 inline bool bi::DistributedStopper<S>::stop(const double maxlw) {
-  boost::mpi::communicator world;
-  const int P1 = boost::mpi::all_reduce(world, this->P, std::plus<int>());
+  red.clear();
+  const int i = red.addSum(this->P);
+  S::contribute(red);
+  red.reduce();
 
-  return P1 >= this->maxP || S::distributedStop(this->T, this->threshold, this->maxlw);
+  return red.getSum(i) >= this->maxP
+      || S::distributedStop(red, i + 1, this->T, this->threshold, maxlw);
 }
 
 #endif
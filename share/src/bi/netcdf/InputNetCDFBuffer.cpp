@@ -7,6 +7,8 @@
  */
 #include "InputNetCDFBuffer.hpp"
 
+int bi::InputNetCDFBuffer::readAhead = 32;
+
 bi::InputNetCDFBuffer::InputNetCDFBuffer(const Model& m,
     const std::string& file, const long ns, const long np) :
     NetCDFBuffer(file), m(m), vars(NUM_VAR_TYPES), nsDim(-1), npDim(-1), ns(
@@ -22,11 +24,12 @@ void bi::InputNetCDFBuffer::readMask(const size_t k, const VarType type,
 
   Var* var;
   int r;
-  long start, len;
+  long start, len, ahead;
   for (r = 0; r < int(recDims.size()); ++r) {
     if (timeVars[r] >= 0) {
       start = recStarts[k][r];
       len = recLens[k][r];
+      ahead = readAheadEnd(k, r);
 
       if (len > 0) {
         BOOST_AUTO(range, modelVars.equal_range(r));
@@ -36,7 +39,7 @@ void bi::InputNetCDFBuffer::readMask(const size_t k, const VarType type,
         if (coordVars[r] >= 0) {
           /* sparse mask */
           temp_matrix_type C(iter->second->getNumDims(), len);
-          readCoords(coordVars[r], start, len, C);
+          readCoords(coordVars[r], start, len, C, ahead);
           for (; iter != end; ++iter) {
             var = iter->second;
             if (var->getType() == type) {
@@ -103,6 +106,24 @@ void bi::InputNetCDFBuffer::readMask0(const VarType type,
   }
 }
 
+void bi::InputNetCDFBuffer::setReadAhead(const int window) {
+  readAhead = window;
+}
+
+long bi::InputNetCDFBuffer::readAheadEnd(const size_t k, const int r) const {
+  long end = -1;
+  if (readAhead > 1) {
+    size_t k1, last = std::min(k + readAhead, times.size());
+    for (k1 = k; k1 < last; ++k1) {
+      if (recLens[k1][r] > 0) {
+        end = std::max(end,
+            static_cast<long>(recStarts[k1][r] + recLens[k1][r]));
+      }
+    }
+  }
+  return end;
+}
+
 void bi::InputNetCDFBuffer::map() {
   int ncDim, ncVar;
   Var* var;
@@ -15,6 +15,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <algorithm>
+#include <cstring>
 
 namespace bi {
 /**
@@ -22,6 +24,11 @@ namespace bi {
  * g and sequentially reading input in sparse format.
  *
  * @ingroup io_netcdf
+ *
+ * Reads along record dimensions are made ahead: when the data for one time
+ * index is requested, that for the following time indices, up to the
+ * read-ahead window set with setReadAhead(), is read in the same
+ * contiguous hyperslab, and subsequent requests are served from memory.
  */
 class InputNetCDFBuffer: public NetCDFBuffer {
 public:
@@ -87,7 +94,64 @@ public:
   template<class M1>
   void read0(const VarType type, M1 X);
 
+  /**
+   * Set the read-ahead window.
+   *
+   * @param window Number of time indices to read at once, one or zero to
+   * disable read-ahead.
+   */
+  static void setReadAhead(const int window);
+
 protected:
+  /**
+   * Hyperslab of variable held in memory.
+   */
+  struct Window {
+    /**
+     * Offsets along each dimension.
+     */
+    std::vector<size_t> offsets;
+
+    /**
+     * Counts along each dimension.
+     */
+    std::vector<size_t> counts;
+
+    /**
+     * Data.
+     */
+    std::vector<char> buf;
+  };
+
+  /**
+   * End of read-ahead along record dimension.
+   *
+   * @param k Time index.
+   * @param r Record dimension index.
+   *
+   * @return Offset along record dimension up to which to read ahead, -1 if
+   * read-ahead is disabled.
+   */
+  long readAheadEnd(const size_t k, const int r) const;
+
+  /**
+   * Read hyperslab of variable, through the read-ahead window.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param ncVar Variable.
+   * @param offsets Offsets along each dimension.
+   * @param counts Counts along each dimension.
+   * @param j Position of record dimension in @p offsets and @p counts.
+   * @param end Offset along record dimension up to which to read ahead, -1
+   * to read without read-ahead.
+   * @param[out] buf Contiguous output.
+   */
+  template<class T1>
+  void readRange(int ncVar, const std::vector<size_t>& offsets,
+      const std::vector<size_t>& counts, const int j, const long end,
+      T1* buf);
+
   /**
    * Read from time variable.
    *
@@ -113,9 +177,11 @@ protected:
    * @param start Offset along record dimension.
    * @param len Extent along record dimension.
    * @param[out] C Coordinate vector.
+   * @param end End of read-ahead along record dimension, -1 for none.
    */
   template<class M1>
-  void readCoords(int ncVar, const long start, const long len, M1 C);
+  void readCoords(int ncVar, const long start, const long len, M1 C,
+      const long end = -1);
 
   /**
    * Densely-masked read into matrix.
@@ -126,9 +192,11 @@ protected:
    * @param start Offset along record dimension. -1 if no record dimension.
    * @param len Extent along record dimension. -1 if no record dimension.
    * @param[out] X Output.
+   * @param end End of read-ahead along record dimension, -1 for none.
    */
   template<class M1>
-  void readVar(int ncVar, const long start, const long len, M1 X);
+  void readVar(int ncVar, const long start, const long len, M1 X,
+      const long end = -1);
 
   /**
    * Sparsely-masked read into matrix.
@@ -140,10 +208,11 @@ protected:
    * @param start Offset along record dimension.
    * @param len Extent along record dimension.
    * @param[out] X Output.
+   * @param end End of read-ahead along record dimension, -1 for none.
    */
   template<class V1, class M1>
   void readVar(int ncVar, const long start, const long len, const V1 ixs,
-      M1 X);
+      M1 X, const long end = -1);
 
   /**
    * Serialise coordinates from matrix into vector.
@@ -264,6 +333,16 @@ protected:
    * Index of record to read along @c np dimension.
    */
   long np;
+
+  /**
+   * Read-ahead windows, indexed by variable.
+   */
+  std::map<int,Window> windows;
+
+  /**
+   * Read-ahead window, in time indices.
+   */
+  static int readAhead;
 };
 }
 
@@ -288,11 +367,12 @@ void bi::InputNetCDFBuffer::read(const size_t k, const VarType type,
     const Mask<ON_HOST>& mask, M1 X) {
   Var* var;
   int ncVar, r;
-  long start, len;
+  long start, len, ahead;
   for (r = 0; r < int(recDims.size()); ++r) {
     if (timeVars[r] >= 0) {
       start = recStarts[k][r];
       len = recLens[k][r];
+      ahead = readAheadEnd(k, r);
 
       if (len > 0) {
         /* active range at this time index */
@@ -308,10 +388,10 @@ void bi::InputNetCDFBuffer::read(const size_t k, const VarType type,
               /* update this variable */
               if (mask.isDense(var->getId())) {
                 readVar(ncVar, start, len,
-                    columns(X, var->getStart(), var->getSize()));
+                    columns(X, var->getStart(), var->getSize()), ahead);
               } else if (mask.isSparse(var->getId())) {
                 readVar(ncVar, start, len, mask.getIndices(var->getId()),
-                    columns(X, var->getStart(), var->getSize()));
+                    columns(X, var->getStart(), var->getSize()), ahead);
               }
             }
           }
@@ -386,7 +466,7 @@ void bi::InputNetCDFBuffer::read0(const VarType type, M1 X) {
 
 template<class M1>
 void bi::InputNetCDFBuffer::readCoords(int ncVar, const long start,
-    const long len, M1 C) {
+    const long len, M1 C, const long end) {
   /* pre-condition */
   BI_ASSERT(ncVar >= 0);
   BI_ASSERT(start >= 0);
@@ -394,7 +474,7 @@ void bi::InputNetCDFBuffer::readCoords(int ncVar, const long start,
 
   std::vector<size_t> offsets(3), counts(3);
   std::vector<int> dimids(3);
-  int j = 0;
+  int j = 0, rec;
 
   dimids = nc_inq_vardimid(ncid, ncVar);
 
@@ -407,6 +487,7 @@ void bi::InputNetCDFBuffer::readCoords(int ncVar, const long start,
   }
 
   /* record dimension */
+  rec = j;
   offsets[j] = start;
   counts[j] = len;
   ++j;
@@ -421,16 +502,16 @@ void bi::InputNetCDFBuffer::readCoords(int ncVar, const long start,
   /* read */
   if (M1::on_device || !C.contiguous()) {
     typename sim_temp_matrix<M1>::type C1(C.size1(), C.size2());
-    nc_get_vara(ncid, ncVar, offsets, counts, C1.buf());
+    readRange(ncVar, offsets, counts, rec, end, C1.buf());
     C = C1;
   } else {
-    nc_get_vara(ncid, ncVar, offsets, counts, C.buf());
+    readRange(ncVar, offsets, counts, rec, end, C.buf());
   }
 }
 
 template<class M1>
 void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
-    const long len, M1 X) {
+    const long len, M1 X, const long end) {
   /* pre-condition */
   BI_ASSERT(ncVar >= 0);
 
@@ -439,7 +520,7 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
 
   std::vector<int> dimids = nc_inq_vardimid(ncid, ncVar);
   std::vector<size_t> offsets(dimids.size()), counts(dimids.size());
-  int j = 0;
+  int j = 0, rec = -1;
   bool haveP = false;
 
   /* ns dimension */
@@ -452,6 +533,7 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
 
   /* record dimension */
   if (start >= 0 && len >= 0) {
+    rec = j;
     offsets[j] = start;
     counts[j] = len;
     ++j;
@@ -487,20 +569,20 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
   /* read */
   if (!haveP && X.size1() > 1) {
     temp_vector_type x1(X.size2());
-    nc_get_vara(ncid, ncVar, offsets, counts, x1.buf());
+    readRange(ncVar, offsets, counts, rec, end, x1.buf());
     set_rows(X, x1);
   } else if (M1::on_device || !X.contiguous()) {
     temp_matrix_type X1(X.size1(), X.size2());
-    nc_get_vara(ncid, ncVar, offsets, counts, X1.buf());
+    readRange(ncVar, offsets, counts, rec, end, X1.buf());
     X = X1;
   } else {
-    nc_get_vara(ncid, ncVar, offsets, counts, X.buf());
+    readRange(ncVar, offsets, counts, rec, end, X.buf());
   }
 }
 
 template<class V1, class M1>
 void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
-    const long len, const V1 ixs, M1 X) {
+    const long len, const V1 ixs, M1 X, const long end) {
   /* pre-condition */
   BI_ASSERT(ncVar >= 0);
   BI_ASSERT(!V1::on_device);
@@ -510,7 +592,7 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
 
   std::vector<int> dimids = nc_inq_vardimid(ncid, ncVar);
   std::vector<size_t> offsets(dimids.size()), counts(dimids.size());
-  int j = 0;
+  int j = 0, rec = -1;
   bool haveP = false;
 
   /* ns dimension */
@@ -522,6 +604,7 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
   }
 
   /* record dimension */
+  rec = j;
   offsets[j] = start;
   counts[j] = len;
   ++j;
@@ -544,13 +627,13 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
 
   if (!haveP && X.size1() > 1) {
     temp_vector_type x1(static_cast<int>(len));
-    nc_get_vara(ncid, ncVar, offsets, counts, x1.buf());
+    readRange(ncVar, offsets, counts, rec, end, x1.buf());
     for (j = 0; j < static_cast<int>(len); ++j) {
       set_elements(column(X, ixs(j)), x1(j));
     }
   } else {
     temp_matrix_type X1(X.size1(), static_cast<int>(len));
-    nc_get_vara(ncid, ncVar, offsets, counts, X1.buf());
+    readRange(ncVar, offsets, counts, rec, end, X1.buf());
     for (j = 0; j < static_cast<int>(len); ++j) {
       ///@todo This could be improved for contiguous columns
       column(X, ixs(j)) = column(X1, j);
@@ -558,6 +641,45 @@ void bi::InputNetCDFBuffer::readVar(int ncVar, const long start,
   }
 }
 
+template<class T1>
+void bi::InputNetCDFBuffer::readRange(int ncVar,
+    const std::vector<size_t>& offsets, const std::vector<size_t>& counts,
+    const int j, const long end, T1* buf) {
+  if (j < 0 || end < 0) {
+    nc_get_vara(ncid, ncVar, offsets, counts, buf);
+  } else {
+    Window& w = windows[ncVar];
+    int i;
+    size_t inner = 1;
+    bool hit = w.offsets.size() == offsets.size()
+        && w.offsets[j] <= offsets[j]
+        && offsets[j] + counts[j] <= w.offsets[j] + w.counts[j];
+    for (i = 0; i < static_cast<int>(offsets.size()); ++i) {
+      if (i != j) {
+        hit = hit && w.offsets[i] == offsets[i] && w.counts[i] == counts[i];
+        inner *= counts[i];
+      }
+    }
+
+    if (!hit) {
+      /* read window as one contiguous hyperslab */
+      w.offsets = offsets;
+      w.counts = counts;
+      w.counts[j] = std::max(static_cast<size_t>(end), offsets[j] + counts[j])
+          - offsets[j];
+      w.buf.resize(w.counts[j]*inner*sizeof(T1));
+      if (!w.buf.empty()) {
+        nc_get_vara(ncid, ncVar, w.offsets, w.counts,
+            reinterpret_cast<T1*>(&w.buf[0]));
+      }
+    }
+    if (counts[j]*inner > 0) {
+      memcpy(buf, &w.buf[(offsets[j] - w.offsets[j])*inner*sizeof(T1)],
+          counts[j]*inner*sizeof(T1));
+    }
+  }
+}
+
 template<class M1, class V1>
 void bi::InputNetCDFBuffer::serialiseCoords(const Var* var, const M1 C,
     V1 ixs) {
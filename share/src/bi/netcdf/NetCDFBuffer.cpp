@@ -9,6 +9,8 @@
 
 #include "../misc/assert.hpp"
 
+int bi::NetCDFBuffer::writeDepth = 2;
+
 bi::NetCDFBuffer::NetCDFBuffer(const std::string& file, const FileMode mode) :
     file(file), ncid(-1) {
   BI_ERROR_MSG(!file.empty(), "No file specified");
@@ -27,6 +29,9 @@ bi::NetCDFBuffer::NetCDFBuffer(const std::string& file, const FileMode mode) :
   default:
     ncid = nc_open(file, NC_NOWRITE);
   }
+  if (mode != READ_ONLY && writeDepth > 0) {
+    writer.reset(new NetCDFWriter(ncid, writeDepth));
+  }
 }
 
 bi::NetCDFBuffer::NetCDFBuffer(const NetCDFBuffer& o) :
@@ -37,6 +42,7 @@ bi::NetCDFBuffer::NetCDFBuffer(const NetCDFBuffer& o) :
 }
 
 bi::NetCDFBuffer::~NetCDFBuffer() {
+  writer.reset();
   nc_sync(ncid);
   nc_close(ncid);
 }
@@ -44,3 +50,7 @@ bi::NetCDFBuffer::~NetCDFBuffer() {
 void bi::NetCDFBuffer::clear() {
   //
 }
+
+void bi::NetCDFBuffer::setWriteDepth(const int depth) {
+  writeDepth = depth;
+}
@@ -9,8 +9,11 @@
 #define BI_NETCDF_NETCDFBUFFER_HPP
 
 #include "netcdf.hpp"
+#include "NetCDFWriter.hpp"
 #include "../buffer/buffer.hpp"
 
+#include "boost/shared_ptr.hpp"
+
 namespace bi {
 /**
  * NetCDF input or output file.
@@ -45,7 +48,30 @@ public:
    */
   void clear();
 
+  /**
+   * Set the depth of the write queue for output files subsequently opened.
+   *
+   * @param depth Maximum number of writes queued or in progress for each
+   * file, or zero to write synchronously.
+   */
+  static void setWriteDepth(const int depth);
+
 protected:
+  /**
+   * Write hyperslab of variable, through the write queue if there is one.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param varid Variable id.
+   * @param start Offsets along each dimension.
+   * @param count Counts along each dimension.
+   * @param buf Contiguous data to write. May be reused as soon as the call
+   * returns.
+   */
+  template<class T1>
+  void put(const int varid, const std::vector<size_t>& start,
+      const std::vector<size_t>& count, const T1* buf);
+
   /**
    * NetCDF file name recorded by constructor. Using this is preferred to the
    * nc_inq_path() function, as the latter requires fiddling with buffer
@@ -57,7 +83,27 @@ protected:
    * NetCDF file id.
    */
   int ncid;
+
+  /**
+   * Write queue, null for read only files or synchronous writes.
+   */
+  boost::shared_ptr<NetCDFWriter> writer;
+
+  /**
+   * Depth of write queue.
+   */
+  static int writeDepth;
 };
 }
 
+template<class T1>
+void bi::NetCDFBuffer::put(const int varid, const std::vector<size_t>& start,
+    const std::vector<size_t>& count, const T1* buf) {
+  if (writer.get() != NULL) {
+    writer->put(varid, start, count, buf);
+  } else {
+    nc_put_vara(ncid, varid, start, count, buf);
+  }
+}
+
 #endif
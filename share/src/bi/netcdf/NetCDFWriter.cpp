@@ -0,0 +1,90 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "NetCDFWriter.hpp"
+
+#include "../misc/assert.hpp"
+
+bi::NetCDFWriter::NetCDFWriter(const int ncid, const int depth) :
+    ncid(ncid), depth(depth), pending(0), done(false) {
+  /* pre-condition */
+  BI_ASSERT(depth > 0);
+
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+  int err = pthread_create(&thread, NULL, &run, this);
+  BI_ERROR_MSG(err == 0, "Could not start output thread");
+}
+
+bi::NetCDFWriter::~NetCDFWriter() {
+  pthread_mutex_lock(&mutex);
+  done = true;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+  pthread_join(thread, NULL);
+
+  std::list<Job*>::iterator iter;
+  for (iter = pool.begin(); iter != pool.end(); ++iter) {
+    delete *iter;
+  }
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+bi::NetCDFWriter::Job* bi::NetCDFWriter::acquire() {
+  Job* job;
+
+  pthread_mutex_lock(&mutex);
+  while (pending >= depth) {
+    pthread_cond_wait(&cond, &mutex);
+  }
+  ++pending;
+  if (pool.empty()) {
+    job = new Job();
+  } else {
+    job = pool.front();
+    pool.pop_front();
+  }
+  pthread_mutex_unlock(&mutex);
+
+  return job;
+}
+
+void bi::NetCDFWriter::push(Job* job) {
+  pthread_mutex_lock(&mutex);
+  queue.push_back(job);
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+}
+
+void* bi::NetCDFWriter::run(void* ptr) {
+  static_cast<NetCDFWriter*>(ptr)->loop();
+  return NULL;
+}
+
+void bi::NetCDFWriter::loop() {
+  Job* job;
+
+  pthread_mutex_lock(&mutex);
+  while (!done || !queue.empty()) {
+    if (queue.empty()) {
+      pthread_cond_wait(&cond, &mutex);
+    } else {
+      job = queue.front();
+      queue.pop_front();
+      pthread_mutex_unlock(&mutex);
+
+      job->write(ncid, job);
+
+      pthread_mutex_lock(&mutex);
+      pool.push_back(job);
+      --pending;
+      pthread_cond_broadcast(&cond);
+    }
+  }
+  pthread_mutex_unlock(&mutex);
+}
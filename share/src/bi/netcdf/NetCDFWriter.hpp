@@ -0,0 +1,209 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_NETCDF_NETCDFWRITER_HPP
+#define BI_NETCDF_NETCDFWRITER_HPP
+
+#include "netcdf.hpp"
+
+#include <list>
+#include <vector>
+#include <cstring>
+#include <pthread.h>
+
+namespace bi {
+/**
+ * Background writer for NetCDF output file.
+ *
+ * @ingroup io_netcdf
+ *
+ * Writes are queued with put(), which takes a copy of the data and returns
+ * immediately, while a background thread performs the writes in the order
+ * in which they were queued. Copies are made into buffers that are recycled
+ * once written, so that with the default depth of two the writer is double
+ * buffered: one snapshot may be filled while the other is written. When the
+ * queue is full, put() blocks until a buffer is free.
+ *
+ * Calls to the NetCDF library are serialised internally (see netcdf.hpp),
+ * so that other files may be read and written from the calling thread
+ * while writes are in progress.
+ */
+class NetCDFWriter {
+public:
+  /**
+   * Constructor.
+   *
+   * @param ncid NetCDF file id.
+   * @param depth Maximum number of writes queued or in progress.
+   */
+  NetCDFWriter(const int ncid, const int depth = 2);
+
+  /**
+   * Destructor. Completes outstanding writes.
+   */
+  ~NetCDFWriter();
+
+  /**
+   * Queue write of hyperslab of variable.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param varid Variable id.
+   * @param start Offsets along each dimension.
+   * @param count Counts along each dimension.
+   * @param buf Contiguous data to write. A copy is taken, so that the
+   * buffer may be reused as soon as the call returns.
+   */
+  template<class T1>
+  void put(const int varid, const std::vector<size_t>& start,
+      const std::vector<size_t>& count, const T1* buf);
+
+private:
+  /**
+   * Queued write.
+   */
+  struct Job {
+    /**
+     * Variable id.
+     */
+    int varid;
+
+    /**
+     * Offsets along each dimension.
+     */
+    std::vector<size_t> start;
+
+    /**
+     * Counts along each dimension.
+     */
+    std::vector<size_t> count;
+
+    /**
+     * Copy of data.
+     */
+    std::vector<char> buf;
+
+    /**
+     * Function to perform write, instantiated for the scalar type of the
+     * data.
+     */
+    void (*write)(const int ncid, const Job* job);
+  };
+
+  /**
+   * Write job.
+   *
+   * @tparam T1 Scalar type.
+   */
+  template<class T1>
+  static void write(const int ncid, const Job* job);
+
+  /**
+   * Obtain free job, blocking while the queue is full.
+   */
+  Job* acquire();
+
+  /**
+   * Queue job.
+   */
+  void push(Job* job);
+
+  /**
+   * Thread entry point.
+   */
+  static void* run(void* ptr);
+
+  /**
+   * Thread loop.
+   */
+  void loop();
+
+  /**
+   * Copy constructor, disabled.
+   */
+  NetCDFWriter(const NetCDFWriter& o);
+
+  /**
+   * Assignment operator, disabled.
+   */
+  NetCDFWriter& operator=(const NetCDFWriter& o);
+
+  /**
+   * NetCDF file id.
+   */
+  int ncid;
+
+  /**
+   * Maximum number of writes queued or in progress.
+   */
+  int depth;
+
+  /**
+   * Number of writes queued or in progress.
+   */
+  int pending;
+
+  /**
+   * Queued jobs.
+   */
+  std::list<Job*> queue;
+
+  /**
+   * Free jobs, for reuse of their buffers.
+   */
+  std::list<Job*> pool;
+
+  /**
+   * Stop the thread once the queue is empty?
+   */
+  bool done;
+
+  /**
+   * Background thread.
+   */
+  pthread_t thread;
+
+  /**
+   * Mutex over queue.
+   */
+  pthread_mutex_t mutex;
+
+  /**
+   * Signalled when a job is queued or completed.
+   */
+  pthread_cond_t cond;
+};
+}
+
+template<class T1>
+void bi::NetCDFWriter::put(const int varid, const std::vector<size_t>& start,
+    const std::vector<size_t>& count, const T1* buf) {
+  size_t n = 1;
+  for (int i = 0; i < static_cast<int>(count.size()); ++i) {
+    n *= count[i];
+  }
+
+  Job* job = acquire();
+  job->varid = varid;
+  job->start = start;
+  job->count = count;
+  job->buf.resize(n*sizeof(T1));
+  if (n > 0) {
+    memcpy(&job->buf[0], buf, n*sizeof(T1));
+  }
+  job->write = &write<T1>;
+  push(job);
+}
+
+template<class T1>
+void bi::NetCDFWriter::write(const int ncid, const Job* job) {
+  const T1* buf = job->buf.empty() ? NULL :
+      reinterpret_cast<const T1*>(&job->buf[0]);
+  nc_put_vara(ncid, job->varid, job->start, job->count, buf);
+}
+
+#endif
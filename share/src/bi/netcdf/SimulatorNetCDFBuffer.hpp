@@ -425,9 +425,9 @@ void bi::SimulatorNetCDFBuffer::writeStateVar(const VarType type,
       temp_matrix_type X1(X.size1(), X.size2());
       X1 = X;
       synchronize(M1::on_device);
-      nc_put_vara(ncid, varid, offsets, counts, X1.buf());
+      put(varid, offsets, counts, X1.buf());
     } else {
-      nc_put_vara(ncid, varid, offsets, counts, X.buf());
+      put(varid, offsets, counts, X.buf());
     }
   }
 }
@@ -444,9 +444,9 @@ void bi::SimulatorNetCDFBuffer::writeRange(const int varid, const size_t k,
     temp_vector_type x1(x.size());
     x1 = x;
     synchronize(V1::on_device);
-    nc_put_vara(ncid, varid, start, count, x1.buf());
+    put(varid, start, count, x1.buf());
   } else {
-    nc_put_vara(ncid, varid, start, count, x.buf());
+    put(varid, start, count, x.buf());
   }
 }
 
@@ -465,9 +465,9 @@ void bi::SimulatorNetCDFBuffer::writeVector(const int varid, const size_t k,
     temp_vector_type x1(x.size());
     x1 = x;
     synchronize(V1::on_device);
-    nc_put_vara(ncid, varid, start, count, x1.buf());
+    put(varid, start, count, x1.buf());
   } else {
-    nc_put_vara(ncid, varid, start, count, x.buf());
+    put(varid, start, count, x.buf());
   }
 }
 
@@ -488,9 +488,9 @@ void bi::SimulatorNetCDFBuffer::writeMatrix(const int varid, const size_t k,
     temp_matrix_type X1(X.size1(), X.size2());
     X1 = X;
     synchronize(M1::on_device);
-    nc_put_vara(ncid, varid, start, count, X1.buf());
+    put(varid, start, count, X1.buf());
   } else {
-    nc_put_vara(ncid, varid, start, count, X.buf());
+    put(varid, start, count, X.buf());
   }
 }
 
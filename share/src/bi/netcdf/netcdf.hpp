@@ -13,6 +13,10 @@
  * internally, and
  * @li provide generic or overloaded functions where convenient.
  *
+ * Calls to the library through these functions are serialised with a
+ * mutex, as the library itself is not thread safe. This permits output to be
+ * written from a background thread (see NetCDFWriter).
+ *
  * Note that the older NetCDF C++ Interface does not support certain features
  * of NetCDF 4 that have become necessary in LibBi, while the newer interface
  * represents a significant change that has made it easier to refactor
@@ -20,16 +20,25 @@ namespace bi {
  *
  * @tparam B Model type.
  * @tparam S Action type list.
+ *
+ * Each trajectory resumes from the step size and controller state with
+ * which its last integration by the same block ended, kept in the state
+ * under the index @p k of the block (see State::getStepSize()), rather
+ * than from the initial step size.
+ *
+ * On device, integration always starts from the initial step size.
  */
 template<class B, class S>
 class DOPRI5Integrator {
 public:
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
 
   #ifdef __CUDACC__
   template<class T1>
-  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s,
+      const int k);
   #endif
 };
 
@@ -46,19 +55,19 @@ public:
 template<class B, class S>
 template<class T1>
 void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+    State<B,ON_HOST>& s, const int k) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
   if (bi::abs(t2 - t1) > 0.0) {
     #ifdef ENABLE_SSE
     if (s.size() % BI_SIMD_SIZE == 0) {
-      DOPRI5IntegratorSSE<B,S,T1>::update(t1, t2, s);
+      DOPRI5IntegratorSSE<B,S,T1>::update(t1, t2, s, k);
     } else {
-      DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s);
+      DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s, k);
     }
     #else
-    DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s);
+    DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s, k);
     #endif
   }
 }
@@ -67,7 +76,7 @@ void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
 template<class B, class S>
 template<class T1>
 void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
-    State<B,ON_DEVICE>& s) {
+    State<B,ON_DEVICE>& s, const int k) {
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
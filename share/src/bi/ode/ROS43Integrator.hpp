@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROS43INTEGRATOR_HPP
+#define BI_ODE_ROS43INTEGRATOR_HPP
+
+#include "../misc/location.hpp"
+#include "../state/State.hpp"
+
+namespace bi {
+/**
+ * Update using Rosenbrock 4(3) linearly implicit integrator with adaptive
+ * step-size control, for stiff systems.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ *
+ * Requires the Jacobian of each action of @p S, as generated for an
+ * <tt>ode</tt> block with <tt>alg = 'ROS4(3)'</tt>. Not available on
+ * device.
+ *
+ * Each trajectory resumes from the step size with which its last
+ * integration by the same block ended, kept in the state under the index
+ * @p k of the block (see State::getStepSize()), rather than from the
+ * initial step size.
+ */
+template<class B, class S>
+class ROS43Integrator {
+public:
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
+
+  #ifdef __CUDACC__
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s,
+      const int k);
+  #endif
+};
+
+}
+
+#include "../host/ode/ROS43IntegratorHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/ode/ROS43IntegratorSSE.hpp"
+#endif
+
+template<class B, class S>
+template<class T1>
+void bi::ROS43Integrator<B,S>::update(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s, const int k) {
+  /* pre-conditions */
+  BI_ASSERT(t1 <= t2);
+
+  if (bi::abs(t2 - t1) > 0.0) {
+    #ifdef ENABLE_SSE
+    if (s.size() % BI_SIMD_SIZE == 0) {
+      ROS43IntegratorSSE<B,S,T1>::update(t1, t2, s, k);
+    } else {
+      ROS43IntegratorHost<B,S,T1>::update(t1, t2, s, k);
+    }
+    #else
+    ROS43IntegratorHost<B,S,T1>::update(t1, t2, s, k);
+    #endif
+  }
+}
+
+#ifdef __CUDACC__
+template<class B, class S>
+template<class T1>
+void bi::ROS43Integrator<B,S>::update(const T1 t1, const T1 t2,
+    State<B,ON_DEVICE>& s, const int k) {
+  BI_ERROR_MSG(false, "ROS4(3) integrator is not available on device, use --disable-cuda");
+}
+#endif
+
+#endif
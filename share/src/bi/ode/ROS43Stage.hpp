@@ -0,0 +1,47 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROS43STAGE_HPP
+#define BI_ODE_ROS43STAGE_HPP
+
+#include "../cuda/cuda.hpp"
+
+namespace bi {
+/**
+ * Stage calculations for ROS43Integrator.
+ *
+ * @tparam X Node type.
+ * @tparam S Action type list of the whole system.
+ * @tparam T1 Scalar type.
+ * @tparam B Model type.
+ * @tparam L Location.
+ * @tparam CX Coordinates type.
+ * @tparam PX Parents type.
+ * @tparam T2 Scalar type.
+ */
+template<class X, class S, class T1, class B, Location L, class CX, class PX, class T2>
+class ROS43Stage {
+public:
+  /**
+   * Time derivative.
+   */
+  static CUDA_FUNC_BOTH void dfdt(const T1 t, const State<B,L>& s, const int p, const CX& cox, const PX& pax, T2& f) {
+    X::dfdt(t, s, p, cox, pax, f);
+  }
+
+  /**
+   * Row of Jacobian, added to @p J, where @p J points to the first element
+   * of the row in a column-major matrix with leading dimension @p ld.
+   */
+  static CUDA_FUNC_BOTH void jacobian(const T1 t, const State<B,L>& s, const int p, const CX& cox, const PX& pax, T2* J, const int ld) {
+    X::template jacobian<S>(t, s, p, cox, pax, J, ld);
+  }
+};
+
+}
+
+#endif
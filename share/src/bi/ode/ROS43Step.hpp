@@ -0,0 +1,133 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROS43STEP_HPP
+#define BI_ODE_ROS43STEP_HPP
+
+#include "../cuda/cuda.hpp"
+
+namespace bi {
+/**
+ * Element-wise calculations between the linear solves of ROS43Integrator.
+ *
+ * @tparam T1 Scalar type.
+ * @tparam T2 Scalar type.
+ *
+ * Coefficients are those of @ref Shampine1982 "Shampine (1982)", as given
+ * in @ref Press1992 "Press et al. (1992)". For each stage @c i, @c g_i
+ * solves @f$(I/(\gamma h) - J)g_i = r_i@f$, where @f$J@f$ is the Jacobian at
+ * the start of the step and @f$r_i@f$ the right-hand side computed here.
+ * The time derivative of the system, @f$\partial f/\partial t@f$, is taken
+ * to be zero.
+ */
+template<class T1, class T2>
+class ROS43Step {
+public:
+  /**
+   * Diagonal shift @f$1/(\gamma h)@f$.
+   */
+  static CUDA_FUNC_BOTH T1 shift(const T1 h) {
+    const real gam = BI_REAL(0.5);
+
+    return BI_REAL(1.0)/(gam*h);
+  }
+
+  /**
+   * Time of second stage.
+   */
+  static CUDA_FUNC_BOTH T1 time2(const T1 t, const T1 h) {
+    const real a2x = BI_REAL(1.0);
+
+    return t + a2x*h;
+  }
+
+  /**
+   * Time of third stage.
+   */
+  static CUDA_FUNC_BOTH T1 time3(const T1 t, const T1 h) {
+    const real a3x = BI_REAL(3.0/5.0);
+
+    return t + a3x*h;
+  }
+
+  /**
+   * State at second stage.
+   */
+  static CUDA_FUNC_BOTH void state2(const T2 y0, const T2 g1, T2& y) {
+    const real a21 = BI_REAL(2.0);
+
+    y = y0 + a21*g1;
+  }
+
+  /**
+   * State at third stage.
+   */
+  static CUDA_FUNC_BOTH void state3(const T2 y0, const T2 g1, const T2 g2,
+      T2& y) {
+    const real a31 = BI_REAL(48.0/25.0);
+    const real a32 = BI_REAL(6.0/25.0);
+
+    y = y0 + a31*g1 + a32*g2;
+  }
+
+  /**
+   * Right-hand side of second stage, from time derivative @p f at second
+   * stage.
+   */
+  static CUDA_FUNC_BOTH void rhs2(const T1 h, const T2 f, const T2 g1,
+      T2& g2) {
+    const real c21 = BI_REAL(-8.0);
+
+    g2 = f + (c21/h)*g1;
+  }
+
+  /**
+   * Right-hand side of third stage, from time derivative @p f at third
+   * stage.
+   */
+  static CUDA_FUNC_BOTH void rhs3(const T1 h, const T2 f, const T2 g1,
+      const T2 g2, T2& g3) {
+    const real c31 = BI_REAL(372.0/25.0);
+    const real c32 = BI_REAL(12.0/5.0);
+
+    g3 = f + (c31*g1 + c32*g2)/h;
+  }
+
+  /**
+   * Right-hand side of fourth stage, from time derivative @p f at third
+   * stage.
+   */
+  static CUDA_FUNC_BOTH void rhs4(const T1 h, const T2 f, const T2 g1,
+      const T2 g2, const T2 g3, T2& g4) {
+    const real c41 = BI_REAL(-112.0/125.0);
+    const real c42 = BI_REAL(-54.0/125.0);
+    const real c43 = BI_REAL(-2.0/5.0);
+
+    g4 = f + (c41*g1 + c42*g2 + c43*g3)/h;
+  }
+
+  /**
+   * State at end of step, and error estimate.
+   */
+  static CUDA_FUNC_BOTH void finish(const T2 y0, const T2 g1, const T2 g2,
+      const T2 g3, const T2 g4, T2& y, T2& err) {
+    const real b1 = BI_REAL(19.0/9.0);
+    const real b2 = BI_REAL(1.0/2.0);
+    const real b3 = BI_REAL(25.0/108.0);
+    const real b4 = BI_REAL(125.0/108.0);
+    const real e1 = BI_REAL(17.0/54.0);
+    const real e2 = BI_REAL(7.0/36.0);
+    const real e4 = BI_REAL(125.0/108.0);
+
+    y = y0 + b1*g1 + b2*g2 + b3*g3 + b4*g4;
+    err = e1*g1 + e2*g2 + e4*g4;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file
+ *
+ * Model-independent parts of the library used by client programs. When
+ * enabled (see the <tt>--enable-pch</tt> build option), this header is
+ * precompiled once per build directory and included ahead of every C++
+ * translation unit, so that Thrust, Boost and the templates of the library
+ * are parsed once rather than once per client program.
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_PCH_HPP
+#define BI_PCH_HPP
+
+#include "model/Model.hpp"
+#include "typelist/macro_typelist.hpp"
+#include "typelist/macro_typetree.hpp"
+
+#include "misc/TicToc.hpp"
+#include "ode/IntegratorConstants.hpp"
+#include "random/Random.hpp"
+#include "math/view.hpp"
+#include "math/operation.hpp"
+#include "primitive/vector_primitive.hpp"
+#include "primitive/matrix_primitive.hpp"
+#include "pdf/misc.hpp"
+#include "kd/kde.hpp"
+
+#include "state/State.hpp"
+#include "state/MarginalMHState.hpp"
+#include "state/MarginalSIRState.hpp"
+#include "state/MarginalSISState.hpp"
+#include "state/OptimiserState.hpp"
+
+#include "buffer/SimulatorBuffer.hpp"
+#include "buffer/ParticleFilterBuffer.hpp"
+#include "buffer/KalmanFilterBuffer.hpp"
+#include "buffer/MCMCBuffer.hpp"
+#include "buffer/SMCBuffer.hpp"
+#include "buffer/SRSBuffer.hpp"
+
+#include "cache/SimulatorCache.hpp"
+#include "cache/AncestryCache.hpp"
+#include "cache/AdaptivePFCache.hpp"
+#include "cache/BootstrapPFCache.hpp"
+#include "cache/ExtendedKFCache.hpp"
+#include "cache/MCMCCache.hpp"
+#include "cache/SMCCache.hpp"
+#include "cache/SRSCache.hpp"
+
+#include "netcdf/InputNetCDFBuffer.hpp"
+#include "netcdf/SimulatorNetCDFBuffer.hpp"
+#include "netcdf/ParticleFilterNetCDFBuffer.hpp"
+#include "netcdf/KalmanFilterNetCDFBuffer.hpp"
+#include "netcdf/MCMCNetCDFBuffer.hpp"
+#include "netcdf/SMCNetCDFBuffer.hpp"
+#include "netcdf/OptimiserNetCDFBuffer.hpp"
+
+#include "null/InputNullBuffer.hpp"
+#include "null/SimulatorNullBuffer.hpp"
+#include "null/ParticleFilterNullBuffer.hpp"
+#include "null/KalmanFilterNullBuffer.hpp"
+#include "null/MCMCNullBuffer.hpp"
+#include "null/SMCNullBuffer.hpp"
+#include "null/OptimiserNullBuffer.hpp"
+
+#include "simulator/ForcerFactory.hpp"
+#include "simulator/ObserverFactory.hpp"
+#include "simulator/SimulatorFactory.hpp"
+#include "adapter/AdapterFactory.hpp"
+#include "filter/FilterFactory.hpp"
+#include "sampler/SamplerFactory.hpp"
+#include "resampler/ResamplerFactory.hpp"
+#include "stopper/StopperFactory.hpp"
+#include "optimiser/NelderMeadOptimiser.hpp"
+
+#ifdef ENABLE_MPI
+#include "mpi/adapter/DistributedAdapterFactory.hpp"
+#include "mpi/resampler/DistributedResamplerFactory.hpp"
+#include "mpi/stopper/DistributedStopperFactory.hpp"
+#endif
+
+#include "boost/typeof/typeof.hpp"
+
+#endif
@@ -32,7 +32,7 @@ struct gamma_log_density_functor: public std::unary_function<T,T> {
 
   CUDA_FUNC_BOTH
   T operator()(const T& x) const {
-    return (alpha - static_cast<T>(1.0)) * bi::log(x) - x / beta - logZ;
+    return (alpha - BI_REAL(1.0)) * bi::log(x) - x / beta - logZ;
   }
 };
 
@@ -16,8 +16,12 @@ namespace bi {
  * of SIMD vectors.
  *
  * @ingroup primitive_allocator
+ *
+ * @tparam T Value type.
+ * @tparam X Alignment, in bytes. The default of 64 suits the widest
+ * (AVX-512) SIMD vectors, and is also the cache line size.
  */
-template <class T, unsigned X = 32>
+template <class T, unsigned X = 64>
 class aligned_allocator {
 public:
   typedef size_t size_type;
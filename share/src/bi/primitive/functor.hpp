@@ -13,9 +13,11 @@
 #include "../math/function.hpp"
 #include "../math/scalar.hpp"
 #include "../math/misc.hpp"
+#include "../math/constant.hpp"
 #include "../cuda/cuda.hpp"
 
 #include "thrust/pair.h"
+#include "thrust/tuple.h"
 
 namespace bi {
 /**
@@ -659,6 +661,55 @@ struct ess_functor : public std::binary_function<thrust::pair<T,T>,thrust::pair<
   }
 };
 
+/**
+ * @ingroup primitive_functor
+ *
+ * Maps log-weight \f$x\f$ to the triple \f$(x,1,1)\f$ of maximum, sum of
+ * weights and sum of squared weights, the latter two relative to the
+ * maximum, for reduction with logweight_functor. NaN and \f$-\infty\f$ give
+ * zero weight.
+ */
+template<class T>
+struct nan_logweight_functor : public std::unary_function<T,thrust::tuple<T,T,T> > {
+  CUDA_FUNC_BOTH thrust::tuple<T,T,T> operator()(const T& x) const {
+    if (bi::isnan(x) || x == -BI_INF) {
+      return thrust::make_tuple(static_cast<T>(-BI_INF), static_cast<T>(0),
+          static_cast<T>(0));
+    } else {
+      return thrust::make_tuple(x, static_cast<T>(1), static_cast<T>(1));
+    }
+  }
+};
+
+/**
+ * @ingroup primitive_functor
+ *
+ * Combines two triples of maximum, sum of weights and sum of squared
+ * weights, rescaling the sums of the triple with the smaller maximum
+ * (online log-sum-exp).
+ */
+template<class T>
+struct logweight_functor : public std::binary_function<thrust::tuple<T,T,T>,thrust::tuple<T,T,T>,thrust::tuple<T,T,T> > {
+  CUDA_FUNC_BOTH thrust::tuple<T,T,T> operator()(
+      const thrust::tuple<T,T,T>& x, const thrust::tuple<T,T,T>& y) const {
+    if (thrust::get<1>(y) == static_cast<T>(0)) {
+      return x;
+    } else if (thrust::get<1>(x) == static_cast<T>(0)) {
+      return y;
+    } else if (thrust::get<0>(x) >= thrust::get<0>(y)) {
+      T z = bi::exp(thrust::get<0>(y) - thrust::get<0>(x));
+      return thrust::make_tuple(thrust::get<0>(x),
+          thrust::get<1>(x) + z*thrust::get<1>(y),
+          thrust::get<2>(x) + z*z*thrust::get<2>(y));
+    } else {
+      T z = bi::exp(thrust::get<0>(x) - thrust::get<0>(y));
+      return thrust::make_tuple(thrust::get<0>(y),
+          z*thrust::get<1>(x) + thrust::get<1>(y),
+          z*z*thrust::get<2>(x) + thrust::get<2>(y));
+    }
+  }
+};
+
 }
 
 #endif
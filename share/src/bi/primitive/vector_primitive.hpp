@@ -15,6 +15,7 @@
 #define BI_PRIMITIVE_VECTORPRIMITIVE_HPP
 
 #include "functor.hpp"
+#include "../misc/location.hpp"
 
 #include "thrust/functional.h"
 
@@ -195,6 +196,40 @@ typename V1::value_type sumexpsq_reduce(const V1 x);
 template<class V1>
 typename V1::value_type ess_reduce(const V1 lws, double* lW = NULL);
 
+/**
+ * Fused reduction of log-weights.
+ *
+ * @ingroup primitive_vector
+ *
+ * @param lws \f$\log \mathbf{w}\f$; log-weights.
+ * @param[out] mx If given, contains the maximum log-weight on exit.
+ * @param[out] lW If given, contains the logarithm of the sum of weights on
+ * exit.
+ * @param[out] lW2 If given, contains the logarithm of the sum of squared
+ * weights on exit.
+ *
+ * @return Effective sample size computed from given weights.
+ *
+ * Computes all of the above in a single pass over @p lws, maintaining a
+ * running maximum and rescaling partial sums whenever it increases. NaN
+ * values do not contribute. sumexp_reduce(), logsumexp_reduce(),
+ * sumexpsq_reduce() and ess_reduce() are implemented with this, but callers
+ * needing more than one of these should call it directly.
+ */
+template<class V1>
+typename V1::value_type logweight_reduce(const V1 lws, double* mx = NULL,
+    double* lW = NULL, double* lW2 = NULL);
+
+/**
+ * @internal
+ */
+template<Location L>
+struct logweight_reduce_impl {
+  template<class V1>
+  static void func(const V1 lws, typename V1::value_type& mx,
+      typename V1::value_type& W, typename V1::value_type& W2);
+};
+
 /**
  * Compute conditional acceptance rate as in
  * @ref Murray2013 "Murray, Jones & Parslow (2013)".
@@ -785,6 +820,7 @@ bool equal(const V1 input1, const V1 input2);
 }
 
 #include "../math/sim_temp_vector.hpp"
+#include "../host/primitive/vector_primitive.hpp"
 
 #include "thrust/extrema.h"
 #include "thrust/transform_reduce.h"
@@ -919,43 +955,26 @@ inline typename V1::value_type bi::amax_reduce(const V1 x) {
 
 template<class V1>
 inline typename V1::value_type bi::sumexp_reduce(const V1 x) {
-  typedef typename V1::value_type T1;
+  double lW;
+  logweight_reduce(x, NULL, &lW);
 
-  T1 mx = max_reduce(x);
-  T1 result = bi::exp(
-      mx
-          + bi::log(
-              op_reduce(x, nan_minus_and_exp_functor<T1>(mx), 0.0,
-                  thrust::plus<T1>())));
-
-  return result;
+  return bi::exp(lW);
 }
 
 template<class V1>
 inline typename V1::value_type bi::logsumexp_reduce(const V1 x) {
-  typedef typename V1::value_type T1;
-
-  T1 mx = max_reduce(x);
-  T1 result = mx
-      + bi::log(
-          op_reduce(x, nan_minus_and_exp_functor<T1>(mx), 0.0,
-              thrust::plus<T1>()));
+  double lW;
+  logweight_reduce(x, NULL, &lW);
 
-  return result;
+  return lW;
 }
 
 template<class V1>
 inline typename V1::value_type bi::sumexpsq_reduce(const V1 x) {
-  typedef typename V1::value_type T1;
-
-  T1 mx = max_reduce(x);
-  T1 result = bi::exp(
-      2.0 * mx
-          + bi::log(
-              op_reduce(x, nan_minus_exp_and_square_functor<T1>(mx), 0.0,
-                  thrust::plus<T1>())));
+  double lW2;
+  logweight_reduce(x, NULL, NULL, &lW2);
 
-  return result;
+  return bi::exp(lW2);
 }
 
 template<class V1>
@@ -963,16 +982,51 @@ typename V1::value_type bi::ess_reduce(const V1 lws, double* lW) {
   /* pre-condition */
   BI_ASSERT(lws.size() > 0);
 
+  typename V1::value_type ess = logweight_reduce(lws, NULL, lW);
+  if (lW != NULL) {
+    *lW -= bi::log(double(lws.size()));
+  }
+  return ess;
+}
+
+template<class V1>
+typename V1::value_type bi::logweight_reduce(const V1 lws, double* mx,
+    double* lW, double* lW2) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() > 0);
+
   typedef typename V1::value_type T1;
 
-  T1 mx = max_reduce(lws);
-  thrust::pair<T1,T1> sum(0, 0);
-  sum = op_reduce(lws, nan_minus_and_exp_ess_functor<T1>(mx), sum,
-      ess_functor<T1>());
+  T1 mx1, W, W2;
+  logweight_reduce_impl<V1::location>::func(lws, mx1, W, W2);
+
+  if (mx != NULL) {
+    *mx = mx1;
+  }
   if (lW != NULL) {
-    *lW = mx + bi::log(sum.first) - bi::log(double(lws.size()));
+    *lW = mx1 + bi::log(W);
   }
-  return sum.first * sum.first / sum.second;
+  if (lW2 != NULL) {
+    *lW2 = 2.0*mx1 + bi::log(W2);
+  }
+  return W*W/W2;
+}
+
+template<bi::Location L>
+template<class V1>
+void bi::logweight_reduce_impl<L>::func(const V1 lws,
+    typename V1::value_type& mx, typename V1::value_type& W,
+    typename V1::value_type& W2) {
+  typedef typename V1::value_type T1;
+
+  const T1 inf = BI_INF;
+  thrust::tuple<T1,T1,T1> init(-inf, 0, 0), sum;
+  sum = op_reduce(lws, nan_logweight_functor<T1>(), init,
+      logweight_functor<T1>());
+
+  mx = thrust::get<0>(sum);
+  W = thrust::get<1>(sum);
+  W2 = thrust::get<2>(sum);
 }
 
 template<class V1>
@@ -41,7 +41,10 @@ namespace bi {
  * #getDevRng and copied into it, then variates generated from the local
  * variable before it is copied back to global memory with #setDevRng.
  *
- * Internally, the plural methods take this approach.
+ * Internally, the plural methods take this approach on device. On host, they
+ * instead use the counter-based generator PhiloxHost, with one stream per
+ * call, so that vectors are filled in parallel and the output does not
+ * depend on the number of threads.
  */
 class Random {
 public:
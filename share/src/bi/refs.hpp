@@ -103,10 +103,25 @@
  * filtering within adaptive Metropolis-Hastings sampling, <b>2010</b>.
  * http://arxiv.org/abs/1006.1914
  *
+ * @anchor Press1992
+ * Press, W. H.; Teukolsky, S. A.; Vetterling, W. T. & Flannery, B. P.
+ * <i>Numerical Recipes in C: The Art of Scientific Computing</i>. Second
+ * edition. Cambridge University Press, <b>1992</b>.
+ *
+ * @anchor Salmon2011
+ * Salmon, J. K.; Moraes, M. A.; Dror, R. O. & Shaw, D. E. Parallel Random
+ * Numbers: As Easy as 1, 2, 3. <i>Proceedings of the International
+ * Conference for High Performance Computing, Networking, Storage and
+ * Analysis</i>, <b>2011</b>.
+ *
  * @anchor Sarkka2008
  * Särkkä, S. Unscented Rauch-Tung-Striebel Smoother. <i>IEEE Transactions on
  * Automated Control</i>, <b>2008</b>, 53, 845-849.
  *
+ * @anchor Shampine1982
+ * Shampine, L. F. Implementation of Rosenbrock methods. <i>ACM Transactions
+ * on Mathematical Software</i>, <b>1982</b>, 8, 93-113.
+ *
  * @anchor Silverman1986
  * Silverman, B.W. <i>Density Estimation for Statistics and Data
  * Analysis</i>. Chapman and Hall, <b>1986</b>.
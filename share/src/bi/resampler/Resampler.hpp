@@ -15,6 +15,12 @@
 #include "../misc/exception.hpp"
 #include "../misc/location.hpp"
 #include "../traits/resampler_traits.hpp"
+#include "../math/loc_temp_vector.hpp"
+#include "../misc/omp.hpp"
+
+#include "boost/mpl/bool.hpp"
+
+#include <vector>
 
 namespace bi {
 /**
@@ -25,6 +31,25 @@ struct ResamplerPrecompute {
   //
 };
 
+/**
+ * Workspace for Resampler, reused between calls to avoid reallocation.
+ *
+ * @tparam R Base resampler type.
+ * @tparam L Location.
+ */
+template<class R, Location L>
+struct ResamplerWorkspace {
+  /**
+   * Precomputed results.
+   */
+  typename precompute_type<R,L>::type pre;
+
+  /**
+   * Ancestors.
+   */
+  typename loc_temp_vector<L,int>::type as;
+};
+
 /**
  * %Resampler for particle filter.
  *
@@ -75,6 +100,19 @@ public:
   template<class V1>
   double reduce(const V1 lws, double* lW);
 
+  /**
+   * Compute ESS and incremental log-likelihood from sums of weights, such
+   * as those combined from partial reductions over subsets of particles.
+   *
+   * @param P Number of particles.
+   * @param lW1 Logarithm of sum of weights.
+   * @param lW2 Logarithm of sum of squared weights.
+   * @param[out] lW Incremental log-likelihood.
+   *
+   * @return ESS.
+   */
+  double reduce(const int P, const double lW1, const double lW2, double* lW);
+
   /**
    * Resample.
    *
@@ -100,9 +138,55 @@ public:
    */
   template<class S1>
   void shuffle(Random& rng, S1& s);
+
+  /**
+   * Number of particles ready for use after #resample.
+   *
+   * @tparam S1 State type.
+   *
+   * @param s State.
+   *
+   * Resamplers that leave transfers of particles in flight on return from
+   * #resample (see DistributedResampler) place the particles still to
+   * arrive at the back. Only the particles before the returned index may be
+   * used until #complete is called.
+   */
+  template<class S1>
+  int ready(const S1& s) const;
+
+  /**
+   * Complete any transfers of particles left in flight by #resample.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void complete(S1& s);
   //@}
 
 protected:
+  /**
+   * Get workspace on host for the current thread.
+   */
+  ResamplerWorkspace<R,ON_HOST>& workspace(const boost::mpl::false_);
+
+  /**
+   * Get workspace on device for the current thread.
+   */
+  ResamplerWorkspace<R,ON_DEVICE>& workspace(const boost::mpl::true_);
+
+  /**
+   * Workspaces on host, one per thread, so that several filters may
+   * resample concurrently (see MarginalSIR::move()).
+   */
+  std::vector<ResamplerWorkspace<R,ON_HOST> > hostWork;
+
+  /**
+   * Workspaces on device, one per thread.
+   */
+  std::vector<ResamplerWorkspace<R,ON_DEVICE> > deviceWork;
+
   /**
    * Relative ESS threshold.
    */
@@ -127,7 +211,9 @@ protected:
 
 template<class R>
 inline bi::Resampler<R>::Resampler(const double essRel, const bool anytime) :
-    essRel(essRel), maxLogWeight(0.0), anytime(anytime) {
+    hostWork(bi::max(bi_omp_max_threads, 1)),
+    deviceWork(bi::max(bi_omp_max_threads, 1)), essRel(essRel),
+    maxLogWeight(0.0), anytime(anytime) {
   /* pre-condition */
   BI_ASSERT(essRel >= 0.0 && essRel <= 1.0);
 
@@ -157,12 +243,20 @@ void bi::Resampler<R>::setMaxLogWeight(const double maxLogWeight) {
 template<class R>
 template<class V1>
 double bi::Resampler<R>::reduce(const V1 lws, double* lW) {
-  double ess = ess_reduce(lws, lW);
+  double lW1, lW2;
+  logweight_reduce(lws, NULL, &lW1, &lW2);
+
+  return reduce(lws.size(), lW1, lW2, lW);
+}
+
+template<class R>
+double bi::Resampler<R>::reduce(const int P, const double lW1,
+    const double lW2, double* lW) {
+  *lW = lW1 - bi::log(double(P));
   if (anytime) {
-    const int P = lws.size();
     *lW += bi::log(P / (P - 1.0));
   }
-  return ess;
+  return bi::exp(2.0*lW1 - lW2);
 }
 
 template<class R>
@@ -171,13 +265,14 @@ bool bi::Resampler<R>::resample(Random& rng, const ScheduleElement now, S1& s)
     throw (ParticleFilterDegeneratedException) {
   bool r = (now.isObserved() || now.hasBridge()) && s.ess < essRel * s.size();
   if (r) {
-    typename precompute_type<R,S1::temp_int_vector_type::location>::type pre;
-    typename S1::temp_int_vector_type as1(s.size());
+    ResamplerWorkspace<R,S1::location>& work = workspace(
+        boost::mpl::bool_<S1::on_device>());
+    work.as.resize(s.size(), false);
 
-    R::precompute(s.logWeights(), pre);
-    R::ancestorsPermute(rng, s.logWeights(), as1, pre);
+    R::precompute(s.logWeights(), work.pre);
+    R::ancestorsPermute(rng, s.logWeights(), work.as, work.pre);
 
-    s.gather(now, as1);
+    s.gather(now, work.as);
     set_elements(s.logWeights(), s.logLikelihood);
   } else if (now.hasOutput()) {
     seq_elements(s.ancestors(), 0);
@@ -185,6 +280,18 @@ bool bi::Resampler<R>::resample(Random& rng, const ScheduleElement now, S1& s)
   return r;
 }
 
+template<class R>
+inline bi::ResamplerWorkspace<R,bi::ON_HOST>& bi::Resampler<R>::workspace(
+    const boost::mpl::false_) {
+  return hostWork[bi_omp_tid];
+}
+
+template<class R>
+inline bi::ResamplerWorkspace<R,bi::ON_DEVICE>& bi::Resampler<R>::workspace(
+    const boost::mpl::true_) {
+  return deviceWork[bi_omp_tid];
+}
+
 template<class R>
 template<class S1>
 void bi::Resampler<R>::shuffle(Random& rng, S1& s) {
@@ -198,4 +305,16 @@ void bi::Resampler<R>::shuffle(Random& rng, S1& s) {
   }
 }
 
+template<class R>
+template<class S1>
+inline int bi::Resampler<R>::ready(const S1& s) const {
+  return s.size();
+}
+
+template<class R>
+template<class S1>
+inline void bi::Resampler<R>::complete(S1& s) {
+  //
+}
+
 #endif
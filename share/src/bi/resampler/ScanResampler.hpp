@@ -16,6 +16,12 @@ template<Location L>
 struct ScanResamplerPrecompute {
   typename loc_temp_vector<L,real>::type Ws;
   real W;
+
+  /**
+   * Workspace for cumulative offspring, sized by precompute() and reused
+   * between calls.
+   */
+  typename loc_temp_vector<L,int>::type Os;
 };
 
 /**
@@ -30,15 +36,35 @@ public:
    */
   template<class V1, Location L>
   void precompute(const V1 lws, ScanResamplerPrecompute<L>& pre);
+
+  /**
+   * @copydoc Resampler::precompute
+   *
+   * On host, the prefix sum is computed in parallel.
+   */
+  template<class V1>
+  void precompute(const V1 lws, ScanResamplerPrecompute<ON_HOST>& pre);
 };
 }
 
+#include "../host/resampler/ResamplerHost.hpp"
+
 template<class V1, bi::Location L>
 void bi::ScanResampler::precompute(const V1 lws,
     ScanResamplerPrecompute<L>& pre) {
   pre.Ws.resize(lws.size(), false);
+  pre.Os.resize(lws.size(), false);
   sumexpu_inclusive_scan(lws, pre.Ws);
   pre.W = *(pre.Ws.end() - 1);  // sum of weights
 }
 
+template<class V1>
+void bi::ScanResampler::precompute(const V1 lws,
+    ScanResamplerPrecompute<ON_HOST>& pre) {
+  pre.Ws.resize(lws.size(), false);
+  pre.Os.resize(lws.size(), false);
+  ResamplerHost::sumexpuInclusiveScan(lws, pre.Ws);
+  pre.W = *(pre.Ws.end() - 1);  // sum of weights
+}
+
 #endif
@@ -116,20 +116,16 @@ template<class V1, class V2, bi::Location L>
 void bi::StratifiedResampler::ancestors(Random& rng, const V1 lws, V2 as,
     ScanResamplerPrecompute<L>& pre)
         throw (ParticleFilterDegeneratedException) {
-  typename sim_temp_vector<V2>::type Os(lws.size());
-
-  cumulativeOffspring(rng, lws, as.size(), Os, pre);
-  cumulativeOffspringToAncestors(Os, as);
+  cumulativeOffspring(rng, lws, as.size(), pre.Os, pre);
+  cumulativeOffspringToAncestors(pre.Os, as);
 }
 
 template<class V1, class V2, bi::Location L>
 void bi::StratifiedResampler::ancestorsPermute(Random& rng, const V1 lws,
     V2 as, ScanResamplerPrecompute<L>& pre)
         throw (ParticleFilterDegeneratedException) {
-  typename sim_temp_vector<V2>::type Os(lws.size());
-
-  cumulativeOffspring(rng, lws, as.size(), Os, pre);
-  cumulativeOffspringToAncestorsPermute(Os, as);
+  cumulativeOffspring(rng, lws, as.size(), pre.Os, pre);
+  cumulativeOffspringToAncestorsPermute(pre.Os, as);
 }
 
 template<class V1, class V2, bi::Location L>
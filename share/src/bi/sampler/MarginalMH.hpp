@@ -10,6 +10,8 @@
 
 #include "../state/Schedule.hpp"
 #include "../misc/exception.hpp"
+#include "../misc/omp.hpp"
+#include "../traits/filter_traits.hpp"
 
 namespace bi {
 /**
@@ -24,6 +26,24 @@ namespace bi {
  * with a particle filter, gives the particle marginal Metropolis--Hastings
  * sampler described in @ref Andrieu2010 "Andrieu, Doucet \& Holenstein (2010)".
  *
+ * If the state holds more than one chain, the chains are advanced in
+ * lockstep, and sample @c c of chain @c i is output at index
+ * <tt>c*N + i</tt>, where @c N is the number of chains. When the filter is
+ * reentrant (see filter_is_reentrant) and too small to keep all threads
+ * busy, the chains are advanced concurrently, one per thread, each filter
+ * running on a team of one thread. Otherwise the chains are advanced one at
+ * a time, with the threads shared by the filter.
+ *
+ * With early rejection enabled, the uniform variate of the accept/reject
+ * step is drawn before the proposal is filtered, and converted to a
+ * threshold on its log-likelihood. The filter stops at the first
+ * observation at which the log-likelihood so far, plus an upper bound on
+ * the increment at each remaining observation, cannot reach the threshold,
+ * as the proposal would certainly be rejected. The decision is the same as
+ * without early rejection, provided that the bound holds. There is no safe
+ * default for the bound, so early rejection takes effect only when a finite
+ * bound is given.
+ *
  * @todo Add proposal adaptation using adapter classes.
  */
 template<class B, class F>
@@ -34,8 +54,13 @@ public:
    *
    * @param m Model.
    * @param filter Filter.
+   * @param earlyReject Enable early rejection?
+   * @param bound Upper bound on the log-likelihood increment at each
+   * observation, for early rejection. Early rejection is disabled if this
+   * is not finite.
    */
-  MarginalMH(B& m, F& filter);
+  MarginalMH(B& m, F& filter, const bool earlyReject = false,
+      const double bound = BI_INF);
 
   /**
    * @name High-level interface
@@ -101,10 +126,13 @@ public:
    * @param[in,out] s1 Current state.
    * @param[out] s2 Proposed state.
    * @param[in,out] out Output buffer.
+   * @param logu Logarithm of the uniform variate for the accept/reject
+   * step, if drawn in advance for early rejection.
    */
   template<class S1, class S2, class IO1>
   void propose(Random& rng, const ScheduleIterator first,
-      const ScheduleIterator last, S1& s1, S2& s2, IO1& out);
+      const ScheduleIterator last, S1& s1, S2& s2, IO1& out,
+      const double logu = -BI_INF);
 
   /**
    * Accept or reject proposed state.
@@ -160,6 +188,78 @@ public:
   //@}
 
 private:
+  /**
+   * Sample with multiple chains.
+   *
+   * @copydetails sample()
+   */
+  template<class S1, class IO1, class IO2>
+  void sampleChains(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out,
+      IO2& inInit);
+
+  /**
+   * Advance one chain by one step.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s1 Current state.
+   * @param[in,out] s2 Proposed state.
+   * @param[in,out] out Filter output.
+   *
+   * @return Was proposal accepted?
+   *
+   * Unlike acceptReject(), does not update the acceptance counts, so that
+   * it may be called for several chains concurrently.
+   */
+  template<class S1, class IO1>
+  bool move(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s1, S1& s2, IO1& out);
+
+  /**
+   * Accept or reject proposed state, without side effects.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param s1 Current state.
+   * @param s2 Proposed state.
+   *
+   * @return Should proposal be accepted?
+   */
+  template<class S1, class S2>
+  bool accept(Random& rng, const S1& s1, const S2& s2);
+
+  /**
+   * Accept or reject proposed state, given uniform variate.
+   *
+   * @param s1 Current state.
+   * @param s2 Proposed state.
+   * @param logu Logarithm of uniform variate.
+   *
+   * @return Should proposal be accepted?
+   */
+  template<class S1, class S2>
+  bool accept(const S1& s1, const S2& s2, const double logu);
+
+  /**
+   * Advance chains concurrently?
+   *
+   * @tparam S1 State type.
+   *
+   * @param s State.
+   */
+  template<class S1>
+  bool concurrent(const S1& s) const;
+
+  /**
+   * Minimum number of \f$x\f$-particles per thread for the filter to use
+   * all threads. Below this, chains are advanced concurrently instead.
+   */
+  static const int MIN_PARTICLES_PER_THREAD = 1024;
+
   /**
    * Model.
    */
@@ -170,6 +270,17 @@ private:
    */
   F& filter;
 
+  /**
+   * Early rejection enabled?
+   */
+  bool earlyReject;
+
+  /**
+   * Upper bound on log-likelihood increment at each observation, for early
+   * rejection.
+   */
+  double bound;
+
   /**
    * Was the last proposal accepted?
    */
@@ -190,8 +301,10 @@ private:
 #include "../misc/TicToc.hpp"
 
 template<class B, class F>
-bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter) :
-    m(m), filter(filter), lastAccepted(false), accepted(0), total(0) {
+bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter, const bool earlyReject,
+    const double bound) :
+    m(m), filter(filter), earlyReject(earlyReject && bi::is_finite(bound)),
+    bound(bound), lastAccepted(false), accepted(0), total(0) {
   //
 }
 
@@ -202,12 +315,20 @@ void bi::MarginalMH<B,F>::sample(Random& rng, const ScheduleIterator first,
   /* pre-condition */
   BI_ERROR(C > 0);
 
+  if (s.numChains() > 1) {
+    sampleChains(rng, first, last, s, C, out, inInit);
+    return;
+  }
+
   TicToc clock;
   init(rng, first, last, s.s1, s.out, inInit);
   output(0, s.s1, out);
   for (int c = 1; c < C; ++c) {
-    propose(rng, first, last, s.s1, s.s2, s.out);
-    acceptReject(rng, s.s1, s.s2, s.out);
+    lastAccepted = move(rng, first, last, s.s1, s.s2, s.out);
+    if (lastAccepted) {
+      ++accepted;
+    }
+    ++total;
     report(c, s.s1, s.s2);
     output(c, s.s1, out);
   }
@@ -231,13 +352,21 @@ void bi::MarginalMH<B,F>::init(Random& rng, const ScheduleIterator first,
 template<class B, class F>
 template<class S1, class S2, class IO1>
 void bi::MarginalMH<B,F>::propose(Random& rng, const ScheduleIterator first,
-    const ScheduleIterator last, S1& s1, S2& s2, IO1& out) {
+    const ScheduleIterator last, S1& s1, S2& s2, IO1& out,
+    const double logu) {
   try {
     filter.propose(rng, *first, s1, s2, out);
-    if (bi::is_finite(s2.logPrior)) {
-      filter.filter(rng, first, last, s2, out);
-    } else {
+    if (!bi::is_finite(s2.logPrior)) {
       s2.logLikelihood = -BI_INF;
+    } else if (earlyReject && bi::is_finite(logu)
+        && bi::is_finite(s1.logLikelihood)) {
+      double logpr = s2.logPrior - s1.logPrior;
+      double logqr = s1.logProposal - s2.logProposal;
+      double threshold = s1.logLikelihood + logu - logpr - logqr;
+
+      filter.filter(rng, first, last, s2, out, threshold, bound);
+    } else {
+      filter.filter(rng, first, last, s2, out);
     }
   } catch (CholeskyException e) {
     s2.logLikelihood = -BI_INF;
@@ -249,20 +378,7 @@ void bi::MarginalMH<B,F>::propose(Random& rng, const ScheduleIterator first,
 template<class B, class F>
 template<class S1, class S2, class IO1>
 bool bi::MarginalMH<B,F>::acceptReject(Random& rng, S1& s1, S2& s2, IO1& out) {
-  if (!bi::is_finite(s2.logLikelihood)) {
-    lastAccepted = false;
-  } else if (!bi::is_finite(s1.logLikelihood)) {
-    lastAccepted = true;
-  } else {
-    double loglr = s2.logLikelihood - s1.logLikelihood;
-    double logpr = s2.logPrior - s1.logPrior;
-    double logqr = s1.logProposal - s2.logProposal;
-    double logratio = loglr + logpr + logqr;
-    double u = rng.uniform<double>();
-
-    lastAccepted = bi::log(u) < logratio;
-  }
-
+  lastAccepted = accept(rng, s1, s2);
   if (lastAccepted) {
     filter.samplePath(rng, s2, out);
     s2.swap(s1);
@@ -323,4 +439,109 @@ void bi::MarginalMH<B,F>::term() {
   //
 }
 
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::MarginalMH<B,F>::sampleChains(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  TicToc clock;
+  const int N = s.numChains();
+  int c, i, naccept;
+
+  /* initialise serially, which also fills input and observation caches
+   * before they are shared between threads */
+  for (i = 0; i < N; ++i) {
+    init(rng, first, last, s.current(i), s.output(i), inInit);
+    output(i, s.current(i), out);
+  }
+  accepted = N;
+  total = N;
+
+  for (c = 1; c < C; ++c) {
+    naccept = 0;
+    if (concurrent(s)) {
+      #pragma omp parallel for schedule(static) reduction(+:naccept)
+      for (i = 0; i < N; ++i) {
+        naccept += move(rng, first, last, s.current(i), s.proposed(i),
+            s.output(i)) ? 1 : 0;
+      }
+    } else {
+      for (i = 0; i < N; ++i) {
+        naccept += move(rng, first, last, s.current(i), s.proposed(i),
+            s.output(i)) ? 1 : 0;
+      }
+    }
+    accepted += naccept;
+    total += N;
+
+    std::cerr << c << ":\taccepts " << naccept << '/' << N;
+    std::cerr << "\taccept=" << (double)accepted / total;
+    std::cerr << std::endl;
+
+    for (i = 0; i < N; ++i) {
+      output(c*N + i, s.current(i), out);
+    }
+  }
+  s.clock = clock.toc();
+  outputT(s, out);
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+bool bi::MarginalMH<B,F>::move(Random& rng, const ScheduleIterator first,
+    const ScheduleIterator last, S1& s1, S1& s2, IO1& out) {
+  bool result;
+  if (earlyReject) {
+    double logu = bi::log(rng.uniform<double>());
+    propose(rng, first, last, s1, s2, out, logu);
+    result = accept(s1, s2, logu);
+  } else {
+    propose(rng, first, last, s1, s2, out);
+    result = accept(rng, s1, s2);
+  }
+  if (result) {
+    filter.samplePath(rng, s2, out);
+    s2.swap(s1);
+  }
+  return result;
+}
+
+template<class B, class F>
+template<class S1, class S2>
+bool bi::MarginalMH<B,F>::accept(Random& rng, const S1& s1, const S2& s2) {
+  if (!bi::is_finite(s2.logLikelihood) || !bi::is_finite(s1.logLikelihood)) {
+    return accept(s1, s2, 0.0);
+  } else {
+    double u = rng.uniform<double>();
+    return accept(s1, s2, bi::log(u));
+  }
+}
+
+template<class B, class F>
+template<class S1, class S2>
+bool bi::MarginalMH<B,F>::accept(const S1& s1, const S2& s2,
+    const double logu) {
+  if (!bi::is_finite(s2.logLikelihood)) {
+    return false;
+  } else if (!bi::is_finite(s1.logLikelihood)) {
+    return true;
+  } else {
+    double loglr = s2.logLikelihood - s1.logLikelihood;
+    double logpr = s2.logPrior - s1.logPrior;
+    double logqr = s1.logProposal - s2.logProposal;
+    double logratio = loglr + logpr + logqr;
+
+    return logu < logratio;
+  }
+}
+
+template<class B, class F>
+template<class S1>
+bool bi::MarginalMH<B,F>::concurrent(const S1& s) const {
+  return filter_is_reentrant<F>::value && !s.s1.on_device
+      && bi_omp_max_threads > 1
+      && s.s1.size() < MIN_PARTICLES_PER_THREAD*bi_omp_max_threads;
+}
+
 #endif
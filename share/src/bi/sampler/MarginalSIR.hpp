@@ -13,6 +13,11 @@
 #include "../misc/exception.hpp"
 #include "../misc/TicToc.hpp"
 #include "../primitive/vector_primitive.hpp"
+#include "../traits/filter_traits.hpp"
+#include "../misc/omp.hpp"
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
 
 #include <fstream>
 #include <sstream>
@@ -31,6 +36,15 @@ namespace bi {
  * Implements sequential importance resampling over parameters, which, when
  * combined with a particle filter, gives the SMC^2 method described in
  * @ref Chopin2013 "Chopin, Jacob \& Papaspiliopoulos (2013)".
+ *
+ * When there is no time budget for moves, the filter is reentrant (see
+ * filter_is_reentrant), and the \f$x\f$-particle filter is too small to
+ * keep all threads busy, the \f$\theta\f$-particles are moved
+ * concurrently, one per thread, with each filter running on a team of one
+ * thread. Each thread uses its own proposal state and output from the
+ * MarginalSIRState, and its own random number stream. Otherwise the
+ * \f$\theta\f$-particles are moved one at a time, with the threads
+ * shared by the filter.
  */
 template<class B, class F, class A, class R>
 class MarginalSIR {
@@ -178,6 +192,45 @@ private:
    */
   void profile(const Step step);
 
+  /**
+   * Move \f$\theta\f$-particles concurrently?
+   *
+   * @tparam S1 State type.
+   *
+   * @param s State.
+   */
+  template<class S1>
+  bool concurrent(const S1& s) const;
+
+  /**
+   * Make PMMH moves for one \f$\theta\f$-particle.
+   *
+   * @tparam S2 Filter state type.
+   * @tparam IO2 Filter output type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param iter Current position in time schedule.
+   * @param[in,out] s1 \f$\theta\f$-particle.
+   * @param[in,out] out1 Output of \f$\theta\f$-particle.
+   * @param[in,out] s2 Proposal state.
+   * @param[in,out] out2 Proposal output.
+   * @param[in,out] ntotal Total number of moves, incremented.
+   *
+   * @return Number of acceptances.
+   */
+  template<class S2, class IO2>
+  int moveParticle(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator iter, S2& s1, IO2& out1, S2& s2, IO2& out2,
+      int& ntotal);
+
+  /**
+   * Minimum number of \f$x\f$-particles per thread for the filter to use
+   * all threads. Below this, \f$\theta\f$-particles are moved
+   * concurrently instead.
+   */
+  static const int MIN_PARTICLES_PER_THREAD = 1024;
+
 #if ENABLE_DIAGNOSTICS == 4
   /**
    * Log file.
@@ -249,6 +302,18 @@ private:
    * Last total number of moves.
    */
   int lastTotal;
+
+#ifdef ENABLE_MPI
+  /**
+   * Reduction of the statistics of each step across processes.
+   */
+  StepReduction red;
+
+  /**
+   * Reduction of the moments for the adapter across processes.
+   */
+  StepReduction adapterRed;
+#endif
 };
 }
 
@@ -373,25 +438,50 @@ template<class B, class F, class A, class R>
 template<class S1>
 void bi::MarginalSIR<B,F,A,R>::interact(Random& rng,
     const ScheduleElement now, S1& s) {
-#ifdef ENABLE_MPI
-  /* reporting requirements */
-  boost::mpi::communicator world;
-  int naccept = lastAccept, ntotal = lastTotal;
-  boost::mpi::reduce(world, naccept, lastAccept, std::plus<int>(), 0);
-  boost::mpi::reduce(world, ntotal, lastTotal, std::plus<int>(), 0);
-#endif
-
   /* marginal likelihood */
   double lW;
+#ifdef ENABLE_MPI
+  /* counts for reporting and weights for the marginal likelihood are
+   * reduced across processes in one collective */
+  red.clear();
+  const int iaccept = red.addSum(lastAccept);
+  const int itotal = red.addSum(lastTotal);
+  resam.contribute(s.logWeights(), red);
+  red.reduce();
+  lastAccept = (int)red.getSum(iaccept);
+  lastTotal = (int)red.getSum(itotal);
+  s.ess = resam.reduce(red, &lW);
+#else
   s.ess = resam.reduce(s.logWeights(), &lW);
+#endif
   s.logIncrements(now.indexObs()) = lW - s.logLikelihood;
   s.logLikelihood = lW;
 
+#ifdef ENABLE_MPI
+  /* moments for the adapter are computed only if it can use them, and
+   * reduced while resampling proceeds, as the ESS is the same on all
+   * processes, and resampling neither changes it nor needs the proposal */
+  const bool adapting = adapter.ready(s, red);
+  if (adapting) {
+    adapterRed.clear();
+    adapterRed.logWeights(s.logWeights());
+    adapter.contribute(s, adapterRed);
+    adapterRed.start();
+  }
+  lastResample = resam.resample(rng, now, s);
+  if (adapting) {
+    adapterRed.finish();
+    adapterReady = adapter.adapt(s, adapterRed);
+  } else {
+    adapterReady = false;
+  }
+#else
   /* adapt proposal */
   adapterReady = adapter.adapt(s);
 
   /* resample */
   lastResample = resam.resample(rng, now, s);
+#endif
 }
 
 template<class B, class F, class A, class R>
@@ -411,69 +501,52 @@ void bi::MarginalSIR<B,F,A,R>::move(Random& rng, const ScheduleIterator first,
     int ntotal = 0;
     int j = 0;
     int p = 0;
-    bool accept = false;
     bool complete = (tmoves <= 0 && p >= s.size())
         || (tmoves > 0 && clock.toc() >= tmilestone);
 
-    if (tmoves > 0) {
+    /* particles still arriving from other processes after resampling are at
+     * the back, the others are moved while they are in transit */
+    const int P1 = resam.ready(s);
+
+    if (concurrent(s)) {
+      /* first move serially, so that input and observation caches are
+       * complete before they are shared between threads */
+      if (P1 == 0) {
+        resam.complete(s);
+      }
+      naccept += moveParticle(rng, first, iter, *s.s1s[0], *s.out1s[0], s.s2,
+          s.out2, ntotal);
+
+      s.reserveProposals(bi_omp_max_threads);
+      #pragma omp parallel for schedule(static) reduction(+:naccept,ntotal)
+      for (p = 1; p < P1; ++p) {
+        naccept += moveParticle(rng, first, iter, *s.s1s[p], *s.out1s[p],
+            s.proposal(bi_omp_tid), s.proposalOutput(bi_omp_tid), ntotal);
+      }
+      resam.complete(s);
+      #pragma omp parallel for schedule(static) reduction(+:naccept,ntotal)
+      for (p = bi::max(P1, 1); p < s.size(); ++p) {
+        naccept += moveParticle(rng, first, iter, *s.s1s[p], *s.out1s[p],
+            s.proposal(bi_omp_tid), s.proposalOutput(bi_omp_tid), ntotal);
+      }
+      complete = true;
+    } else if (tmoves > 0) {
       /* serial schedule, but random order */
+      resam.complete(s);
       resam.shuffle(rng, s);
     }
     while (!complete) {
       j = p % s.size();
-      BOOST_AUTO(&s1, *s.s1s[j]);
-      BOOST_AUTO(&out1, *s.out1s[j]);
-      BOOST_AUTO(&s2, s.s2);
-      BOOST_AUTO(&out2, s.out2);
-
-      for (int move = 0; move < nmoves; ++move) {
-        /* propose replacement */
-        try {
-          if (adapterReady) {
-            filter.propose(rng, *first, s1, s2, out2, adapter);
-          } else {
-            filter.propose(rng, *first, s1, s2, out2);
-          }
-          if (tmoves > 0) {
-            filter.filter(rng, first, iter + 1, s2, out2, clock, tmilestone);
-          } else {
-            filter.filter(rng, first, iter + 1, s2, out2);
-          }
-        } catch (CholeskyException e) {
-          s2.logLikelihood = -BI_INF;
-        } catch (ParticleFilterDegeneratedException e) {
-          s2.logLikelihood = -BI_INF;
-        }
-        if (tmoves <= 0 || clock.toc() < tmilestone) {
-          /* accept or reject */
-          if (!bi::is_finite(s2.logLikelihood)) {
-            accept = false;
-          } else if (!bi::is_finite(s1.logLikelihood)) {
-            accept = true;
-          } else {
-            double loglr = s2.logLikelihood - s1.logLikelihood;
-            double logpr = s2.logPrior - s1.logPrior;
-            double logqr = s1.logProposal - s2.logProposal;
-            double logratio = loglr + logpr + logqr;
-            double u = rng.uniform<double>();
-
-            accept = bi::log(u) < logratio;
-          }
-          if (accept) {
-  #if ENABLE_DIAGNOSTICS == 3
-            filter.samplePath(rng, s2, out2);
-  #endif
-            s1.swap(s2);
-            out1.swap(out2);
-            ++naccept;
-          }
-          ++ntotal;
-        }
+      if (j == P1) {
+        resam.complete(s);
       }
+      naccept += moveParticle(rng, first, iter, *s.s1s[j], *s.out1s[j], s.s2,
+          s.out2, ntotal);
       ++p;
       complete = (tmoves <= 0 && p >= s.size())
           || (tmoves > 0 && clock.toc() >= tmilestone);
     }
+    resam.complete(s);
 
     if (tmoves > 0) {
       /* eliminate active particle, note Resampler and DistributedResampler
@@ -540,6 +613,70 @@ void bi::MarginalSIR<B,F,A,R>::term(Random& rng, S1& s) {
   }
 }
 
+template<class B, class F, class A, class R>
+template<class S1>
+bool bi::MarginalSIR<B,F,A,R>::concurrent(const S1& s) const {
+  return tmoves <= 0 && filter_is_reentrant<F>::value && !s.s2.on_device
+      && bi_omp_max_threads > 1 && s.size() > 1
+      && s.s2.size() < MIN_PARTICLES_PER_THREAD*bi_omp_max_threads;
+}
+
+template<class B, class F, class A, class R>
+template<class S2, class IO2>
+int bi::MarginalSIR<B,F,A,R>::moveParticle(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator iter, S2& s1,
+    IO2& out1, S2& s2, IO2& out2, int& ntotal) {
+  int naccept = 0;
+  bool accept = false;
+
+  for (int move = 0; move < nmoves; ++move) {
+    /* propose replacement */
+    try {
+      if (adapterReady) {
+        filter.propose(rng, *first, s1, s2, out2, adapter);
+      } else {
+        filter.propose(rng, *first, s1, s2, out2);
+      }
+      if (tmoves > 0) {
+        filter.filter(rng, first, iter + 1, s2, out2, clock, tmilestone);
+      } else {
+        filter.filter(rng, first, iter + 1, s2, out2);
+      }
+    } catch (CholeskyException e) {
+      s2.logLikelihood = -BI_INF;
+    } catch (ParticleFilterDegeneratedException e) {
+      s2.logLikelihood = -BI_INF;
+    }
+    if (tmoves <= 0 || clock.toc() < tmilestone) {
+      /* accept or reject */
+      if (!bi::is_finite(s2.logLikelihood)) {
+        accept = false;
+      } else if (!bi::is_finite(s1.logLikelihood)) {
+        accept = true;
+      } else {
+        double loglr = s2.logLikelihood - s1.logLikelihood;
+        double logpr = s2.logPrior - s1.logPrior;
+        double logqr = s1.logProposal - s2.logProposal;
+        double logratio = loglr + logpr + logqr;
+        double u = rng.uniform<double>();
+
+        accept = bi::log(u) < logratio;
+      }
+      if (accept) {
+#if ENABLE_DIAGNOSTICS == 3
+        filter.samplePath(rng, s2, out2);
+#endif
+        s1.swap(s2);
+        out1.swap(out2);
+        ++naccept;
+      }
+      ++ntotal;
+    }
+  }
+
+  return naccept;
+}
+
 template<class B, class F, class A, class R>
 void bi::MarginalSIR<B,F,A,R>::profile(const Step step) {
   if (step == INIT) {
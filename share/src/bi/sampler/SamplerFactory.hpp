@@ -27,7 +27,7 @@ public:
    */
   template<class B, class F>
   static boost::shared_ptr<MarginalMH<B,F> > createMarginalMH(B& m,
-      F& filter);
+      F& filter, const bool earlyReject = false, const double bound = BI_INF);
 
   /**
    * Create marginal sequential importance resampling sampler.
@@ -48,9 +48,9 @@ public:
 
 template<class B, class F>
 boost::shared_ptr<bi::MarginalMH<B,F> > bi::SamplerFactory::createMarginalMH(
-    B& m, F& filter) {
+    B& m, F& filter, const bool earlyReject, const double bound) {
   return boost::shared_ptr < MarginalMH<B,F>
-      > (new MarginalMH<B,F>(m, filter));
+      > (new MarginalMH<B,F>(m, filter, earlyReject, bound));
 }
 
 template<class B, class F, class A, class R>
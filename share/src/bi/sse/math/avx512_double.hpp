@@ -0,0 +1,469 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_MATH_AVX512DOUBLE_HPP
+#define BI_SSE_MATH_AVX512DOUBLE_HPP
+
+#include "avx_double.hpp"
+
+#include <immintrin.h>
+
+/**
+ * @def BI_AVX512DOUBLE_UNIVARIATE
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512DOUBLE_UNIVARIATE(func, x) \
+    avx512_double res; \
+    res.unpacked.a = bi::func(x.unpacked.a); \
+    res.unpacked.b = bi::func(x.unpacked.b); \
+    return res;
+
+/**
+ * @def BI_AVX512DOUBLE_BIVARIATE
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512DOUBLE_BIVARIATE(func, x1, x2) \
+    avx512_double res; \
+    res.unpacked.a = bi::func(x1.unpacked.a, x2.unpacked.a); \
+    res.unpacked.b = bi::func(x1.unpacked.b, x2.unpacked.b); \
+    return res;
+
+/**
+ * @def BI_AVX512DOUBLE_BIVARIATE_LEFT
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512DOUBLE_BIVARIATE_REAL_RIGHT(func, x1, x2) \
+    avx512_double res; \
+    res.unpacked.a = bi::func(x1.unpacked.a, x2); \
+    res.unpacked.b = bi::func(x1.unpacked.b, x2); \
+    return res;
+
+/**
+ * @def BI_AVX512DOUBLE_BIVARIATE_REAL_LEFT
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512DOUBLE_BIVARIATE_REAL_LEFT(func, x1, x2) \
+    avx512_double res; \
+    res.unpacked.a = bi::func(x1, x2.unpacked.a); \
+    res.unpacked.b = bi::func(x1, x2.unpacked.b); \
+    return res;
+
+namespace bi {
+/**
+ * 512-bit SIMD vector of doubles.
+ */
+union avx512_double {
+  struct {
+    avx_double a, b;
+  } unpacked;
+  __m512d packed;
+
+  avx512_double& operator=(const double& o) {
+    packed = _mm512_set1_pd(o);
+    return *this;
+  }
+};
+
+/**
+ * Expand mask register to vector with all bits of each selected element
+ * set, as produced by comparisons on other SIMD types.
+ */
+BI_FORCE_INLINE inline avx512_double avx512_double_expand(const __mmask8 k) {
+  avx512_double res;
+  res.packed = _mm512_castsi512_pd(_mm512_maskz_set1_epi64(k, -1));
+  return res;
+}
+
+/**
+ * Compress vector produced by a comparison to mask register.
+ */
+BI_FORCE_INLINE inline __mmask8 avx512_double_compress(const avx512_double x) {
+  const __m512i bits = _mm512_castpd_si512(x.packed);
+  return _mm512_test_epi64_mask(bits, bits);
+}
+
+BI_FORCE_INLINE inline avx512_double& operator+=(avx512_double& o1,
+    const avx512_double& o2) {
+  o1.packed = _mm512_add_pd(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator-=(avx512_double& o1,
+    const avx512_double& o2) {
+  o1.packed = _mm512_sub_pd(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator*=(avx512_double& o1,
+    const avx512_double& o2) {
+  o1.packed = _mm512_mul_pd(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator/=(avx512_double& o1,
+    const avx512_double& o2) {
+  o1.packed = _mm512_div_pd(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator+=(avx512_double& o1,
+    const double& o2) {
+  o1.packed = _mm512_add_pd(o1.packed, _mm512_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator-=(avx512_double& o1,
+    const double& o2) {
+  o1.packed = _mm512_sub_pd(o1.packed, _mm512_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator*=(avx512_double& o1,
+    const double& o2) {
+  o1.packed = _mm512_mul_pd(o1.packed, _mm512_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double& operator/=(avx512_double& o1,
+    const double& o2) {
+  o1.packed = _mm512_div_pd(o1.packed, _mm512_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_double operator+(const avx512_double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_add_pd(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator-(const avx512_double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_sub_pd(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator*(const avx512_double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_mul_pd(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator/(const avx512_double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_div_pd(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator+(const double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_add_pd(_mm512_set1_pd(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator-(const double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_sub_pd(_mm512_set1_pd(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator*(const double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_mul_pd(_mm512_set1_pd(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator/(const double& o1,
+    const avx512_double& o2) {
+  avx512_double res;
+  res.packed = _mm512_div_pd(_mm512_set1_pd(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator+(const avx512_double& o1,
+    const double& o2) {
+  avx512_double res;
+  res.packed = _mm512_add_pd(o1.packed, _mm512_set1_pd(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator-(const avx512_double& o1,
+    const double& o2) {
+  avx512_double res;
+  res.packed = _mm512_sub_pd(o1.packed, _mm512_set1_pd(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator*(const avx512_double& o1,
+    const double& o2) {
+  avx512_double res;
+  res.packed = _mm512_mul_pd(o1.packed, _mm512_set1_pd(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator/(const avx512_double& o1,
+    const double& o2) {
+  avx512_double res;
+  res.packed = _mm512_div_pd(o1.packed, _mm512_set1_pd(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double operator==(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_EQ_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_double operator!=(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_NEQ_UQ));
+}
+
+BI_FORCE_INLINE inline avx512_double operator<(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_LT_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_double operator<=(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_LE_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_double operator>(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_GT_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_double operator>=(const avx512_double& o1,
+    const avx512_double& o2) {
+  return avx512_double_expand(_mm512_cmp_pd_mask(o1.packed, o2.packed,
+      _CMP_GE_OQ));
+}
+
+BI_FORCE_INLINE inline const avx512_double operator-(const avx512_double& o) {
+  avx512_double res;
+  res.packed = _mm512_castsi512_pd(_mm512_xor_si512(
+      _mm512_castpd_si512(_mm512_set1_pd(-0.0)),
+      _mm512_castpd_si512(o.packed)));
+  return res;
+}
+
+BI_FORCE_INLINE inline const avx512_double operator+(const avx512_double& o) {
+  return o;
+}
+
+BI_FORCE_INLINE inline avx512_double abs(const avx512_double x) {
+  avx512_double res;
+  res.packed = _mm512_abs_pd(x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double select(const avx512_double mask,
+    const avx512_double x, const avx512_double y) {
+  avx512_double res;
+  res.packed = _mm512_mask_blend_pd(avx512_double_compress(mask), y.packed,
+      x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const avx512_double mask) {
+  return avx512_double_compress(mask) != 0;
+}
+
+BI_FORCE_INLINE inline avx512_double exp2i(const avx512_double n) {
+  avx512_double res;
+  res.packed = _mm512_scalef_pd(_mm512_set1_pd(1.0), n.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double frexp(const avx512_double x,
+    avx512_double& e) {
+  /* getexp gives the exponent for a mantissa in [1,2), so add one */
+  e.packed = _mm512_add_pd(_mm512_getexp_pd(x.packed), _mm512_set1_pd(1.0));
+
+  avx512_double res;
+  res.packed = _mm512_getmant_pd(x.packed, _MM_MANT_NORM_p5_1,
+      _MM_MANT_SIGN_src);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double mul_err(const avx512_double x,
+    const avx512_double y, const avx512_double p) {
+  avx512_double res;
+  res.packed = _mm512_fmsub_pd(x.packed, y.packed, p.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double log(const avx512_double x) {
+  return simd_transcendental<double>::log(x);
+}
+
+BI_FORCE_INLINE inline avx512_double nanlog(const avx512_double x) {
+  return select(x != x,
+      simd_splat<avx512_double>(-std::numeric_limits<double>::infinity()),
+      log(x));
+}
+
+BI_FORCE_INLINE inline avx512_double log1p(const avx512_double x) {
+  return simd_log1p<avx512_double,double>(x);
+}
+
+BI_FORCE_INLINE inline avx512_double exp(const avx512_double x) {
+  return simd_transcendental<double>::exp(x);
+}
+
+BI_FORCE_INLINE inline avx512_double nanexp(const avx512_double x) {
+  return select(x != x, simd_splat<avx512_double>(static_cast<double>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline avx512_double expm1(const avx512_double x) {
+  return simd_expm1<avx512_double,double>(x);
+}
+
+BI_FORCE_INLINE inline avx512_double max(const avx512_double x,
+    const avx512_double y) {
+  avx512_double res;
+  res.packed = _mm512_max_pd(x.packed, y.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double min(const avx512_double x,
+    const avx512_double y) {
+  avx512_double res;
+  res.packed = _mm512_min_pd(x.packed, y.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double sqrt(const avx512_double x) {
+  avx512_double res;
+  res.packed = _mm512_sqrt_pd(x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_double pow(const avx512_double x,
+    const avx512_double y) {
+  if (any(simd_pow_special<avx512_double,double>(x, y))) {
+    BI_AVX512DOUBLE_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<avx512_double,double>(x, y);
+  }
+}
+
+BI_FORCE_INLINE inline avx512_double pow(const avx512_double x,
+    const double y) {
+  return pow(x, simd_splat<avx512_double>(y));
+}
+
+BI_FORCE_INLINE inline avx512_double pow(const double x,
+    const avx512_double y) {
+  return pow(simd_splat<avx512_double>(x), y);
+}
+
+BI_FORCE_INLINE inline avx512_double mod(const avx512_double x,
+    const avx512_double y) {
+  BI_AVX512DOUBLE_BIVARIATE(mod, x, y)
+}
+
+BI_FORCE_INLINE inline avx512_double ceil(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(ceil, x)
+}
+
+BI_FORCE_INLINE inline avx512_double floor(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(floor, x)
+}
+
+BI_FORCE_INLINE inline avx512_double gamma(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(gamma, x)
+}
+
+BI_FORCE_INLINE inline avx512_double lgamma(const avx512_double x) {
+  if (any(simd_lgamma_special<avx512_double,double>(x))) {
+    BI_AVX512DOUBLE_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<avx512_double,double>(x);
+  }
+}
+
+BI_FORCE_INLINE inline avx512_double sin(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(sin, x)
+}
+
+BI_FORCE_INLINE inline avx512_double cos(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(cos, x)
+}
+
+BI_FORCE_INLINE inline avx512_double tan(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(tan, x)
+}
+
+BI_FORCE_INLINE inline avx512_double asin(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(asin, x)
+}
+
+BI_FORCE_INLINE inline avx512_double acos(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(acos, x)
+}
+
+BI_FORCE_INLINE inline avx512_double atan(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(atan, x)
+}
+
+BI_FORCE_INLINE inline avx512_double atan2(const avx512_double x,
+    const avx512_double y) {
+  BI_AVX512DOUBLE_BIVARIATE(atan2, x, y)
+}
+
+BI_FORCE_INLINE inline avx512_double sinh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(sinh, x)
+}
+
+BI_FORCE_INLINE inline avx512_double cosh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(cosh, x)
+}
+
+BI_FORCE_INLINE inline avx512_double tanh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(tanh, x)
+}
+
+BI_FORCE_INLINE inline avx512_double asinh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(asinh, x)
+}
+
+BI_FORCE_INLINE inline avx512_double acosh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(acosh, x)
+}
+
+BI_FORCE_INLINE inline avx512_double atanh(const avx512_double x) {
+  BI_AVX512DOUBLE_UNIVARIATE(atanh, x)
+}
+
+BI_FORCE_INLINE inline double max_reduce(const avx512_double x) {
+  return bi::max(bi::max_reduce(x.unpacked.a), bi::max_reduce(x.unpacked.b));
+}
+
+}
+
+#endif
@@ -0,0 +1,469 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_MATH_AVX512FLOAT_HPP
+#define BI_SSE_MATH_AVX512FLOAT_HPP
+
+#include "avx_float.hpp"
+
+#include <immintrin.h>
+
+/**
+ * @def BI_AVX512FLOAT_UNIVARIATE
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512FLOAT_UNIVARIATE(func, x) \
+    avx512_float res; \
+    res.unpacked.a = bi::func(x.unpacked.a); \
+    res.unpacked.b = bi::func(x.unpacked.b); \
+    return res;
+
+/**
+ * @def BI_AVX512FLOAT_BIVARIATE
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512FLOAT_BIVARIATE(func, x1, x2) \
+    avx512_float res; \
+    res.unpacked.a = bi::func(x1.unpacked.a, x2.unpacked.a); \
+    res.unpacked.b = bi::func(x1.unpacked.b, x2.unpacked.b); \
+    return res;
+
+/**
+ * @def BI_AVX512FLOAT_BIVARIATE_LEFT
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512FLOAT_BIVARIATE_REAL_RIGHT(func, x1, x2) \
+    avx512_float res; \
+    res.unpacked.a = bi::func(x1.unpacked.a, x2); \
+    res.unpacked.b = bi::func(x1.unpacked.b, x2); \
+    return res;
+
+/**
+ * @def BI_AVX512FLOAT_BIVARIATE_REAL_LEFT
+ *
+ * Macro for creating AVX-512 math functions that must operate on individual
+ * elements.
+ */
+#define BI_AVX512FLOAT_BIVARIATE_REAL_LEFT(func, x1, x2) \
+    avx512_float res; \
+    res.unpacked.a = bi::func(x1, x2.unpacked.a); \
+    res.unpacked.b = bi::func(x1, x2.unpacked.b); \
+    return res;
+
+namespace bi {
+/**
+ * 512-bit SIMD vector of floats.
+ */
+union avx512_float {
+  struct {
+    avx_float a, b;
+  } unpacked;
+  __m512 packed;
+
+  avx512_float& operator=(const float& o) {
+    packed = _mm512_set1_ps(o);
+    return *this;
+  }
+};
+
+/**
+ * Expand mask register to vector with all bits of each selected element
+ * set, as produced by comparisons on other SIMD types.
+ */
+BI_FORCE_INLINE inline avx512_float avx512_float_expand(const __mmask16 k) {
+  avx512_float res;
+  res.packed = _mm512_castsi512_ps(_mm512_maskz_set1_epi32(k, -1));
+  return res;
+}
+
+/**
+ * Compress vector produced by a comparison to mask register.
+ */
+BI_FORCE_INLINE inline __mmask16 avx512_float_compress(const avx512_float x) {
+  const __m512i bits = _mm512_castps_si512(x.packed);
+  return _mm512_test_epi32_mask(bits, bits);
+}
+
+BI_FORCE_INLINE inline avx512_float& operator+=(avx512_float& o1,
+    const avx512_float& o2) {
+  o1.packed = _mm512_add_ps(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator-=(avx512_float& o1,
+    const avx512_float& o2) {
+  o1.packed = _mm512_sub_ps(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator*=(avx512_float& o1,
+    const avx512_float& o2) {
+  o1.packed = _mm512_mul_ps(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator/=(avx512_float& o1,
+    const avx512_float& o2) {
+  o1.packed = _mm512_div_ps(o1.packed, o2.packed);
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator+=(avx512_float& o1,
+    const float& o2) {
+  o1.packed = _mm512_add_ps(o1.packed, _mm512_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator-=(avx512_float& o1,
+    const float& o2) {
+  o1.packed = _mm512_sub_ps(o1.packed, _mm512_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator*=(avx512_float& o1,
+    const float& o2) {
+  o1.packed = _mm512_mul_ps(o1.packed, _mm512_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float& operator/=(avx512_float& o1,
+    const float& o2) {
+  o1.packed = _mm512_div_ps(o1.packed, _mm512_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx512_float operator+(const avx512_float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_add_ps(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator-(const avx512_float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_sub_ps(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator*(const avx512_float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_mul_ps(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator/(const avx512_float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_div_ps(o1.packed, o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator+(const float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_add_ps(_mm512_set1_ps(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator-(const float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_sub_ps(_mm512_set1_ps(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator*(const float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_mul_ps(_mm512_set1_ps(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator/(const float& o1,
+    const avx512_float& o2) {
+  avx512_float res;
+  res.packed = _mm512_div_ps(_mm512_set1_ps(o1), o2.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator+(const avx512_float& o1,
+    const float& o2) {
+  avx512_float res;
+  res.packed = _mm512_add_ps(o1.packed, _mm512_set1_ps(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator-(const avx512_float& o1,
+    const float& o2) {
+  avx512_float res;
+  res.packed = _mm512_sub_ps(o1.packed, _mm512_set1_ps(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator*(const avx512_float& o1,
+    const float& o2) {
+  avx512_float res;
+  res.packed = _mm512_mul_ps(o1.packed, _mm512_set1_ps(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator/(const avx512_float& o1,
+    const float& o2) {
+  avx512_float res;
+  res.packed = _mm512_div_ps(o1.packed, _mm512_set1_ps(o2));
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float operator==(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_EQ_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_float operator!=(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_NEQ_UQ));
+}
+
+BI_FORCE_INLINE inline avx512_float operator<(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_LT_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_float operator<=(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_LE_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_float operator>(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_GT_OQ));
+}
+
+BI_FORCE_INLINE inline avx512_float operator>=(const avx512_float& o1,
+    const avx512_float& o2) {
+  return avx512_float_expand(_mm512_cmp_ps_mask(o1.packed, o2.packed,
+      _CMP_GE_OQ));
+}
+
+BI_FORCE_INLINE inline const avx512_float operator-(const avx512_float& o) {
+  avx512_float res;
+  res.packed = _mm512_castsi512_ps(_mm512_xor_si512(
+      _mm512_castps_si512(_mm512_set1_ps(-0.0f)),
+      _mm512_castps_si512(o.packed)));
+  return res;
+}
+
+BI_FORCE_INLINE inline const avx512_float operator+(const avx512_float& o) {
+  return o;
+}
+
+BI_FORCE_INLINE inline avx512_float abs(const avx512_float x) {
+  avx512_float res;
+  res.packed = _mm512_abs_ps(x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float select(const avx512_float mask,
+    const avx512_float x, const avx512_float y) {
+  avx512_float res;
+  res.packed = _mm512_mask_blend_ps(avx512_float_compress(mask), y.packed,
+      x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const avx512_float mask) {
+  return avx512_float_compress(mask) != 0;
+}
+
+BI_FORCE_INLINE inline avx512_float exp2i(const avx512_float n) {
+  avx512_float res;
+  res.packed = _mm512_scalef_ps(_mm512_set1_ps(1.0f), n.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float frexp(const avx512_float x,
+    avx512_float& e) {
+  /* getexp gives the exponent for a mantissa in [1,2), so add one */
+  e.packed = _mm512_add_ps(_mm512_getexp_ps(x.packed), _mm512_set1_ps(1.0f));
+
+  avx512_float res;
+  res.packed = _mm512_getmant_ps(x.packed, _MM_MANT_NORM_p5_1,
+      _MM_MANT_SIGN_src);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float mul_err(const avx512_float x,
+    const avx512_float y, const avx512_float p) {
+  avx512_float res;
+  res.packed = _mm512_fmsub_ps(x.packed, y.packed, p.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float log(const avx512_float x) {
+  return simd_transcendental<float>::log(x);
+}
+
+BI_FORCE_INLINE inline avx512_float nanlog(const avx512_float x) {
+  return select(x != x,
+      simd_splat<avx512_float>(-std::numeric_limits<float>::infinity()),
+      log(x));
+}
+
+BI_FORCE_INLINE inline avx512_float log1p(const avx512_float x) {
+  return simd_log1p<avx512_float,float>(x);
+}
+
+BI_FORCE_INLINE inline avx512_float exp(const avx512_float x) {
+  return simd_transcendental<float>::exp(x);
+}
+
+BI_FORCE_INLINE inline avx512_float nanexp(const avx512_float x) {
+  return select(x != x, simd_splat<avx512_float>(static_cast<float>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline avx512_float expm1(const avx512_float x) {
+  return simd_expm1<avx512_float,float>(x);
+}
+
+BI_FORCE_INLINE inline avx512_float max(const avx512_float x,
+    const avx512_float y) {
+  avx512_float res;
+  res.packed = _mm512_max_ps(x.packed, y.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float min(const avx512_float x,
+    const avx512_float y) {
+  avx512_float res;
+  res.packed = _mm512_min_ps(x.packed, y.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float sqrt(const avx512_float x) {
+  avx512_float res;
+  res.packed = _mm512_sqrt_ps(x.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline avx512_float pow(const avx512_float x,
+    const avx512_float y) {
+  if (any(simd_pow_special<avx512_float,float>(x, y))) {
+    BI_AVX512FLOAT_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<avx512_float,float>(x, y);
+  }
+}
+
+BI_FORCE_INLINE inline avx512_float pow(const avx512_float x,
+    const float y) {
+  return pow(x, simd_splat<avx512_float>(y));
+}
+
+BI_FORCE_INLINE inline avx512_float pow(const float x,
+    const avx512_float y) {
+  return pow(simd_splat<avx512_float>(x), y);
+}
+
+BI_FORCE_INLINE inline avx512_float mod(const avx512_float x,
+    const avx512_float y) {
+  BI_AVX512FLOAT_BIVARIATE(mod, x, y)
+}
+
+BI_FORCE_INLINE inline avx512_float ceil(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(ceil, x)
+}
+
+BI_FORCE_INLINE inline avx512_float floor(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(floor, x)
+}
+
+BI_FORCE_INLINE inline avx512_float gamma(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(gamma, x)
+}
+
+BI_FORCE_INLINE inline avx512_float lgamma(const avx512_float x) {
+  if (any(simd_lgamma_special<avx512_float,float>(x))) {
+    BI_AVX512FLOAT_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<avx512_float,float>(x);
+  }
+}
+
+BI_FORCE_INLINE inline avx512_float sin(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(sin, x)
+}
+
+BI_FORCE_INLINE inline avx512_float cos(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(cos, x)
+}
+
+BI_FORCE_INLINE inline avx512_float tan(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(tan, x)
+}
+
+BI_FORCE_INLINE inline avx512_float asin(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(asin, x)
+}
+
+BI_FORCE_INLINE inline avx512_float acos(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(acos, x)
+}
+
+BI_FORCE_INLINE inline avx512_float atan(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(atan, x)
+}
+
+BI_FORCE_INLINE inline avx512_float atan2(const avx512_float x,
+    const avx512_float y) {
+  BI_AVX512FLOAT_BIVARIATE(atan2, x, y)
+}
+
+BI_FORCE_INLINE inline avx512_float sinh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(sinh, x)
+}
+
+BI_FORCE_INLINE inline avx512_float cosh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(cosh, x)
+}
+
+BI_FORCE_INLINE inline avx512_float tanh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(tanh, x)
+}
+
+BI_FORCE_INLINE inline avx512_float asinh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(asinh, x)
+}
+
+BI_FORCE_INLINE inline avx512_float acosh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(acosh, x)
+}
+
+BI_FORCE_INLINE inline avx512_float atanh(const avx512_float x) {
+  BI_AVX512FLOAT_UNIVARIATE(atanh, x)
+}
+
+BI_FORCE_INLINE inline float max_reduce(const avx512_float x) {
+  return bi::max(bi::max_reduce(x.unpacked.a), bi::max_reduce(x.unpacked.b));
+}
+
+}
+
+#endif
@@ -72,6 +72,7 @@ union avx_double {
 
   avx_double& operator=(const double& o) {
     packed = _mm256_set1_pd(o);
+    return *this;
   }
 };
 
@@ -99,6 +100,30 @@ BI_FORCE_INLINE inline avx_double& operator/=(avx_double& o1,
   return o1;
 }
 
+BI_FORCE_INLINE inline avx_double& operator+=(avx_double& o1,
+    const double& o2) {
+  o1.packed = _mm256_add_pd(o1.packed, _mm256_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_double& operator-=(avx_double& o1,
+    const double& o2) {
+  o1.packed = _mm256_sub_pd(o1.packed, _mm256_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_double& operator*=(avx_double& o1,
+    const double& o2) {
+  o1.packed = _mm256_mul_pd(o1.packed, _mm256_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_double& operator/=(avx_double& o1,
+    const double& o2) {
+  o1.packed = _mm256_div_pd(o1.packed, _mm256_set1_pd(o2));
+  return o1;
+}
+
 BI_FORCE_INLINE inline avx_double operator+(const avx_double& o1,
     const avx_double& o2) {
   avx_double res;
@@ -193,7 +218,7 @@ BI_FORCE_INLINE inline avx_double operator==(const avx_double& o1,
 BI_FORCE_INLINE inline avx_double operator!=(const avx_double& o1,
     const avx_double& o2) {
   avx_double res;
-  res.packed = _mm256_cmp_pd(o1.packed, o2.packed, _CMP_NEQ_OQ);
+  res.packed = _mm256_cmp_pd(o1.packed, o2.packed, _CMP_NEQ_UQ);
   return res;
 }
 
@@ -241,20 +266,89 @@ BI_FORCE_INLINE inline avx_double abs(const avx_double x) {
   return res;
 }
 
+BI_FORCE_INLINE inline avx_double select(const avx_double mask,
+    const avx_double x, const avx_double y) {
+  avx_double res;
+  res.packed = _mm256_blendv_pd(y.packed, x.packed, mask.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const avx_double mask) {
+  return _mm256_movemask_pd(mask.packed) != 0;
+}
+
+BI_FORCE_INLINE inline avx_double exp2i(const avx_double n) {
+  avx_double res;
+#ifdef ENABLE_AVX2
+  /* adding 2^52 + 1023 puts the biased exponent in the low bits */
+  const __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n.packed,
+      _mm256_set1_pd(4503599627371519.0)));
+  res.packed = _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+#else
+  /* no 256-bit integer operations before AVX2, so use halves */
+  res.unpacked.a = exp2i(n.unpacked.a);
+  res.unpacked.b = exp2i(n.unpacked.b);
+#endif
+  return res;
+}
+
+BI_FORCE_INLINE inline avx_double frexp(const avx_double x, avx_double& e) {
+  avx_double res;
+#ifdef ENABLE_AVX2
+  /* biased exponent, converted by placing it in the mantissa of 2^52 */
+  const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+  const __m256i ebits = _mm256_srli_epi64(_mm256_castpd_si256(x.packed), 52);
+  e.packed = _mm256_sub_pd(_mm256_or_pd(_mm256_castsi256_pd(ebits), two52),
+      _mm256_add_pd(two52, _mm256_set1_pd(1022.0)));
+
+  /* mantissa, with exponent of 1/2 */
+  const __m256d mask = _mm256_castsi256_pd(
+      _mm256_set1_epi64x(0x800FFFFFFFFFFFFFLL));
+  res.packed = _mm256_or_pd(_mm256_and_pd(x.packed, mask),
+      _mm256_set1_pd(0.5));
+#else
+  /* no 256-bit integer operations before AVX2, so use halves */
+  res.unpacked.a = frexp(x.unpacked.a, e.unpacked.a);
+  res.unpacked.b = frexp(x.unpacked.b, e.unpacked.b);
+#endif
+  return res;
+}
+
+BI_FORCE_INLINE inline avx_double mul_err(const avx_double x,
+    const avx_double y, const avx_double p) {
+#ifdef __FMA__
+  avx_double res;
+  res.packed = _mm256_fmsub_pd(x.packed, y.packed, p.packed);
+  return res;
+#else
+  return simd_dekker_mul_err<avx_double,double>(x, y, p);
+#endif
+}
+
 BI_FORCE_INLINE inline avx_double log(const avx_double x) {
-  BI_AVXDOUBLE_UNIVARIATE(log, x)
+  return simd_transcendental<double>::log(x);
 }
 
 BI_FORCE_INLINE inline avx_double nanlog(const avx_double x) {
-  BI_AVXDOUBLE_UNIVARIATE(nanlog, x)
+  return select(x != x,
+      simd_splat<avx_double>(-std::numeric_limits<double>::infinity()), log(x));
+}
+
+BI_FORCE_INLINE inline avx_double log1p(const avx_double x) {
+  return simd_log1p<avx_double,double>(x);
 }
 
 BI_FORCE_INLINE inline avx_double exp(const avx_double x) {
-  BI_AVXDOUBLE_UNIVARIATE(exp, x)
+  return simd_transcendental<double>::exp(x);
 }
 
 BI_FORCE_INLINE inline avx_double nanexp(const avx_double x) {
-  BI_AVXDOUBLE_UNIVARIATE(nanexp, x)
+  return select(x != x, simd_splat<avx_double>(static_cast<double>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline avx_double expm1(const avx_double x) {
+  return simd_expm1<avx_double,double>(x);
 }
 
 BI_FORCE_INLINE inline avx_double max(const avx_double x,
@@ -277,17 +371,20 @@ BI_FORCE_INLINE inline avx_double sqrt(const avx_double x) {
   return res;
 }
 
-BI_FORCE_INLINE inline avx_double pow(const avx_double x,
-    const avx_double y) {
-  BI_AVXDOUBLE_BIVARIATE(pow, x, y)
+BI_FORCE_INLINE inline avx_double pow(const avx_double x, const avx_double y) {
+  if (any(simd_pow_special<avx_double,double>(x, y))) {
+    BI_AVXDOUBLE_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<avx_double,double>(x, y);
+  }
 }
 
 BI_FORCE_INLINE inline avx_double pow(const avx_double x, const double y) {
-  BI_AVXDOUBLE_BIVARIATE_REAL_RIGHT(pow, x, y)
+  return pow(x, simd_splat<avx_double>(y));
 }
 
 BI_FORCE_INLINE inline avx_double pow(const double x, const avx_double y) {
-  BI_AVXDOUBLE_BIVARIATE_REAL_LEFT(pow, x, y)
+  return pow(simd_splat<avx_double>(x), y);
 }
 
 BI_FORCE_INLINE inline avx_double mod(const avx_double x,
@@ -308,7 +405,11 @@ BI_FORCE_INLINE inline avx_double gamma(const avx_double x) {
 }
 
 BI_FORCE_INLINE inline avx_double lgamma(const avx_double x) {
-  BI_AVXDOUBLE_UNIVARIATE(lgamma, x)
+  if (any(simd_lgamma_special<avx_double,double>(x))) {
+    BI_AVXDOUBLE_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<avx_double,double>(x);
+  }
 }
 
 BI_FORCE_INLINE inline avx_double sin(const avx_double x) {
@@ -72,6 +72,7 @@ union avx_float {
 
   avx_float& operator=(const float& o) {
     packed = _mm256_set1_ps(o);
+    return *this;
   }
 };
 
@@ -99,6 +100,26 @@ BI_FORCE_INLINE inline avx_float& operator/=(avx_float& o1,
   return o1;
 }
 
+BI_FORCE_INLINE inline avx_float& operator+=(avx_float& o1, const float& o2) {
+  o1.packed = _mm256_add_ps(o1.packed, _mm256_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_float& operator-=(avx_float& o1, const float& o2) {
+  o1.packed = _mm256_sub_ps(o1.packed, _mm256_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_float& operator*=(avx_float& o1, const float& o2) {
+  o1.packed = _mm256_mul_ps(o1.packed, _mm256_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline avx_float& operator/=(avx_float& o1, const float& o2) {
+  o1.packed = _mm256_div_ps(o1.packed, _mm256_set1_ps(o2));
+  return o1;
+}
+
 BI_FORCE_INLINE inline avx_float operator+(const avx_float& o1,
     const avx_float& o2) {
   avx_float res;
@@ -193,7 +214,7 @@ BI_FORCE_INLINE inline avx_float operator==(const avx_float& o1,
 BI_FORCE_INLINE inline avx_float operator!=(const avx_float& o1,
     const avx_float& o2) {
   avx_float res;
-  res.packed = _mm256_cmp_ps(o1.packed, o2.packed, _CMP_NEQ_OQ);
+  res.packed = _mm256_cmp_ps(o1.packed, o2.packed, _CMP_NEQ_UQ);
   return res;
 }
 
@@ -241,20 +262,84 @@ BI_FORCE_INLINE inline avx_float abs(const avx_float x) {
   return res;
 }
 
+BI_FORCE_INLINE inline avx_float select(const avx_float mask,
+    const avx_float x, const avx_float y) {
+  avx_float res;
+  res.packed = _mm256_blendv_ps(y.packed, x.packed, mask.packed);
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const avx_float mask) {
+  return _mm256_movemask_ps(mask.packed) != 0;
+}
+
+BI_FORCE_INLINE inline avx_float exp2i(const avx_float n) {
+  avx_float res;
+#ifdef ENABLE_AVX2
+  const __m256i k = _mm256_add_epi32(_mm256_cvtps_epi32(n.packed),
+      _mm256_set1_epi32(127));
+  res.packed = _mm256_castsi256_ps(_mm256_slli_epi32(k, 23));
+#else
+  /* no 256-bit integer operations before AVX2, so use halves */
+  res.unpacked.a = exp2i(n.unpacked.a);
+  res.unpacked.b = exp2i(n.unpacked.b);
+#endif
+  return res;
+}
+
+BI_FORCE_INLINE inline avx_float frexp(const avx_float x, avx_float& e) {
+  avx_float res;
+#ifdef ENABLE_AVX2
+  const __m256i ebits = _mm256_srli_epi32(_mm256_castps_si256(x.packed), 23);
+  e.packed = _mm256_sub_ps(_mm256_cvtepi32_ps(ebits), _mm256_set1_ps(126.0f));
+
+  /* mantissa, with exponent of 1/2 */
+  const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x807FFFFF));
+  res.packed = _mm256_or_ps(_mm256_and_ps(x.packed, mask),
+      _mm256_set1_ps(0.5f));
+#else
+  /* no 256-bit integer operations before AVX2, so use halves */
+  res.unpacked.a = frexp(x.unpacked.a, e.unpacked.a);
+  res.unpacked.b = frexp(x.unpacked.b, e.unpacked.b);
+#endif
+  return res;
+}
+
+BI_FORCE_INLINE inline avx_float mul_err(const avx_float x,
+    const avx_float y, const avx_float p) {
+#ifdef __FMA__
+  avx_float res;
+  res.packed = _mm256_fmsub_ps(x.packed, y.packed, p.packed);
+  return res;
+#else
+  return simd_dekker_mul_err<avx_float,float>(x, y, p);
+#endif
+}
+
 BI_FORCE_INLINE inline avx_float log(const avx_float x) {
-  BI_AVXFLOAT_UNIVARIATE(log, x)
+  return simd_transcendental<float>::log(x);
 }
 
 BI_FORCE_INLINE inline avx_float nanlog(const avx_float x) {
-  BI_AVXFLOAT_UNIVARIATE(nanlog, x)
+  return select(x != x,
+      simd_splat<avx_float>(-std::numeric_limits<float>::infinity()), log(x));
+}
+
+BI_FORCE_INLINE inline avx_float log1p(const avx_float x) {
+  return simd_log1p<avx_float,float>(x);
 }
 
 BI_FORCE_INLINE inline avx_float exp(const avx_float x) {
-  BI_AVXFLOAT_UNIVARIATE(exp, x)
+  return simd_transcendental<float>::exp(x);
 }
 
 BI_FORCE_INLINE inline avx_float nanexp(const avx_float x) {
-  BI_AVXFLOAT_UNIVARIATE(nanexp, x)
+  return select(x != x, simd_splat<avx_float>(static_cast<float>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline avx_float expm1(const avx_float x) {
+  return simd_expm1<avx_float,float>(x);
 }
 
 BI_FORCE_INLINE inline avx_float max(const avx_float x, const avx_float y) {
@@ -276,15 +361,19 @@ BI_FORCE_INLINE inline avx_float sqrt(const avx_float x) {
 }
 
 BI_FORCE_INLINE inline avx_float pow(const avx_float x, const avx_float y) {
-  BI_AVXFLOAT_BIVARIATE(pow, x, y)
+  if (any(simd_pow_special<avx_float,float>(x, y))) {
+    BI_AVXFLOAT_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<avx_float,float>(x, y);
+  }
 }
 
 BI_FORCE_INLINE inline avx_float pow(const avx_float x, const float y) {
-  BI_AVXFLOAT_BIVARIATE_REAL_RIGHT(pow, x, y)
+  return pow(x, simd_splat<avx_float>(y));
 }
 
 BI_FORCE_INLINE inline avx_float pow(const float x, const avx_float y) {
-  BI_AVXFLOAT_BIVARIATE_REAL_LEFT(pow, x, y)
+  return pow(simd_splat<avx_float>(x), y);
 }
 
 BI_FORCE_INLINE inline avx_float mod(const avx_float x, const avx_float y) {
@@ -304,7 +393,11 @@ BI_FORCE_INLINE inline avx_float gamma(const avx_float x) {
 }
 
 BI_FORCE_INLINE inline avx_float lgamma(const avx_float x) {
-  BI_AVXFLOAT_UNIVARIATE(lgamma, x)
+  if (any(simd_lgamma_special<avx_float,float>(x))) {
+    BI_AVXFLOAT_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<avx_float,float>(x);
+  }
 }
 
 BI_FORCE_INLINE inline avx_float sin(const avx_float x) {
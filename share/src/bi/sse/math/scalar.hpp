@@ -22,11 +22,20 @@
 #include "avx_double.hpp"
 #endif
 
+#ifdef ENABLE_AVX512
+#include "avx512_float.hpp"
+#include "avx512_double.hpp"
+#endif
+
 namespace bi {
-#if defined(ENABLE_SINGLE) && defined(ENABLE_AVX)
+#if defined(ENABLE_SINGLE) && defined(ENABLE_AVX512)
+typedef avx512_float simd_real;
+#elif defined(ENABLE_SINGLE) && defined(ENABLE_AVX)
 typedef avx_float simd_real;
 #elif defined(ENABLE_SINGLE) && defined(ENABLE_SSE)
 typedef sse_float simd_real;
+#elif defined(ENABLE_AVX512)
+typedef avx512_double simd_real;
 #elif defined(ENABLE_AVX)
 typedef avx_double simd_real;
 #elif defined(ENABLE_SSE)
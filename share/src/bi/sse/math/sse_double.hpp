@@ -9,9 +9,13 @@
 #define BI_SSE_MATH_SSEDOUBLE_HPP
 
 #include "../../math/scalar.hpp"
+#include "transcendental.hpp"
 #include "../../misc/compile.hpp"
 
 #include <pmmintrin.h>
+#ifdef __FMA__
+#include <immintrin.h>
+#endif
 
 /**
  * @def BI_SSEDOUBLE_UNIVARIATE
@@ -101,6 +105,30 @@ BI_FORCE_INLINE inline sse_double& operator/=(sse_double& o1,
   return o1;
 }
 
+BI_FORCE_INLINE inline sse_double& operator+=(sse_double& o1,
+    const double& o2) {
+  o1.packed = _mm_add_pd(o1.packed, _mm_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_double& operator-=(sse_double& o1,
+    const double& o2) {
+  o1.packed = _mm_sub_pd(o1.packed, _mm_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_double& operator*=(sse_double& o1,
+    const double& o2) {
+  o1.packed = _mm_mul_pd(o1.packed, _mm_set1_pd(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_double& operator/=(sse_double& o1,
+    const double& o2) {
+  o1.packed = _mm_div_pd(o1.packed, _mm_set1_pd(o2));
+  return o1;
+}
+
 BI_FORCE_INLINE inline sse_double operator+(const sse_double& o1,
     const sse_double& o2) {
   sse_double res;
@@ -243,20 +271,77 @@ BI_FORCE_INLINE inline sse_double abs(const sse_double x) {
   return res;
 }
 
+BI_FORCE_INLINE inline sse_double select(const sse_double mask,
+    const sse_double x, const sse_double y) {
+  sse_double res;
+  res.packed = _mm_or_pd(_mm_and_pd(mask.packed, x.packed),
+      _mm_andnot_pd(mask.packed, y.packed));
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const sse_double mask) {
+  return _mm_movemask_pd(mask.packed) != 0;
+}
+
+BI_FORCE_INLINE inline sse_double exp2i(const sse_double n) {
+  /* adding 2^52 + 1023 puts the biased exponent in the low bits */
+  const __m128i bits = _mm_castpd_si128(_mm_add_pd(n.packed,
+      _mm_set1_pd(4503599627371519.0)));
+  sse_double res;
+  res.packed = _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+  return res;
+}
+
+BI_FORCE_INLINE inline sse_double frexp(const sse_double x, sse_double& e) {
+  /* biased exponent, converted by placing it in the mantissa of 2^52 */
+  const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+  const __m128i ebits = _mm_srli_epi64(_mm_castpd_si128(x.packed), 52);
+  e.packed = _mm_sub_pd(_mm_or_pd(_mm_castsi128_pd(ebits), two52),
+      _mm_add_pd(two52, _mm_set1_pd(1022.0)));
+
+  /* mantissa, with exponent of 1/2 */
+  const __m128d mask = _mm_castsi128_pd(
+      _mm_set1_epi64x(0x800FFFFFFFFFFFFFLL));
+  sse_double res;
+  res.packed = _mm_or_pd(_mm_and_pd(x.packed, mask), _mm_set1_pd(0.5));
+  return res;
+}
+
+BI_FORCE_INLINE inline sse_double mul_err(const sse_double x,
+    const sse_double y, const sse_double p) {
+#ifdef __FMA__
+  sse_double res;
+  res.packed = _mm_fmsub_pd(x.packed, y.packed, p.packed);
+  return res;
+#else
+  return simd_dekker_mul_err<sse_double,double>(x, y, p);
+#endif
+}
+
 BI_FORCE_INLINE inline sse_double log(const sse_double x) {
-  BI_SSEDOUBLE_UNIVARIATE(log, x)
+  return simd_transcendental<double>::log(x);
 }
 
 BI_FORCE_INLINE inline sse_double nanlog(const sse_double x) {
-  BI_SSEDOUBLE_UNIVARIATE(nanlog, x)
+  return select(x != x,
+      simd_splat<sse_double>(-std::numeric_limits<double>::infinity()), log(x));
+}
+
+BI_FORCE_INLINE inline sse_double log1p(const sse_double x) {
+  return simd_log1p<sse_double,double>(x);
 }
 
 BI_FORCE_INLINE inline sse_double exp(const sse_double x) {
-  BI_SSEDOUBLE_UNIVARIATE(exp, x)
+  return simd_transcendental<double>::exp(x);
 }
 
 BI_FORCE_INLINE inline sse_double nanexp(const sse_double x) {
-  BI_SSEDOUBLE_UNIVARIATE(nanexp, x)
+  return select(x != x, simd_splat<sse_double>(static_cast<double>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline sse_double expm1(const sse_double x) {
+  return simd_expm1<sse_double,double>(x);
 }
 
 BI_FORCE_INLINE inline sse_double max(const sse_double x,
@@ -279,17 +364,20 @@ BI_FORCE_INLINE inline sse_double sqrt(const sse_double x) {
   return res;
 }
 
-BI_FORCE_INLINE inline sse_double pow(const sse_double x,
-    const sse_double y) {
-  BI_SSEDOUBLE_BIVARIATE(pow, x, y)
+BI_FORCE_INLINE inline sse_double pow(const sse_double x, const sse_double y) {
+  if (any(simd_pow_special<sse_double,double>(x, y))) {
+    BI_SSEDOUBLE_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<sse_double,double>(x, y);
+  }
 }
 
 BI_FORCE_INLINE inline sse_double pow(const sse_double x, const double y) {
-  BI_SSEDOUBLE_BIVARIATE_REAL_RIGHT(pow, x, y)
+  return pow(x, simd_splat<sse_double>(y));
 }
 
 BI_FORCE_INLINE inline sse_double pow(const double x, const sse_double y) {
-  BI_SSEDOUBLE_BIVARIATE_REAL_LEFT(pow, x, y)
+  return pow(simd_splat<sse_double>(x), y);
 }
 
 BI_FORCE_INLINE inline sse_double mod(const sse_double x,
@@ -310,7 +398,11 @@ BI_FORCE_INLINE inline sse_double gamma(const sse_double x) {
 }
 
 BI_FORCE_INLINE inline sse_double lgamma(const sse_double x) {
-  BI_SSEDOUBLE_UNIVARIATE(lgamma, x)
+  if (any(simd_lgamma_special<sse_double,double>(x))) {
+    BI_SSEDOUBLE_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<sse_double,double>(x);
+  }
 }
 
 BI_FORCE_INLINE inline sse_double sin(const sse_double x) {
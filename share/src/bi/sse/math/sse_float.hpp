@@ -9,9 +9,13 @@
 #define BI_SSE_MATH_SSEFLOAT_HPP
 
 #include "../../math/scalar.hpp"
+#include "transcendental.hpp"
 #include "../../misc/compile.hpp"
 
 #include <pmmintrin.h>
+#ifdef __FMA__
+#include <immintrin.h>
+#endif
 
 /**
  * @def BI_SSEFLOAT_UNIVARIATE
@@ -109,6 +113,26 @@ BI_FORCE_INLINE inline sse_float& operator/=(sse_float& o1,
   return o1;
 }
 
+BI_FORCE_INLINE inline sse_float& operator+=(sse_float& o1, const float& o2) {
+  o1.packed = _mm_add_ps(o1.packed, _mm_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_float& operator-=(sse_float& o1, const float& o2) {
+  o1.packed = _mm_sub_ps(o1.packed, _mm_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_float& operator*=(sse_float& o1, const float& o2) {
+  o1.packed = _mm_mul_ps(o1.packed, _mm_set1_ps(o2));
+  return o1;
+}
+
+BI_FORCE_INLINE inline sse_float& operator/=(sse_float& o1, const float& o2) {
+  o1.packed = _mm_div_ps(o1.packed, _mm_set1_ps(o2));
+  return o1;
+}
+
 BI_FORCE_INLINE inline sse_float operator+(const sse_float& o1,
     const sse_float& o2) {
   sse_float res;
@@ -147,7 +171,7 @@ BI_FORCE_INLINE inline sse_float operator+(const float& o1,
 BI_FORCE_INLINE inline sse_float operator-(const float& o1,
     const sse_float& o2) {
   sse_float res;
-  res.packed = _mm_add_ps(_mm_set1_ps(o1), o2.packed);
+  res.packed = _mm_sub_ps(_mm_set1_ps(o1), o2.packed);
   return res;
 }
 
@@ -251,20 +275,72 @@ BI_FORCE_INLINE inline sse_float abs(const sse_float x) {
   return res;
 }
 
+BI_FORCE_INLINE inline sse_float select(const sse_float mask,
+    const sse_float x, const sse_float y) {
+  sse_float res;
+  res.packed = _mm_or_ps(_mm_and_ps(mask.packed, x.packed),
+      _mm_andnot_ps(mask.packed, y.packed));
+  return res;
+}
+
+BI_FORCE_INLINE inline bool any(const sse_float mask) {
+  return _mm_movemask_ps(mask.packed) != 0;
+}
+
+BI_FORCE_INLINE inline sse_float exp2i(const sse_float n) {
+  const __m128i k = _mm_add_epi32(_mm_cvtps_epi32(n.packed),
+      _mm_set1_epi32(127));
+  sse_float res;
+  res.packed = _mm_castsi128_ps(_mm_slli_epi32(k, 23));
+  return res;
+}
+
+BI_FORCE_INLINE inline sse_float frexp(const sse_float x, sse_float& e) {
+  const __m128i ebits = _mm_srli_epi32(_mm_castps_si128(x.packed), 23);
+  e.packed = _mm_sub_ps(_mm_cvtepi32_ps(ebits), _mm_set1_ps(126.0f));
+
+  /* mantissa, with exponent of 1/2 */
+  const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x807FFFFF));
+  sse_float res;
+  res.packed = _mm_or_ps(_mm_and_ps(x.packed, mask), _mm_set1_ps(0.5f));
+  return res;
+}
+
+BI_FORCE_INLINE inline sse_float mul_err(const sse_float x,
+    const sse_float y, const sse_float p) {
+#ifdef __FMA__
+  sse_float res;
+  res.packed = _mm_fmsub_ps(x.packed, y.packed, p.packed);
+  return res;
+#else
+  return simd_dekker_mul_err<sse_float,float>(x, y, p);
+#endif
+}
+
 BI_FORCE_INLINE inline sse_float log(const sse_float x) {
-  BI_SSEFLOAT_UNIVARIATE(log, x)
+  return simd_transcendental<float>::log(x);
 }
 
 BI_FORCE_INLINE inline sse_float nanlog(const sse_float x) {
-  BI_SSEFLOAT_UNIVARIATE(nanlog, x)
+  return select(x != x,
+      simd_splat<sse_float>(-std::numeric_limits<float>::infinity()), log(x));
+}
+
+BI_FORCE_INLINE inline sse_float log1p(const sse_float x) {
+  return simd_log1p<sse_float,float>(x);
 }
 
 BI_FORCE_INLINE inline sse_float exp(const sse_float x) {
-  BI_SSEFLOAT_UNIVARIATE(exp, x)
+  return simd_transcendental<float>::exp(x);
 }
 
 BI_FORCE_INLINE inline sse_float nanexp(const sse_float x) {
-  BI_SSEFLOAT_UNIVARIATE(nanexp, x)
+  return select(x != x, simd_splat<sse_float>(static_cast<float>(0.0)),
+      exp(x));
+}
+
+BI_FORCE_INLINE inline sse_float expm1(const sse_float x) {
+  return simd_expm1<sse_float,float>(x);
 }
 
 BI_FORCE_INLINE inline sse_float max(const sse_float x, const sse_float y) {
@@ -286,15 +362,19 @@ BI_FORCE_INLINE inline sse_float sqrt(const sse_float x) {
 }
 
 BI_FORCE_INLINE inline sse_float pow(const sse_float x, const sse_float y) {
-  BI_SSEFLOAT_BIVARIATE(pow, x, y)
+  if (any(simd_pow_special<sse_float,float>(x, y))) {
+    BI_SSEFLOAT_BIVARIATE(pow, x, y)
+  } else {
+    return simd_pow<sse_float,float>(x, y);
+  }
 }
 
 BI_FORCE_INLINE inline sse_float pow(const sse_float x, const float y) {
-  BI_SSEFLOAT_BIVARIATE_REAL_RIGHT(pow, x, y)
+  return pow(x, simd_splat<sse_float>(y));
 }
 
 BI_FORCE_INLINE inline sse_float pow(const float x, const sse_float y) {
-  BI_SSEFLOAT_BIVARIATE_REAL_LEFT(pow, x, y)
+  return pow(simd_splat<sse_float>(x), y);
 }
 
 BI_FORCE_INLINE inline sse_float mod(const sse_float x, const sse_float y) {
@@ -314,7 +394,11 @@ BI_FORCE_INLINE inline sse_float gamma(const sse_float x) {
 }
 
 BI_FORCE_INLINE inline sse_float lgamma(const sse_float x) {
-  BI_SSEFLOAT_UNIVARIATE(lgamma, x)
+  if (any(simd_lgamma_special<sse_float,float>(x))) {
+    BI_SSEFLOAT_UNIVARIATE(lgamma, x)
+  } else {
+    return simd_lgamma<sse_float,float>(x);
+  }
 }
 
 BI_FORCE_INLINE inline sse_float sin(const sse_float x) {
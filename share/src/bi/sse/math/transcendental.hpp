@@ -0,0 +1,682 @@
+/**
+ * @file
+ *
+ * Vectorised transcendental functions, generic over SIMD vector types.
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ *
+ * Each SIMD vector type must provide the following primitives, found by
+ * argument-dependent lookup when the templates below are instantiated:
+ *
+ * @li <tt>select(mask, x, y)</tt>, elementwise @c x where @c mask is set
+ * and @c y elsewhere,
+ * @li <tt>any(mask)</tt>, is any element of @c mask set?
+ * @li <tt>exp2i(n)</tt>, \f$2^n\f$ for integral @c n in the normal
+ * exponent range,
+ * @li <tt>frexp(x, e)</tt>, mantissa in \f$[1/2,1)\f$ of positive normal
+ * @c x, with exponent in @c e,
+ * @li <tt>mul_err(x, y, p)</tt>, the rounding error \f$xy - p\f$ of the
+ * product <tt>p = x*y</tt>, exactly (see simd_dekker_mul_err()),
+ *
+ * as well as the arithmetic, comparison, @c min and @c max operations, and
+ * assignment from a scalar.
+ *
+ * Bounds on the errors against the long double functions of glibc libm,
+ * checked over millions of arguments spread over each domain by the
+ * @c test_transcendental client (<tt>libbi test_transcendental</tt>), which
+ * fails if any is exceeded, are:
+ *
+ * <table>
+ * <tr><th>Function</th><th>double</th><th>float</th></tr>
+ * <tr><td>exp</td><td>2 ulp</td><td>2 ulp</td></tr>
+ * <tr><td>log</td><td>1 ulp</td><td>1 ulp</td></tr>
+ * <tr><td>log1p</td><td>3 ulp</td><td>3 ulp</td></tr>
+ * <tr><td>expm1</td><td>3 ulp</td><td>3 ulp</td></tr>
+ * <tr><td>pow</td><td>3 ulp</td><td>3 ulp</td></tr>
+ * <tr><td>cos2pi</td><td>\f$2^{-52}\f$ absolute</td><td>\f$2^{-23}\f$
+ * absolute</td></tr>
+ * <tr><td>lgamma</td><td>4 ulp</td><td>4 ulp</td></tr>
+ * </table>
+ *
+ * The error of @c pow does not grow with \f$|y\log x|\f$, and that of
+ * @c lgamma is relative also near its zeros at 1 and 2.
+ *
+ * @c pow and @c lgamma are vectorised for positive finite arguments only;
+ * callers fall back to the scalar functions for vectors that contain other
+ * arguments (see simd_pow_special() and simd_lgamma_special()).
+ */
+#ifndef BI_SSE_MATH_TRANSCENDENTAL_HPP
+#define BI_SSE_MATH_TRANSCENDENTAL_HPP
+
+#include "../../misc/compile.hpp"
+
+#include <limits>
+
+namespace bi {
+/**
+ * Broadcast scalar to SIMD vector.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+BI_FORCE_INLINE inline V1 simd_splat(const T1 x) {
+  V1 res;
+  res = x;
+  return res;
+}
+
+/**
+ * Round to nearest integer, for arguments of magnitude less than half the
+ * reciprocal of the machine epsilon.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+BI_FORCE_INLINE inline V1 simd_rint(const V1 x) {
+  /* 1.5 times 2^52 (double) or 2^23 (float), adding which pushes all
+   * fractional bits out of the mantissa */
+  const T1 magic = (sizeof(T1) == 8) ? static_cast<T1>(6755399441055744.0) :
+      static_cast<T1>(12582912.0);
+  return (x + magic) - magic;
+}
+
+/**
+ * Rounding error of a product, by Dekker's algorithm, for the #mul_err
+ * primitive of SIMD vector types without fused multiply-add instructions.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ *
+ * @param x First factor.
+ * @param y Second factor.
+ * @param p Product <tt>x*y</tt>.
+ *
+ * @return \f$xy - p\f$, exactly, for @p x and @p y of magnitude less than
+ * \f$2^{996}\f$ (double) or \f$2^{115}\f$ (float).
+ *
+ * The splitting is only correct if the compiler does not contract the
+ * operations into fused multiply-adds, which it cannot do when the
+ * instructions are not available. Types that have them should compute
+ * <tt>x*y - p</tt> with a single fused multiply-subtract instead.
+ */
+template<class V1, class T1>
+BI_FORCE_INLINE inline V1 simd_dekker_mul_err(const V1 x, const V1 y,
+    const V1 p) {
+  /* 2^27 + 1 (double) or 2^12 + 1 (float), multiplying by which splits a
+   * value into high and low halves that can be multiplied exactly */
+  const T1 split = (sizeof(T1) == 8) ? static_cast<T1>(134217729.0) :
+      static_cast<T1>(4097.0);
+  const V1 tx = x*split, ty = y*split;
+  const V1 xh = tx - (tx - x), yh = ty - (ty - y);
+  const V1 xl = x - xh, yl = y - yh;
+
+  return ((xh*yh - p) + xh*yl + xl*yh) + xl*yl;
+}
+
+/**
+ * Vectorised transcendental functions of a given precision.
+ *
+ * @tparam T1 Scalar type.
+ *
+ * Coefficients are those of the Cephes library.
+ */
+template<class T1>
+struct simd_transcendental {
+  //
+};
+
+/**
+ * Vectorised transcendental functions, double precision.
+ */
+template<>
+struct simd_transcendental<double> {
+  /**
+   * Exponential.
+   */
+  template<class V1>
+  static V1 exp(const V1 x) {
+    const V1 x1 = min(max(x, simd_splat<V1>(-745.2)),
+        simd_splat<V1>(709.79));
+
+    /* range reduction, x = n*log(2) + r with |r| <= log(2)/2 */
+    const V1 n = simd_rint<V1,double>(x1*1.4426950408889634073599);
+    const V1 r = (x1 - n*6.93145751953125e-1) - n*1.42860682030941723212e-6;
+
+    /* Pade approximation of exp(r) */
+    const V1 rr = r*r;
+    const V1 p = r*((1.26177193074810590878e-4*rr
+        + 3.02994407707441961300e-2)*rr + 9.99999999999999999910e-1);
+    const V1 q = ((3.00198505138664455042e-6*rr
+        + 2.52448340349684104192e-3)*rr + 2.27265548208155028766e-1)*rr
+        + 2.00000000000000000009e0;
+    const V1 e = 1.0 + 2.0*p/(q - p);
+
+    /* scale by 2^n in two steps, so that neither factor over or
+     * underflows */
+    const V1 h = simd_rint<V1,double>(0.5*n);
+    const V1 res = e*exp2i(h)*exp2i(n - h);
+
+    return select(x != x, x, res);
+  }
+
+  /**
+   * Natural logarithm.
+   */
+  template<class V1>
+  static V1 log(const V1 x) {
+    const V1 zero = simd_splat<V1>(0.0);
+    const V1 inf = simd_splat<V1>(std::numeric_limits<double>::infinity());
+
+    /* scale subnormals into the normal range */
+    const V1 small = x < simd_splat<V1>(2.2250738585072014e-308);
+    const V1 x1 = select(small, x*18014398509481984.0, x);
+    V1 e, m;
+    m = frexp(x1, e);
+    e = e - select(small, simd_splat<V1>(54.0), zero);
+
+    /* m in [sqrt(1/2), sqrt(2)), less one */
+    const V1 lt = m < simd_splat<V1>(0.70710678118654752440);
+    e = e - select(lt, simd_splat<V1>(1.0), zero);
+    m = select(lt, m + m, m) - 1.0;
+
+    /* rational approximation of log(1 + m) */
+    const V1 z = m*m;
+    const V1 p = ((((1.01875663804580931796e-4*m
+        + 4.97494994976747001425e-1)*m + 4.70579119878881725854e0)*m
+        + 1.44989225341610930846e1)*m
+        + 1.79368678507819816313e1)*m + 7.70838733755885391666e0;
+    const V1 q = ((((m + 1.12873587189167450590e1)*m
+        + 4.52279145837532221105e1)*m + 8.29875266912776603211e1)*m
+        + 7.11544750618563894466e1)*m + 2.31251620126765340583e1;
+    V1 y = m*(z*p/q);
+    y = y - e*2.121944400546905827679e-4;
+    y = y - 0.5*z;
+    V1 res = (m + y) + e*0.693359375;
+
+    /* special values */
+    res = select(x == inf, inf, res);
+    res = select(x == zero, -inf, res);
+    res = select(x < zero,
+        simd_splat<V1>(std::numeric_limits<double>::quiet_NaN()), res);
+    return select(x != x, x, res);
+  }
+
+  /**
+   * Natural logarithm in extended precision, for positive finite @p x.
+   *
+   * @param x Argument.
+   * @param[out] lo Low part of the result.
+   *
+   * @return High part of the result. The sum of the high and low parts has
+   * a relative error of less than \f$2^{-60}\f$.
+   */
+  template<class V1>
+  static V1 log_ext(const V1 x, V1& lo) {
+    const V1 zero = simd_splat<V1>(0.0);
+
+    /* scale subnormals into the normal range */
+    const V1 small = x < simd_splat<V1>(2.2250738585072014e-308);
+    const V1 x1 = select(small, x*18014398509481984.0, x);
+    V1 e, m;
+    m = frexp(x1, e);
+    e = e - select(small, simd_splat<V1>(54.0), zero);
+
+    /* m in [sqrt(1/2), sqrt(2)), less one, exactly */
+    const V1 lt = m < simd_splat<V1>(0.70710678118654752440);
+    e = e - select(lt, simd_splat<V1>(1.0), zero);
+    const V1 f = select(lt, m + m, m) - 1.0;
+
+    /* log(1 + f) = 2*atanh(s) with s = f/(2 + f); 2 + f and s are each
+     * carried as the sum of two terms */
+    const V1 u = 2.0 + f;
+    const V1 ulo = f - (u - 2.0);
+    const V1 s = f/u;
+    const V1 su = s*u;
+    const V1 slo = (((f - su) - mul_err(s, u, su)) - s*ulo)/u;
+
+    /* 2*atanh(s) = 2*s + c*s^3 + s^3*z*R(z) with z = s^2, minimax, and
+     * c split in two; the terms in s and s^3 are carried in extended
+     * precision */
+    const V1 c = simd_splat<V1>(6.66666666666666662966e-1);
+    const V1 z = s*s;
+    const V1 zlo = mul_err(s, s, z);
+    const V1 s3 = s*z;
+    const V1 s3lo = mul_err(s, z, s3) + s*zlo;
+    const V1 r1 = s3*c;
+    const V1 r1lo = (mul_err(s3, c, r1) + s3lo*c)
+        - s3*1.98708064625367257e-17;
+    const V1 r2 = s3*z*((((((1.32511643072098546e-1*z
+        + 1.32501359761670333e-1)*z + 1.53870899806404853e-1)*z
+        + 1.81817756828832785e-1)*z + 2.22222226465857848e-1)*z
+        + 2.85714285690872302e-1)*z + 4.00000000000062429e-1);
+
+    /* e*log(2) + 2*s + c*s^3, with log(2) split so that the first product
+     * is exact, then the remaining terms, smallest first */
+    const V1 a = e*6.93147180369123816490e-01;
+    const V1 b = s + s;
+    const V1 hi1 = a + b;
+    const V1 b1 = hi1 - a;
+    const V1 hi = hi1 + r1;
+    const V1 b2 = hi - hi1;
+    lo = ((a - (hi1 - b1)) + (b - b1)) + ((hi1 - (hi - b2)) + (r1 - b2));
+    lo = lo + ((r2 + (r1lo + (slo + slo)*(1.0 + z)))
+        + e*1.90821492927058770002e-10);
+
+    const V1 res = hi + lo;
+    lo = lo - (res - hi);
+    return res;
+  }
+
+  /**
+   * Minimax rational approximations of
+   * \f$\ln\Gamma(x)/((x - 1)(x - 2))\f$ on \f$[1,2]\f$ and \f$[2,3]\f$,
+   * in the form \f$c + tR(t)\f$, with relative error less than
+   * \f$2^{-57}\f$.
+   *
+   * @param t \f$x - 1\f$ where @p lower is set, \f$x - 2\f$ elsewhere.
+   * @param lower Mask of elements of @p t on \f$[1,2]\f$ rather than
+   * \f$[2,3]\f$.
+   */
+  template<class V1>
+  static V1 lgamma_rational(const V1 t, const V1 lower) {
+    const V1 p1 = (((((-1.0209229523173750167e-6*t
+        - 1.90836351226762922734e-3)*t - 3.64436885574201547322e-2)*t
+        - 2.18067337204012645018e-1)*t - 5.4908950645899475888e-1)*t
+        - 6.09063789989217993489e-1)*t - 2.45251368522580356548e-1;
+    const V1 q1 = (((((3.4561035372785703811e-3*t
+        + 8.11221529325346651806e-2)*t + 6.26016347387764141089e-1)*t
+        + 2.17519878752501288319e0)*t + 3.74498610736535854464e0)*t
+        + 3.11720199752027496043e0)*t + 1.0;
+    const V1 p2 = (((((-9.20599296429107586335e-9*t
+        - 3.5121439631957340853e-5)*t - 1.2006693243539807877e-3)*t
+        - 1.31852260885666786184e-2)*t - 6.20551820792926495662e-2)*t
+        - 1.30323315142377568207e-1)*t - 1.00317301674353921157e-1;
+    const V1 q2 = (((((8.61162715117743696481e-5*t
+        + 3.55741751937633545645e-3)*t + 4.96622326562256382489e-2)*t
+        + 3.18793135554083836311e-1)*t + 1.03001900537412188122e0)*t
+        + 1.627718379961948159e0)*t + 1.0;
+    const V1 c = select(lower, simd_splat<V1>(0.57721566490153286061),
+        simd_splat<V1>(0.42278433509846713939));
+
+    return c + t*(select(lower, p1, p2)/select(lower, q1, q2));
+  }
+
+  /**
+   * Cosine of \f$2\pi u\f$.
+   */
+  template<class V1>
+  static V1 cos2pi(const V1 u) {
+    /* reduce to a quarter turn, using symmetries about 1/4 and 1/8 turn;
+     * each subtraction is exact */
+    const V1 a = abs(u - simd_rint<V1,double>(u));
+    const V1 neg = a > simd_splat<V1>(0.25);
+    const V1 b = select(neg, 0.5 - a, a);
+    const V1 swap = b > simd_splat<V1>(0.125);
+    const V1 x = select(swap, 0.25 - b, b)*6.28318530717958647693;
+
+    /* polynomial approximations of sin(x) and cos(x) on [0,pi/4] */
+    const V1 z = x*x;
+    const V1 sn = x + x*z*(((((1.58962301576546568060e-10*z
+        - 2.50507477628578072866e-8)*z + 2.75573136213857245213e-6)*z
+        - 1.98412698295895385996e-4)*z + 8.33333333332211858878e-3)*z
+        - 1.66666666666666307295e-1);
+    const V1 cs = 1.0 - 0.5*z + z*z*(((((-1.13585365213876817300e-11*z
+        + 2.08757008419747316778e-9)*z - 2.75573141792967388112e-7)*z
+        + 2.48015872888517045348e-5)*z - 1.38888888888730564116e-3)*z
+        + 4.16666666666665929218e-2);
+    const V1 res = select(swap, sn, cs);
+
+    return select(neg, -res, res);
+  }
+};
+
+/**
+ * Vectorised transcendental functions, single precision.
+ */
+template<>
+struct simd_transcendental<float> {
+  /**
+   * Exponential.
+   */
+  template<class V1>
+  static V1 exp(const V1 x) {
+    const V1 x1 = min(max(x, simd_splat<V1>(-103.98f)),
+        simd_splat<V1>(88.73f));
+
+    /* range reduction, x = n*log(2) + r with |r| <= log(2)/2 */
+    const V1 n = simd_rint<V1,float>(x1*1.44269504088896341f);
+    const V1 r = (x1 - n*0.693359375f) + n*2.12194440e-4f;
+
+    /* polynomial approximation of exp(r) */
+    const V1 rr = r*r;
+    const V1 e = (((((1.9875691500e-4f*r + 1.3981999507e-3f)*r
+        + 8.3334519073e-3f)*r + 4.1665795894e-2f)*r + 1.6666665459e-1f)*r
+        + 5.0000001201e-1f)*rr + r + 1.0f;
+
+    /* scale by 2^n in two steps, so that neither factor over or
+     * underflows */
+    const V1 h = simd_rint<V1,float>(0.5f*n);
+    const V1 res = e*exp2i(h)*exp2i(n - h);
+
+    return select(x != x, x, res);
+  }
+
+  /**
+   * Natural logarithm.
+   */
+  template<class V1>
+  static V1 log(const V1 x) {
+    const V1 zero = simd_splat<V1>(0.0f);
+    const V1 inf = simd_splat<V1>(std::numeric_limits<float>::infinity());
+
+    /* scale subnormals into the normal range */
+    const V1 small = x < simd_splat<V1>(1.17549435e-38f);
+    const V1 x1 = select(small, x*33554432.0f, x);
+    V1 e, m;
+    m = frexp(x1, e);
+    e = e - select(small, simd_splat<V1>(25.0f), zero);
+
+    /* m in [sqrt(1/2), sqrt(2)), less one */
+    const V1 lt = m < simd_splat<V1>(0.707106781186547524f);
+    e = e - select(lt, simd_splat<V1>(1.0f), zero);
+    m = select(lt, m + m, m) - 1.0f;
+
+    /* polynomial approximation of log(1 + m) */
+    const V1 z = m*m;
+    V1 y = ((((((((7.0376836292e-2f*m - 1.1514610310e-1f)*m
+        + 1.1676998740e-1f)*m - 1.2420140846e-1f)*m + 1.4249322787e-1f)*m
+        - 1.6668057665e-1f)*m + 2.0000714765e-1f)*m - 2.4999993993e-1f)*m
+        + 3.3333331174e-1f)*m*z;
+    y = y - e*2.12194440e-4f;
+    y = y - 0.5f*z;
+    V1 res = (m + y) + e*0.693359375f;
+
+    /* special values */
+    res = select(x == inf, inf, res);
+    res = select(x == zero, -inf, res);
+    res = select(x < zero,
+        simd_splat<V1>(std::numeric_limits<float>::quiet_NaN()), res);
+    return select(x != x, x, res);
+  }
+
+  /**
+   * Natural logarithm in extended precision, for positive finite @p x.
+   *
+   * @param x Argument.
+   * @param[out] lo Low part of the result.
+   *
+   * @return High part of the result. The sum of the high and low parts has
+   * a relative error of less than \f$2^{-30}\f$.
+   */
+  template<class V1>
+  static V1 log_ext(const V1 x, V1& lo) {
+    const V1 zero = simd_splat<V1>(0.0f);
+
+    /* scale subnormals into the normal range */
+    const V1 small = x < simd_splat<V1>(1.17549435e-38f);
+    const V1 x1 = select(small, x*33554432.0f, x);
+    V1 e, m;
+    m = frexp(x1, e);
+    e = e - select(small, simd_splat<V1>(25.0f), zero);
+
+    /* m in [sqrt(1/2), sqrt(2)), less one, exactly */
+    const V1 lt = m < simd_splat<V1>(0.707106781186547524f);
+    e = e - select(lt, simd_splat<V1>(1.0f), zero);
+    const V1 f = select(lt, m + m, m) - 1.0f;
+
+    /* log(1 + f) = 2*atanh(s) with s = f/(2 + f); 2 + f and s are each
+     * carried as the sum of two terms */
+    const V1 u = 2.0f + f;
+    const V1 ulo = f - (u - 2.0f);
+    const V1 s = f/u;
+    const V1 su = s*u;
+    const V1 slo = (((f - su) - mul_err(s, u, su)) - s*ulo)/u;
+
+    /* 2*atanh(s) = 2*s + c*s^3 + s^3*z*R(z) with z = s^2, minimax, and
+     * c split in two; the terms in s and s^3 are carried in extended
+     * precision */
+    const V1 c = simd_splat<V1>(6.666666269e-1f);
+    const V1 z = s*s;
+    const V1 zlo = mul_err(s, s, z);
+    const V1 s3 = s*z;
+    const V1 s3lo = mul_err(s, z, s3) + s*zlo;
+    const V1 r1 = s3*c;
+    const V1 r1lo = (mul_err(s3, c, r1) + s3lo*c) + s3*2.952424083e-8f;
+    const V1 r2 = s3*z*((2.358215234e-1f*z + 2.853730848e-1f)*z
+        + 4.000033519e-1f);
+
+    /* e*log(2) + 2*s + c*s^3, with log(2) split so that the first product
+     * is exact, then the remaining terms, smallest first */
+    const V1 a = e*0.693145751953125f;
+    const V1 b = s + s;
+    const V1 hi1 = a + b;
+    const V1 b1 = hi1 - a;
+    const V1 hi = hi1 + r1;
+    const V1 b2 = hi - hi1;
+    lo = ((a - (hi1 - b1)) + (b - b1)) + ((hi1 - (hi - b2)) + (r1 - b2));
+    lo = lo + ((r2 + (r1lo + (slo + slo)*(1.0f + z)))
+        + e*1.42860682030941723212e-6f);
+
+    const V1 res = hi + lo;
+    lo = lo - (res - hi);
+    return res;
+  }
+
+  /**
+   * Minimax rational approximations of
+   * \f$\ln\Gamma(x)/((x - 1)(x - 2))\f$ on \f$[1,2]\f$ and \f$[2,3]\f$,
+   * in the form \f$c + tR(t)\f$, with relative error less than
+   * \f$2^{-30}\f$.
+   *
+   * @param t \f$x - 1\f$ where @p lower is set, \f$x - 2\f$ elsewhere.
+   * @param lower Mask of elements of @p t on \f$[1,2]\f$ rather than
+   * \f$[2,3]\f$.
+   */
+  template<class V1>
+  static V1 lgamma_rational(const V1 t, const V1 lower) {
+    const V1 p1 = ((-2.5620879322e-4f*t - 5.772736288e-2f)*t
+        - 2.6040134961e-1f)*t - 2.4525136834e-1f;
+    const V1 q1 = ((1.1372970161e-1f*t + 8.4047531389e-1f)*t
+        + 1.6955485024e0f)*t + 1.0f;
+    const V1 p2 = ((-1.508618562e-5f*t - 6.7777973962e-3f)*t
+        - 5.6476563899e-2f)*t - 1.0031730167e-1f;
+    const V1 q2 = ((1.7823115176e-2f*t + 2.3709531781e-1f)*t
+        + 8.9158662402e-1f)*t + 1.0f;
+    const V1 c = select(lower, simd_splat<V1>(0.577215665f),
+        simd_splat<V1>(0.422784335f));
+
+    return c + t*(select(lower, p1, p2)/select(lower, q1, q2));
+  }
+
+  /**
+   * Cosine of \f$2\pi u\f$.
+   */
+  template<class V1>
+  static V1 cos2pi(const V1 u) {
+    /* reduce to a quarter turn, using symmetries about 1/4 and 1/8 turn;
+     * each subtraction is exact */
+    const V1 a = abs(u - simd_rint<V1,float>(u));
+    const V1 neg = a > simd_splat<V1>(0.25f);
+    const V1 b = select(neg, 0.5f - a, a);
+    const V1 swap = b > simd_splat<V1>(0.125f);
+    const V1 x = select(swap, 0.25f - b, b)*6.28318530717958647693f;
+
+    /* polynomial approximations of sin(x) and cos(x) on [0,pi/4] */
+    const V1 z = x*x;
+    const V1 sn = x + x*z*((-1.9515295891e-4f*z + 8.3321608736e-3f)*z
+        - 1.6666654611e-1f);
+    const V1 cs = 1.0f - 0.5f*z + z*z*((2.443315711809948e-5f*z
+        - 1.388731625493765e-3f)*z + 4.166664568298827e-2f);
+    const V1 res = select(swap, sn, cs);
+
+    return select(neg, -res, res);
+  }
+};
+
+/**
+ * Vectorised \f$\log(1 + x)\f$.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+V1 simd_log1p(const V1 x) {
+  const T1 one = static_cast<T1>(1.0);
+  const V1 u = one + x;
+  const V1 d = u - one;
+
+  /* log(u) is exact for the rounded u, correct for the rounding error in
+   * 1 + x (Goldberg, 1991) */
+  V1 res = simd_transcendental<T1>::log(u)*(x/d);
+  res = select(d == simd_splat<V1>(static_cast<T1>(0.0)), x, res);
+  return select(x == simd_splat<V1>(std::numeric_limits<T1>::infinity()), x,
+      res);
+}
+
+/**
+ * Vectorised \f$\exp(x) - 1\f$.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+V1 simd_expm1(const V1 x) {
+  const T1 one = static_cast<T1>(1.0);
+  const V1 u = simd_transcendental<T1>::exp(x);
+  const V1 d = u - one;
+
+  /* correct for the rounding error in exp(x) (Kahan) */
+  V1 res = d*(x/simd_transcendental<T1>::log(u));
+  res = select(u == simd_splat<V1>(one), x, res);
+  res = select(d == simd_splat<V1>(-one), d, res);
+  return select(u == simd_splat<V1>(std::numeric_limits<T1>::infinity()), u,
+      res);
+}
+
+/**
+ * Mask of arguments for which simd_pow() does not apply.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+V1 simd_pow_special(const V1 x, const V1 y) {
+  const V1 zero = simd_splat<V1>(static_cast<T1>(0.0));
+  const V1 inf = simd_splat<V1>(std::numeric_limits<T1>::infinity());
+  const V1 ok = select(x > zero, select(x < inf, abs(y) < inf, zero), zero);
+  return select(ok, zero, zero == zero);
+}
+
+/**
+ * Vectorised power, for positive finite @p x and finite @p y.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ *
+ * The logarithm of @p x, and its product with @p y, are carried in
+ * extended precision, so that the error does not grow with the magnitude
+ * of the result.
+ */
+template<class V1, class T1>
+V1 simd_pow(const V1 x, const V1 y) {
+  const V1 zero = simd_splat<V1>(static_cast<T1>(0.0));
+  const V1 one = simd_splat<V1>(static_cast<T1>(1.0));
+  const V1 inf = simd_splat<V1>(std::numeric_limits<T1>::infinity());
+
+  V1 lo;
+  const V1 hi = simd_transcendental<T1>::log_ext(x, lo);
+  const V1 z = y*hi;
+
+  /* the low part only matters where exp(z) neither over nor underflows,
+   * and is not finite for y large enough that z certainly does */
+  V1 zlo = mul_err(y, hi, z) + y*lo;
+  zlo = select(abs(z) < simd_splat<V1>(static_cast<T1>(1024.0)), zlo, zero);
+
+  const V1 e = simd_transcendental<T1>::exp(z);
+  const V1 res = select(e < inf, e + e*zlo, e);
+  return select(x == one, one, res);
+}
+
+/**
+ * Mask of arguments for which simd_lgamma() does not apply.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ */
+template<class V1, class T1>
+V1 simd_lgamma_special(const V1 x) {
+  const V1 zero = simd_splat<V1>(static_cast<T1>(0.0));
+  const V1 inf = simd_splat<V1>(std::numeric_limits<T1>::infinity());
+  const V1 ok = select(x > zero, x < inf, zero);
+  return select(ok, zero, zero == zero);
+}
+
+/**
+ * Vectorised logarithm of the gamma function, for positive finite @p x.
+ *
+ * @tparam V1 SIMD vector type.
+ * @tparam T1 Scalar type.
+ *
+ * On \f$[1,3]\f$, \f$\ln\Gamma(x) = (x - 1)(x - 2)R(x)\f$, with @c R
+ * minimax rational approximations on \f$[1,2]\f$ and \f$[2,3]\f$, so
+ * that the relative error is also small near the zeros at 1 and 2. Below
+ * 1, the recurrence \f$\Gamma(x + 1) = x\Gamma(x)\f$ shifts the argument
+ * up by one, and between 3 and 8 shifts it down into \f$[2,3)\f$. From 8
+ * the Stirling series is used.
+ */
+template<class V1, class T1>
+V1 simd_lgamma(const V1 x) {
+  const V1 one = simd_splat<V1>(static_cast<T1>(1.0));
+  const V1 two = simd_splat<V1>(static_cast<T1>(2.0));
+  const V1 three = simd_splat<V1>(static_cast<T1>(3.0));
+  const V1 eight = simd_splat<V1>(static_cast<T1>(8.0));
+
+  /* shift down into [2,3) from at most 8, accumulating the product of the
+   * factors removed; each subtraction is exact */
+  const V1 lt = x < one;
+  const V1 big = x >= eight;
+  V1 u = select(big, two, x), p = one, gt;
+  for (int i = 0; i < 5; ++i) {
+    gt = u >= three;
+    u = select(gt, u - one, u);
+    p = select(gt, p*u, p);
+  }
+
+  /* one logarithm serves all three ranges */
+  const V1 l = simd_transcendental<T1>::log(select(lt, x, select(big, x,
+      p)));
+
+  /* below 1, (x + 1) - 1 is just x, and (x + 1) - 2 is x - 1, which avoids
+   * rounding x + 1; elsewhere each subtraction is exact */
+  const V1 lower = select(lt, lt, u < two);
+  const V1 t = select(lt, x, select(lower, u - one, u - two));
+  const V1 res = t*select(lower, t - one, t + one)*
+      simd_transcendental<T1>::lgamma_rational(t, lower) + select(lt, -l, l);
+
+  if (any(big)) {
+    const V1 z = select(big, x, eight);
+    const V1 zi = one/z;
+    const V1 zi2 = zi*zi;
+    const V1 series = zi*((((((static_cast<T1>(1.0/156.0)*zi2
+        - static_cast<T1>(691.0/360360.0))*zi2
+        + static_cast<T1>(1.0/1188.0))*zi2
+        - static_cast<T1>(1.0/1680.0))*zi2
+        + static_cast<T1>(1.0/1260.0))*zi2
+        - static_cast<T1>(1.0/360.0))*zi2
+        + static_cast<T1>(1.0/12.0));
+
+    /* Stirling, as (z - 1/2)(log(z) - 1) + log(2*pi)/2 - 1/2 + series */
+    return select(big, (z - static_cast<T1>(0.5))*(l - one)
+        + static_cast<T1>(0.41893853320467274178) + series, res);
+  } else {
+    return res;
+  }
+}
+
+}
+
+#endif
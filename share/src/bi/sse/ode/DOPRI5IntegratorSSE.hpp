@@ -11,6 +11,11 @@
 namespace bi {
 /**
  * @copydoc DOPRI5Integrator
+ *
+ * Lanes of the SIMD vectors are refilled from a shared queue of waiting
+ * particles as they finish, as for RK43IntegratorSSE. The first stage of a
+ * step is recomputed for all lanes after a refill, rather than reused from
+ * the last stage of the previous step.
  */
 template<class B, class S, class T1>
 class DOPRI5IntegratorSSE {
@@ -18,11 +23,14 @@ public:
   /**
    * @copydoc DOPRI5Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
 };
 }
 
+#include "IntegratorLanesSSE.hpp"
 #include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../host/ode/DOPRI5VisitorHost.hpp"
 #include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
@@ -31,104 +39,169 @@ public:
 
 template<class B, class S, class T1>
 void bi::DOPRI5IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+    State<B,ON_HOST>& s, const int k) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
   typedef typename temp_host_vector<simd_real>::type vector_type;
   typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
-  typedef DOPRI5VisitorHost<B,S,S,real,PX,simd_real> Visitor;
+  typedef DOPRI5VisitorHost<B,S,S,simd_real,PX,simd_real> Visitor;
   static const int N = block_size<S>::value;
+  static const int W = BI_SIMD_SIZE;
   const int P = s.size();
+  int next = 0;
+
+  IntegratorLanesSSE<B>::init();
 
   #pragma omp parallel
   {
+    State<B,ON_HOST>& s1 = IntegratorLanesSSE<B>::get();
     vector_type x0(N), x1(N), x2(N), x3(N), x4(N), x5(N), x6(N), err(N), k1(
         N), k7(N);
-    simd_real e, e2;
-    real t, h, logfacold, logfac11, fac, e2max;
-    int n, id, p;
-    bool k1in;
+    simd_real t, h;
+    real logfacold[W], h1[W], e2[W], logfac11, fac, e;
+    int q[W], n[W], nactive = 0, id, l;
+    bool k1in = false, refill = true;
     PX pax;
 
-    #pragma omp for
-    for (p = 0; p < P; p += BI_SIMD_SIZE) {
-      t = t1;
-      h = h_h0;
-      logfacold = bi::log(BI_REAL(1.0e-4));
-      k1in = false;
-      n = 0;
-      sse_host_load<B,S>(s, p, x0);
-
-      /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
-        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-          h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
+    /* lane views of SIMD values, lane l of element id at id*W + l */
+    real* const tl = reinterpret_cast<real*>(&t);
+    real* const hl = reinterpret_cast<real*>(&h);
+    real* const x0l = reinterpret_cast<real*>(x0.buf());
+    real* const x6l = reinterpret_cast<real*>(x6.buf());
+    real* const k1l = reinterpret_cast<real*>(k1.buf());
+    real* const k7l = reinterpret_cast<real*>(k7.buf());
+    real* const errl = reinterpret_cast<real*>(err.buf());
+
+    s1.copyCommon(s);
+    for (l = 0; l < W; ++l) {
+      q[l] = -1;
+      tl[l] = t1;
+      hl[l] = BI_REAL(0.0);
+    }
+
+    while (true) {
+      /* refill empty lanes from queue of waiting particles */
+      if (refill) {
+        for (l = 0; l < W; ++l) {
+          if (q[l] < 0) {
+            #pragma omp atomic capture
+            q[l] = next++;
+            if (q[l] >= P) {
+              q[l] = -1;
+            }
+            if (q[l] >= 0) {
+              s1.copyTrajectory(l, s, q[l]);
+              tl[l] = t1;
+              if (s1.getStepSize(l, k) > BI_REAL(0.0)) {
+                /* resume from last integration */
+                hl[l] = s1.getStepSize(l, k);
+                logfacold[l] = s1.getStepFactor(l, k);
+              } else {
+                hl[l] = h_h0;
+                logfacold[l] = bi::log(BI_REAL(1.0e-4));
+              }
+              n[l] = 0;
+              ++nactive;
+              k1in = false; // new lane has no first stage from last step
+            }
           }
         }
+        sse_host_load<B,S>(s1, 0, x0);
+        refill = false;
+      }
+      if (nactive == 0) {
+        break;
+      }
 
-        /* stages */
-        Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
-        k1in = true; // can reuse from previous iteration in future
-        sse_host_store<B,S>(s, p, x1);
+      /* truncate steps at end of interval */
+      for (l = 0; l < W; ++l) {
+        h1[l] = hl[l];
+        if (q[l] >= 0 && tl[l] + BI_REAL(1.01)*hl[l] - t2 > BI_REAL(0.0)) {
+          hl[l] = t2 - tl[l];
+        }
+      }
 
-        Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        sse_host_store<B,S>(s, p, x2);
+      /* stages */
+      Visitor::stage1(t, h, s1, 0, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
+      k1in = true; // can reuse from previous iteration in future
+      sse_host_store<B,S>(s1, 0, x1);
 
-        Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        sse_host_store<B,S>(s, p, x3);
+      Visitor::stage2(t, h, s1, 0, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, x2);
 
-        Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        sse_host_store<B,S>(s, p, x4);
+      Visitor::stage3(t, h, s1, 0, pax, x0.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, x3);
 
-        Visitor::stage5(t, h, s, p, pax, x0.buf(), x5.buf(), x6.buf(), err.buf());
-        sse_host_store<B,S>(s, p, x5);
+      Visitor::stage4(t, h, s1, 0, pax, x0.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, x4);
 
-        Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+      Visitor::stage5(t, h, s1, 0, pax, x0.buf(), x5.buf(), x6.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, x5);
 
-        /* compute error */
-        Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
+      Visitor::stage6(t, h, s1, 0, pax, x0.buf(), x6.buf(), err.buf());
 
-        /* determine largest error among trajectories */
-        e2 = BI_REAL(0.0);
-        for (id = 0; id < N; ++id) {
-          e = err[id]*h/(bi::max(bi::abs(x0(id)), bi::abs(x6(id)))*h_rtoler + h_atoler);
-          e2 += e*e;
-        }
+      /* compute error */
+      Visitor::stageErr(t, h, s1, 0, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
 
-        e2max = bi::max_reduce(e2)/N;
-        if (e2max <= BI_REAL(1.0)) {
-          /* accept */
-          t += h;
-          x0.swap(x6);
-          k1.swap(k7);
+      /* compute error of each lane */
+      for (l = 0; l < W; ++l) {
+        e2[l] = BI_REAL(0.0);
+      }
+      for (id = 0; id < N; ++id) {
+        for (l = 0; l < W; ++l) {
+          e = errl[id*W + l]*hl[l]/(bi::max(bi::abs(x0l[id*W + l]), bi::abs(x6l[id*W + l]))*h_rtoler + h_atoler);
+          e2[l] += e*e;
         }
-        sse_host_store<B,S>(s, p, x0);
-
-        /* compute next step size */
-        if (t < t2) {
-          logfac11 = h_expo*bi::log(e2max);
-          if (e2max > BI_REAL(1.0)) {
-            /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
-          } else {
-            /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
-            h *= fac;
-            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2max, BI_REAL(1.0e-8)));
+      }
+
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0) {
+          e2[l] /= N;
+          if (e2[l] <= BI_REAL(1.0)) {
+            /* accept */
+            tl[l] += hl[l];
+            for (id = 0; id < N; ++id) {
+              x0l[id*W + l] = x6l[id*W + l];
+              k1l[id*W + l] = k7l[id*W + l];
+            }
           }
-        }
 
-        ++n;
+          /* compute next step size */
+          if (tl[l] < t2) {
+            logfac11 = h_expo*bi::log(e2[l]);
+            if (e2[l] > BI_REAL(1.0)) {
+              /* step was rejected */
+              hl[l] *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+            } else {
+              /* step was accepted */
+              fac = bi::exp(h_beta*logfacold[l] + h_logsafe - logfac11); // Lund-stabilization
+              fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
+              hl[l] *= fac;
+              logfacold[l] = BI_REAL(0.5)*bi::log(bi::max(e2[l], BI_REAL(1.0e-8)));
+            }
+          }
+          ++n[l];
+        }
+      }
+      sse_host_store<B,S>(s1, 0, x0);
+
+      /* retire finished lanes */
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0 && (tl[l] >= t2 || hl[l] <= BI_REAL(0.0) || n[l] >= h_nsteps)) {
+          s1.getStepSize(l, k) = (tl[l] < t2) ? hl[l] : h1[l];
+          s1.getStepFactor(l, k) = logfacold[l];
+          s.copyTrajectory(q[l], s1, l);
+          q[l] = -1;
+          tl[l] = t1;
+          hl[l] = BI_REAL(0.0);
+          --nactive;
+          refill = true;
+        }
       }
     }
+
+    bi_omp_barrier();
   }
 }
 
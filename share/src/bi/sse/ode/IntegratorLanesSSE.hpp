@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_ODE_INTEGRATORLANESSSE_HPP
+#define BI_SSE_ODE_INTEGRATORLANESSSE_HPP
+
+#include "../math/scalar.hpp"
+#include "../../state/State.hpp"
+#include "../../misc/omp.hpp"
+
+#include "boost/shared_ptr.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Per-thread states holding the SIMD lanes of the adaptive SSE integrators.
+ *
+ * @tparam B Model type.
+ *
+ * Each thread keeps one state of #BI_SIMD_SIZE trajectories, created on its
+ * first use and reused by all later calls, rather than allocating a new
+ * state on every call to an integrator.
+ */
+template<class B>
+class IntegratorLanesSSE {
+public:
+  /**
+   * Make room for the states of all threads. Call before entering the
+   * parallel region in which get() is used.
+   */
+  static void init();
+
+  /**
+   * Get the state of the calling thread.
+   */
+  static State<B,ON_HOST>& get();
+
+private:
+  /**
+   * States, indexed by thread.
+   */
+  static std::vector<boost::shared_ptr<State<B,ON_HOST> > > states;
+};
+}
+
+template<class B>
+std::vector<boost::shared_ptr<bi::State<B,bi::ON_HOST> > > bi::IntegratorLanesSSE<
+    B>::states;
+
+template<class B>
+void bi::IntegratorLanesSSE<B>::init() {
+  const int T = bi::max(bi_omp_max_threads, 1);
+
+  if (T > (int)states.size()) {
+    /* this outer conditional avoids the critical section most the time, but
+     * multiple threads may get this far */
+    #pragma omp critical(IntegratorLanesSSE_init)
+    {
+      if (T > (int)states.size()) {
+        states.resize(T);
+      }
+    }
+  }
+}
+
+template<class B>
+bi::State<B,bi::ON_HOST>& bi::IntegratorLanesSSE<B>::get() {
+  /* pre-condition */
+  BI_ASSERT(bi_omp_tid < (int)states.size());
+
+  boost::shared_ptr<State<B,ON_HOST> >& s = states[bi_omp_tid];
+  if (s.get() == NULL) {
+    s.reset(new State<B,ON_HOST>(BI_SIMD_SIZE));
+  }
+  return *s;
+}
+
+#endif
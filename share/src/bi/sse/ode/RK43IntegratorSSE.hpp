@@ -11,6 +11,14 @@
 namespace bi {
 /**
  * @copydoc RK43Integrator
+ *
+ * Each lane of the SIMD vectors integrates its own particle, with its own
+ * time and step size. When a lane reaches the end of the interval, its
+ * particle is written back and the lane is refilled from a queue of
+ * waiting particles shared by all threads, so that lanes do not sit idle
+ * waiting for the slowest particle of their vector. Particles are claimed
+ * from the queue with an atomic increment, and lanes are held in a
+ * per-thread State that is kept between calls (see IntegratorLanesSSE).
  */
 template<class B, class S, class T1>
 class RK43IntegratorSSE {
@@ -18,11 +26,14 @@ public:
   /**
    * @copydoc RK43Integrator::integrate()
    */
-  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
 };
 }
 
+#include "IntegratorLanesSSE.hpp"
 #include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../host/ode/RK43VisitorHost.hpp"
 #include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
@@ -31,100 +42,163 @@ public:
 
 template<class B, class S, class T1>
 void bi::RK43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
-    State<B,ON_HOST>& s) {
+    State<B,ON_HOST>& s, const int k) {
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
   typedef typename temp_host_vector<simd_real>::type vector_type;
   typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
-  typedef RK43VisitorHost<B,S,S,real,PX,simd_real> Visitor;
+  typedef RK43VisitorHost<B,S,S,simd_real,PX,simd_real> Visitor;
   static const int N = block_size<S>::value;
+  static const int W = BI_SIMD_SIZE;
   const int P = s.size();
+  int next = 0;
+
+  IntegratorLanesSSE<B>::init();
 
   #pragma omp parallel
   {
+    State<B,ON_HOST>& s1 = IntegratorLanesSSE<B>::get();
     vector_type r1(N), r2(N), err(N), old(N);
-    simd_real e, e2;
-    real t, h, logfacold, logfac11, fac, e2max;
-    int n, id, p;
+    simd_real t, h;
+    real logfacold[W], h1[W], e2[W], logfac11, fac, e;
+    int q[W], n[W], nactive = 0, id, l;
+    bool refill = true;
     PX pax;
 
-    #pragma omp for
-    for (p = 0; p < P; p += BI_SIMD_SIZE) {
-      t = t1;
-      h = h_h0;
-      logfacold = bi::log(BI_REAL(1.0e-4));
-      n = 0;
-      sse_host_load<B,S>(s, p, old);
-      r1 = old;
-
-      /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
-        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-          h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
+    /* lane views of SIMD values, lane l of element id at id*W + l */
+    real* const tl = reinterpret_cast<real*>(&t);
+    real* const hl = reinterpret_cast<real*>(&h);
+    real* const r1l = reinterpret_cast<real*>(r1.buf());
+    real* const oldl = reinterpret_cast<real*>(old.buf());
+    real* const errl = reinterpret_cast<real*>(err.buf());
+
+    s1.copyCommon(s);
+    for (l = 0; l < W; ++l) {
+      q[l] = -1;
+      tl[l] = t1;
+      hl[l] = BI_REAL(0.0);
+    }
+
+    while (true) {
+      /* refill empty lanes from queue of waiting particles */
+      if (refill) {
+        for (l = 0; l < W; ++l) {
+          if (q[l] < 0) {
+            #pragma omp atomic capture
+            q[l] = next++;
+            if (q[l] >= P) {
+              q[l] = -1;
+            }
+            if (q[l] >= 0) {
+              s1.copyTrajectory(l, s, q[l]);
+              tl[l] = t1;
+              if (s1.getStepSize(l, k) > BI_REAL(0.0)) {
+                /* resume from last integration */
+                hl[l] = s1.getStepSize(l, k);
+                logfacold[l] = s1.getStepFactor(l, k);
+              } else {
+                hl[l] = h_h0;
+                logfacold[l] = bi::log(BI_REAL(1.0e-4));
+              }
+              n[l] = 0;
+              ++nactive;
+            }
           }
         }
+        sse_host_load<B,S>(s1, 0, old);
+        r1 = old;
+        refill = false;
+      }
+      if (nactive == 0) {
+        break;
+      }
 
-        /* stages */
-        Visitor::stage1(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
-        sse_host_store<B,S>(s, p, r1);
+      /* truncate steps at end of interval */
+      for (l = 0; l < W; ++l) {
+        h1[l] = hl[l];
+        if (q[l] >= 0 && tl[l] + BI_REAL(1.01)*hl[l] - t2 > BI_REAL(0.0)) {
+          hl[l] = t2 - tl[l];
+        }
+      }
 
-        Visitor::stage2(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
-        sse_host_store<B,S>(s, p, r2);
+      /* stages */
+      Visitor::stage1(t, h, s1, 0, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, r1);
 
-        Visitor::stage3(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
-        sse_host_store<B,S>(s, p, r1);
+      Visitor::stage2(t, h, s1, 0, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, r2);
 
-        Visitor::stage4(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
-        sse_host_store<B,S>(s, p, r2);
+      Visitor::stage3(t, h, s1, 0, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, r1);
 
-        Visitor::stage5(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
-        sse_host_store<B,S>(s, p, r1);
+      Visitor::stage4(t, h, s1, 0, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s1, 0, r2);
 
-        /* determine largest error among trajectories */
-        e2 = BI_REAL(0.0);
-        for (id = 0; id < N; ++id) {
-          e = err(id)*h/(bi::max(bi::abs(old(id)), bi::abs(r1(id)))*h_rtoler + h_atoler);
-          e2 += e*e;
-        }
+      Visitor::stage5(t, h, s1, 0, pax, r1.buf(), r2.buf(), err.buf());
 
-        e2max = bi::max_reduce(e2)/N;
-        if (e2max <= BI_REAL(1.0)) {
-          /* accept */
-          t += h;
-          if (t < t2) {
-            old = r1;
-          }
-        } else {
-          /* reject */
-          r1 = old;
-          sse_host_store<B,S>(s, p, old);
+      /* compute error of each lane */
+      for (l = 0; l < W; ++l) {
+        e2[l] = BI_REAL(0.0);
+      }
+      for (id = 0; id < N; ++id) {
+        for (l = 0; l < W; ++l) {
+          e = errl[id*W + l]*hl[l]/(bi::max(bi::abs(oldl[id*W + l]), bi::abs(r1l[id*W + l]))*h_rtoler + h_atoler);
+          e2[l] += e*e;
         }
+      }
 
-        /* compute next step size */
-        if (t < t2) {
-          logfac11 = h_expo*bi::log(e2max);
-          if (e2max > BI_REAL(1.0)) {
-            /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0) {
+          e2[l] /= N;
+          if (e2[l] <= BI_REAL(1.0)) {
+            /* accept */
+            tl[l] += hl[l];
+            for (id = 0; id < N; ++id) {
+              oldl[id*W + l] = r1l[id*W + l];
+            }
           } else {
-            /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
-            h *= fac;
-            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2max, BI_REAL(1.0e-8)));
+            /* reject */
+            for (id = 0; id < N; ++id) {
+              r1l[id*W + l] = oldl[id*W + l];
+            }
           }
-        }
 
-        ++n;
+          /* compute next step size */
+          if (tl[l] < t2) {
+            logfac11 = h_expo*bi::log(e2[l]);
+            if (e2[l] > BI_REAL(1.0)) {
+              /* step was rejected */
+              hl[l] *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+            } else {
+              /* step was accepted */
+              fac = bi::exp(h_beta*logfacold[l] + h_logsafe - logfac11); // Lund-stabilization
+              fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
+              hl[l] *= fac;
+              logfacold[l] = BI_REAL(0.5)*bi::log(bi::max(e2[l], BI_REAL(1.0e-8)));
+            }
+          }
+          ++n[l];
+        }
+      }
+      sse_host_store<B,S>(s1, 0, r1);
+
+      /* retire finished lanes */
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0 && (tl[l] >= t2 || hl[l] <= BI_REAL(0.0) || n[l] >= h_nsteps)) {
+          s1.getStepSize(l, k) = (tl[l] < t2) ? hl[l] : h1[l];
+          s1.getStepFactor(l, k) = logfacold[l];
+          s.copyTrajectory(q[l], s1, l);
+          q[l] = -1;
+          tl[l] = t1;
+          hl[l] = BI_REAL(0.0);
+          --nactive;
+          refill = true;
+        }
       }
     }
+
+    bi_omp_barrier();
   }
 }
 
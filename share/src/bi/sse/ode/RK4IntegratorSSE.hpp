@@ -23,6 +23,7 @@ public:
 }
 
 #include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../host/ode/RK4VisitorHost.hpp"
 #include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
@@ -48,7 +49,7 @@ void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
     int p;
     PX pax;
 
-    #pragma omp for
+    #pragma omp for schedule(runtime) nowait
     for (p = 0; p < P; p += BI_SIMD_SIZE) {
       t = t1;
       h = h_h0;
@@ -83,6 +84,8 @@ void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
         t += h;
       }
     }
+
+    bi_omp_barrier();
   }
 }
 
@@ -0,0 +1,271 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_ODE_ROS43INTEGRATORSSE_HPP
+#define BI_SSE_ODE_ROS43INTEGRATORSSE_HPP
+
+namespace bi {
+/**
+ * @copydoc ROS43Integrator
+ *
+ * Time derivatives and Jacobians are evaluated for all lanes of the SIMD
+ * vectors at once, each lane integrating its own particle with its own
+ * time and step size. The LU decompositions and linear solves, which need
+ * a different pivoting in each lane, are done one lane at a time. Lanes
+ * are refilled from a queue of waiting particles as for RK43IntegratorSSE.
+ */
+template<class B, class S, class T1>
+class ROS43IntegratorSSE {
+public:
+  /**
+   * @copydoc ROS43Integrator::integrate()
+   */
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      const int k);
+
+private:
+  /**
+   * Solve linear systems of all lanes.
+   *
+   * @param N Size of system.
+   * @param LU LU decompositions of lanes, one after the other.
+   * @param piv Row interchanges of lanes, one after the other.
+   * @param ok Is the LU decomposition of each lane usable?
+   * @param[in,out] g Right-hand sides on input, solutions on output.
+   * @param[out] b Workspace, of length @p N.
+   */
+  static void solve(const int N, const real* LU, const int* piv,
+      const bool* ok, simd_real* g, real* b);
+};
+}
+
+#include "IntegratorLanesSSE.hpp"
+#include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
+#include "../../host/ode/ROS43IntegratorHost.hpp"
+#include "../../host/ode/ROS43VisitorHost.hpp"
+#include "../../host/ode/IntegratorConstants.hpp"
+#include "../../ode/ROS43Step.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+#include "../../math/constant.hpp"
+
+template<class B, class S, class T1>
+void bi::ROS43IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s, const int k) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  typedef typename temp_host_vector<simd_real>::type vector_type;
+  typedef typename temp_host_vector<real>::type real_vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef ROS43VisitorHost<B,S,S,simd_real,PX,simd_real> Visitor;
+  typedef ROS43Step<simd_real,simd_real> step;
+  typedef ROS43Step<real,real> lane_step;
+  typedef ROS43IntegratorHost<B,S,T1> host_integrator;
+  static const int N = block_size<S>::value;
+  static const int W = BI_SIMD_SIZE;
+  const int P = s.size();
+  int next = 0;
+
+  IntegratorLanesSSE<B>::init();
+
+  #pragma omp parallel
+  {
+    State<B,ON_HOST>& s1 = IntegratorLanesSSE<B>::get();
+    vector_type y0(N), y(N), f(N), g1(N), g2(N), g3(N), g4(N), err(N), J(N*N);
+    real_vector_type LU(W*N*N), b(N);
+    int_vector_type piv(W*N);
+    simd_real t, h;
+    real h1[W], e2[W], e, fac;
+    real* A;
+    bool ok[W], refill = true;
+    int q[W], n[W], nactive = 0, id, l;
+    PX pax;
+
+    /* lane views of SIMD values, lane l of element id at id*W + l */
+    real* const tl = reinterpret_cast<real*>(&t);
+    real* const hl = reinterpret_cast<real*>(&h);
+    real* const y0l = reinterpret_cast<real*>(y0.buf());
+    real* const yl = reinterpret_cast<real*>(y.buf());
+    real* const errl = reinterpret_cast<real*>(err.buf());
+    real* const Jl = reinterpret_cast<real*>(J.buf());
+
+    s1.copyCommon(s);
+    for (l = 0; l < W; ++l) {
+      q[l] = -1;
+      tl[l] = t1;
+      hl[l] = BI_REAL(0.0);
+    }
+
+    while (true) {
+      /* refill empty lanes from queue of waiting particles */
+      if (refill) {
+        for (l = 0; l < W; ++l) {
+          if (q[l] < 0) {
+            #pragma omp atomic capture
+            q[l] = next++;
+            if (q[l] >= P) {
+              q[l] = -1;
+            }
+            if (q[l] >= 0) {
+              s1.copyTrajectory(l, s, q[l]);
+              tl[l] = t1;
+              hl[l] = (s1.getStepSize(l, k) > BI_REAL(0.0)) ? s1.getStepSize(l, k) : h_h0;
+              n[l] = 0;
+              ++nactive;
+            }
+          }
+        }
+        sse_host_load<B,S>(s1, 0, y0);
+        refill = false;
+      }
+      if (nactive == 0) {
+        break;
+      }
+
+      /* truncate steps at end of interval */
+      for (l = 0; l < W; ++l) {
+        h1[l] = hl[l];
+        if (q[l] >= 0 && tl[l] + BI_REAL(1.01)*hl[l] - t2 > BI_REAL(0.0)) {
+          hl[l] = t2 - tl[l];
+        }
+      }
+      sse_host_store<B,S>(s1, 0, y0);
+
+      /* Jacobian and time derivative at start of step */
+      for (id = 0; id < N*N; ++id) {
+        J(id) = BI_REAL(0.0);
+      }
+      Visitor::jacobian(t, s1, 0, pax, J.buf(), N);
+      Visitor::dfdt(t, s1, 0, pax, g1.buf());
+
+      /* factorise iteration matrix of each lane */
+      for (l = 0; l < W; ++l) {
+        A = LU.buf() + l*N*N;
+        for (id = 0; id < N*N; ++id) {
+          A[id] = -Jl[id*W + l];
+        }
+        if (q[l] >= 0) {
+          for (id = 0; id < N; ++id) {
+            A[id + id*N] += lane_step::shift(hl[l]);
+          }
+          ok[l] = host_integrator::factor(N, A, N, piv.buf() + l*N);
+        } else {
+          ok[l] = false;
+        }
+      }
+
+      /* stages */
+      solve(N, LU.buf(), piv.buf(), ok, g1.buf(), b.buf());
+      for (id = 0; id < N; ++id) {
+        step::state2(y0(id), g1(id), y(id));
+      }
+      sse_host_store<B,S>(s1, 0, y);
+      Visitor::dfdt(step::time2(t, h), s1, 0, pax, f.buf());
+      for (id = 0; id < N; ++id) {
+        step::rhs2(h, f(id), g1(id), g2(id));
+      }
+
+      solve(N, LU.buf(), piv.buf(), ok, g2.buf(), b.buf());
+      for (id = 0; id < N; ++id) {
+        step::state3(y0(id), g1(id), g2(id), y(id));
+      }
+      sse_host_store<B,S>(s1, 0, y);
+      Visitor::dfdt(step::time3(t, h), s1, 0, pax, f.buf());
+      for (id = 0; id < N; ++id) {
+        step::rhs3(h, f(id), g1(id), g2(id), g3(id));
+      }
+
+      solve(N, LU.buf(), piv.buf(), ok, g3.buf(), b.buf());
+      for (id = 0; id < N; ++id) {
+        step::rhs4(h, f(id), g1(id), g2(id), g3(id), g4(id));
+      }
+
+      solve(N, LU.buf(), piv.buf(), ok, g4.buf(), b.buf());
+      for (id = 0; id < N; ++id) {
+        step::finish(y0(id), g1(id), g2(id), g3(id), g4(id), y(id), err(id));
+      }
+
+      /* compute error of each lane */
+      for (l = 0; l < W; ++l) {
+        e2[l] = BI_REAL(0.0);
+      }
+      for (id = 0; id < N; ++id) {
+        for (l = 0; l < W; ++l) {
+          e = errl[id*W + l]/(bi::max(bi::abs(y0l[id*W + l]), bi::abs(yl[id*W + l]))*h_rtoler + h_atoler);
+          e2[l] += e*e;
+        }
+      }
+
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0) {
+          e2[l] = ok[l] ? e2[l]/N : BI_INF;
+          if (e2[l] <= BI_REAL(1.0)) {
+            /* accept */
+            tl[l] += hl[l];
+            for (id = 0; id < N; ++id) {
+              y0l[id*W + l] = yl[id*W + l];
+            }
+          }
+
+          /* compute next step size, error estimate is third order */
+          if (tl[l] < t2) {
+            fac = bi::exp(h_logsafe - BI_REAL(0.125)*bi::log(e2[l]));
+            if (!(fac >= h_facl)) {
+              fac = h_facl; // also catches NaN
+            } else if (fac > h_facr) {
+              fac = h_facr;
+            }
+            hl[l] *= fac;
+          }
+          ++n[l];
+        }
+      }
+      sse_host_store<B,S>(s1, 0, y0);
+
+      /* retire finished lanes */
+      for (l = 0; l < W; ++l) {
+        if (q[l] >= 0 && (tl[l] >= t2 || hl[l] <= BI_REAL(0.0) || n[l] >= h_nsteps)) {
+          s1.getStepSize(l, k) = (tl[l] < t2) ? hl[l] : h1[l];
+          s.copyTrajectory(q[l], s1, l);
+          q[l] = -1;
+          tl[l] = t1;
+          hl[l] = BI_REAL(0.0);
+          --nactive;
+          refill = true;
+        }
+      }
+    }
+
+    bi_omp_barrier();
+  }
+}
+
+template<class B, class S, class T1>
+void bi::ROS43IntegratorSSE<B,S,T1>::solve(const int N, const real* LU,
+    const int* piv, const bool* ok, simd_real* g, real* b) {
+  static const int W = BI_SIMD_SIZE;
+  real* const gl = reinterpret_cast<real*>(g);
+  int id, l;
+
+  for (l = 0; l < W; ++l) {
+    if (ok[l]) {
+      for (id = 0; id < N; ++id) {
+        b[id] = gl[id*W + l];
+      }
+      ROS43IntegratorHost<B,S,T1>::solve(N, LU + l*N*N, N, piv + l*N, b);
+      for (id = 0; id < N; ++id) {
+        gl[id*W + l] = b[id];
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_RANDOM_RNGSSE_HPP
+#define BI_SSE_RANDOM_RNGSSE_HPP
+
+#include "../../host/random/PhiloxHost.hpp"
+#include "../math/scalar.hpp"
+
+namespace bi {
+/**
+ * Pseudorandom number generator for SIMD vectors, on host.
+ *
+ * @ingroup math_rng
+ *
+ * Generates one variate in each element of a SIMD vector, the elements
+ * corresponding to consecutive trajectories. Words are produced element by
+ * element with the bijection of PhiloxHost, using the trajectory index as
+ * element index and a draw index that counts up from zero after each call
+ * to #seek. The transformation of words into variates is vectorised.
+ *
+ * Rejection samplers iterate until every element has accepted, so that,
+ * unlike PhiloxHost, the variates of a trajectory depend on those of the
+ * other trajectories in the same vector.
+ */
+class RngSSE {
+public:
+  /**
+   * Constructor.
+   *
+   * @param gen Counter-based generator, usually obtained from
+   * RngHost::nextStream().
+   */
+  RngSSE(const PhiloxHost& gen);
+
+  /**
+   * Move to a vector of trajectories.
+   *
+   * @param p Index of the first trajectory of the vector.
+   */
+  void seek(const int p);
+
+  /**
+   * @copydoc Random::uniform
+   */
+  simd_real uniform(const simd_real lower, const simd_real upper);
+
+  /**
+   * @copydoc Random::gaussian
+   *
+   * Uses the Box-Muller transformation, as PhiloxHost::gaussian.
+   */
+  simd_real gaussian(const simd_real mu, const simd_real sigma);
+
+  /**
+   * @copydoc Random::gamma
+   *
+   * Uses the squeeze and rejection sampling method of
+   * @ref Marsaglia2000 "Marsaglia & Tsang (2000)", as PhiloxHost::gamma.
+   */
+  simd_real gamma(const simd_real alpha, const simd_real beta);
+
+  /**
+   * @copydoc Random::poisson
+   *
+   * Uses inversion by sequential search where \f$\lambda < 10\f$, and the
+   * transformed rejection method with squeeze (PTRS) of
+   * @ref Hormann1993 "H&ouml;rmann (1993)" otherwise.
+   *
+   * @section RngSSE_references References
+   *
+   * @anchor Hormann1993 H&ouml;rmann, W. The transformed rejection method
+   * for generating Poisson random variables. <i>Insurance: Mathematics and
+   * Economics</i>, <b>1993</b>, 12, 39-45.
+   */
+  simd_real poisson(const simd_real lambda);
+
+private:
+  /**
+   * Apply the bijection once for each element, and convert the words to
+   * uniform variates.
+   *
+   * @param[out] u Uniform variates on \f$[0,1)\f$.
+   * @param[out] v Uniform variates on \f$(0,1]\f$.
+   *
+   * The words are used as in PhiloxHost::gaussian, so that #gaussian
+   * reproduces it element by element.
+   */
+  void uniforms(simd_real& u, simd_real& v);
+
+  /**
+   * Generate standard Gaussian variates.
+   */
+  simd_real gaussian();
+
+  /**
+   * Round down to integer.
+   */
+  static simd_real floor(const simd_real x);
+
+  /**
+   * Counter-based generator.
+   */
+  PhiloxHost gen;
+
+  /**
+   * Index of the first trajectory of the current vector.
+   */
+  PhiloxHost::word_type p;
+
+  /**
+   * Draw index.
+   */
+  PhiloxHost::word_type draw;
+};
+}
+
+#include "../../math/constant.hpp"
+#include "../../misc/assert.hpp"
+
+inline bi::RngSSE::RngSSE(const PhiloxHost& gen) :
+    gen(gen), p(0), draw(0) {
+  //
+}
+
+inline void bi::RngSSE::seek(const int p) {
+  this->p = p;
+  this->draw = 0;
+}
+
+inline void bi::RngSSE::uniforms(simd_real& u, simd_real& v) {
+  real* u1 = reinterpret_cast<real*>(&u);
+  real* v1 = reinterpret_cast<real*>(&v);
+  PhiloxHost::word_type w[4];
+  unsigned i;
+
+  for (i = 0; i < BI_SIMD_SIZE; ++i) {
+    gen.bijection(p + i, draw, w);
+    v1[i] = static_cast<real>(1.0 - PhiloxHost::u01(w[0], w[1]));
+    u1[i] = PhiloxHost::u01<real>(w + 2);
+  }
+  ++draw;
+}
+
+inline bi::simd_real bi::RngSSE::floor(const simd_real x) {
+  simd_real one, zero, r;
+  one = BI_REAL(1.0);
+  zero = BI_REAL(0.0);
+  r = simd_rint<simd_real,real>(x);
+
+  return r - select(r > x, one, zero);
+}
+
+inline bi::simd_real bi::RngSSE::uniform(const simd_real lower,
+    const simd_real upper) {
+  /* pre-condition */
+  BI_ASSERT(!any(upper < lower));
+
+  simd_real u, v;
+  uniforms(u, v);
+
+  return lower + (upper - lower)*u;
+}
+
+inline bi::simd_real bi::RngSSE::gaussian() {
+  simd_real u, v;
+  uniforms(u, v);
+
+  return sqrt(BI_REAL(-2.0)*log(v))*simd_transcendental<real>::cos2pi(u);
+}
+
+inline bi::simd_real bi::RngSSE::gaussian(const simd_real mu,
+    const simd_real sigma) {
+  /* pre-condition */
+  BI_ASSERT(!any(sigma < simd_splat<simd_real>(BI_REAL(0.0))));
+
+  return mu + sigma*gaussian();
+}
+
+inline bi::simd_real bi::RngSSE::gamma(const simd_real alpha,
+    const simd_real beta) {
+  simd_real zero, one, yes, no;
+  zero = BI_REAL(0.0);
+  one = BI_REAL(1.0);
+  yes = zero == zero;
+  no = zero != zero;
+
+  /* pre-condition */
+  BI_ASSERT(!any(alpha <= zero) && !any(beta <= zero));
+
+  simd_real d, c, scale, x, x2, v, u, w, accept, done, res;
+
+  /* boost to alpha >= 1 case where necessary */
+  const simd_real boost = alpha < one;
+  d = alpha - BI_REAL(1.0/3.0);
+  scale = one;
+  if (any(boost)) {
+    uniforms(u, w);
+    scale = select(boost, pow(w, one/alpha), one);
+    d = select(boost, d + one, d);
+  }
+  c = one/sqrt(BI_REAL(9.0)*d);
+
+  done = no;
+  res = zero;
+  do {
+    x = gaussian();
+    v = one + c*x;
+    uniforms(u, w);
+
+    x2 = x*x;
+    v = v*v*v;
+    accept = select(w < one - BI_REAL(0.0331)*x2*x2, yes,
+        log(w) < BI_REAL(0.5)*x2 + d - d*v + d*log(v));
+    accept = select(done, no, select(v > zero, accept, no));
+
+    res = select(accept, scale*d*v, res);
+    done = select(accept, yes, done);
+  } while (any(select(done, no, yes)));
+
+  return beta*res;
+}
+
+inline bi::simd_real bi::RngSSE::poisson(const simd_real lambda) {
+  simd_real zero, one, yes, no;
+  zero = BI_REAL(0.0);
+  one = BI_REAL(1.0);
+  yes = zero == zero;
+  no = zero != zero;
+
+  /* pre-condition */
+  BI_ASSERT(!any(lambda < zero));
+
+  simd_real todo, k, u, v, res;
+  const simd_real large = lambda >= simd_splat<simd_real>(BI_REAL(10.0));
+  res = zero;
+
+  /* inversion by sequential search, for small lambda */
+  todo = select(large, no, yes);
+  if (any(todo)) {
+    const simd_real L = exp(-lambda);
+    simd_real prod;
+    prod = one;
+    k = zero;
+    do {
+      uniforms(u, v);
+      prod = prod*u;
+      todo = select(todo, prod > L, no);
+      k = select(todo, k + one, k);
+    } while (any(todo));
+    res = select(large, res, k);
+  }
+
+  /* transformed rejection with squeeze, for large lambda */
+  if (any(large)) {
+    simd_real lam;
+    lam = select(large, lambda, simd_splat<simd_real>(BI_REAL(10.0)));
+
+    const simd_real loglam = log(lam);
+    const simd_real b = BI_REAL(0.931) + BI_REAL(2.53)*sqrt(lam);
+    const simd_real a = BI_REAL(-0.059) + BI_REAL(0.02483)*b;
+    const simd_real loginvalpha = log(BI_REAL(1.1239) +
+        BI_REAL(1.1328)/(b - BI_REAL(3.4)));
+    const simd_real vr = BI_REAL(0.9277) - BI_REAL(3.6224)/(b - BI_REAL(2.0));
+    simd_real us, kk, ten, accept, reject, lhs, rhs;
+    ten = BI_REAL(10.0);
+
+    todo = large;
+    do {
+      uniforms(u, v);
+      u = u - BI_REAL(0.5);
+      us = BI_REAL(0.5) - abs(u);
+      k = floor((BI_REAL(2.0)*a/us + b)*u + lam + BI_REAL(0.43));
+
+      lhs = log(v) + loginvalpha - log(a/(us*us) + b);
+
+      /* k*log(lam) - lam - lgamma(k + 1), using Stirling's series for
+       * larger k to avoid cancellation in single precision */
+      kk = max(k, ten);
+      rhs = k*log(lam/kk) + (k - lam) - BI_REAL(0.5)*log(kk) -
+          BI_REAL(BI_HALF_LOG_TWO_PI) - (BI_REAL(1.0/12.0) -
+          BI_REAL(1.0/360.0)/(kk*kk))/kk;
+      rhs = select(k < ten, k*loglam - lam - lgamma(max(k, zero) + one), rhs);
+      reject = select(k < zero, yes, select(us < simd_splat<simd_real>(
+          BI_REAL(0.013)), v > us, no));
+      accept = select(select(us >= simd_splat<simd_real>(BI_REAL(0.07)),
+          v <= vr, no), yes, select(reject, no, lhs <= rhs));
+      accept = select(todo, accept, no);
+
+      res = select(accept, k, res);
+      todo = select(accept, no, todo);
+    } while (any(todo));
+  }
+
+  return res;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_DYNAMICSAMPLERSSE_HPP
+#define BI_SSE_UPDATER_DYNAMICSAMPLERSSE_HPP
+
+#include "../../random/Random.hpp"
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Dynamic sampler, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class DynamicSamplerSSE {
+public:
+  /**
+   * @copydoc DynamicSampler::samples(Random&, const T1, const T1, State<B,ON_HOST>&)
+   */
+  template<class T1>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      State<B,ON_HOST>& s);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../random/RngSSE.hpp"
+#include "../../host/updater/DynamicSamplerVisitorHost.hpp"
+#include "../../host/updater/DynamicSamplerMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class T1>
+void bi::DynamicSamplerSSE<B,S>::samples(Random& rng, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  typedef RngSSE R1;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef DynamicSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef DynamicSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    R1 rng1(gen);
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      rng1.seek(p);
+      Visitor::accept(rng1, t1, t2, s, p, pax, x);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_SPARSESTATICMAXLOGDENSITYSSE_HPP
+#define BI_SSE_UPDATER_SPARSESTATICMAXLOGDENSITYSSE_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Sparse static maximum log-density evaluator, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class SparseStaticMaxLogDensitySSE {
+public:
+  /**
+   * @copydoc SparseStaticMaxLogDensity::maxLogDensities(State<B,ON_HOST>&, const Mask<ON_HOST>&, V1)
+   */
+  template<class V1>
+  static void maxLogDensities(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask,
+      V1 lp);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../host/updater/SparseStaticMaxLogDensityVisitorHost.hpp"
+#include "../../host/updater/SparseStaticMaxLogDensityMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticMaxLogDensitySSE<B,S>::maxLogDensities(
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, V1 lp) {
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef SparseStaticMaxLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef SparseStaticMaxLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    simd_real* lp1;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      lp1 = reinterpret_cast<simd_real*>(&lp(p));
+      Visitor::accept(s, mask, p, pax, x, *lp1);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_SPARSESTATICSAMPLERSSE_HPP
+#define BI_SSE_UPDATER_SPARSESTATICSAMPLERSSE_HPP
+
+#include "../../random/Random.hpp"
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Sparse static sampler, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class SparseStaticSamplerSSE {
+public:
+  /**
+   * @copydoc SparseStaticSampler::samples(Random&, State<B,ON_HOST>&, const Mask<ON_HOST>&)
+   */
+  static void samples(Random& rng, State<B,ON_HOST>& s,
+      const Mask<ON_HOST>& mask);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../random/RngSSE.hpp"
+#include "../../host/updater/SparseStaticSamplerVisitorHost.hpp"
+#include "../../host/updater/SparseStaticSamplerMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+void bi::SparseStaticSamplerSSE<B,S>::samples(Random& rng,
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask) {
+  typedef RngSSE R1;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef SparseStaticSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef SparseStaticSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    R1 rng1(gen);
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      rng1.seek(p);
+      Visitor::accept(rng1, s, mask, p, pax, x);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_SPARSESTATICUPDATERSSE_HPP
+#define BI_SSE_UPDATER_SPARSESTATICUPDATERSSE_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Sparse static updater, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class SparseStaticUpdaterSSE {
+public:
+  /**
+   * @copydoc SparseStaticUpdater::update(State<B,ON_HOST>&, const Mask<ON_HOST>&)
+   */
+  static void update(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../host/updater/SparseStaticUpdaterVisitorHost.hpp"
+#include "../../host/updater/SparseStaticUpdaterMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+void bi::SparseStaticUpdaterSSE<B,S>::update(State<B,ON_HOST>& s,
+    const Mask<ON_HOST>& mask) {
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef SparseStaticUpdaterMatrixVisitorHost<B,S,ON_HOST,PX,OX> MatrixVisitor;
+  typedef SparseStaticUpdaterVisitorHost<B,S,ON_HOST,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      Visitor::accept(s, mask, p, pax, x);
+    }
+  }
+}
+
+#endif
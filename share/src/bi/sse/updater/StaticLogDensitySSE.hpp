@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_STATICLOGDENSITYSSE_HPP
+#define BI_SSE_UPDATER_STATICLOGDENSITYSSE_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Static log-density evaluator, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class StaticLogDensitySSE {
+public:
+  /**
+   * @copydoc StaticLogDensity::logDensities(State<B,ON_HOST>&, V1)
+   */
+  template<class V1>
+  static void logDensities(State<B,ON_HOST>& s, V1 lp);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../host/updater/StaticLogDensityVisitorHost.hpp"
+#include "../../host/updater/StaticLogDensityMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class V1>
+void bi::StaticLogDensitySSE<B,S>::logDensities(State<B,ON_HOST>& s, V1 lp) {
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef StaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef StaticLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    simd_real* lp1;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      lp1 = reinterpret_cast<simd_real*>(&lp(p));
+      Visitor::accept(s, p, pax, x, *lp1);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_STATICMAXLOGDENSITYSSE_HPP
+#define BI_SSE_UPDATER_STATICMAXLOGDENSITYSSE_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Static maximum log-density evaluator, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class StaticMaxLogDensitySSE {
+public:
+  /**
+   * @copydoc StaticMaxLogDensity::maxLogDensities(State<B,ON_HOST>&, V1)
+   */
+  template<class V1>
+  static void maxLogDensities(State<B,ON_HOST>& s, V1 lp);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../host/updater/StaticMaxLogDensityVisitorHost.hpp"
+#include "../../host/updater/StaticMaxLogDensityMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class V1>
+void bi::StaticMaxLogDensitySSE<B,S>::maxLogDensities(State<B,ON_HOST>& s,
+    V1 lp) {
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef StaticMaxLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef StaticMaxLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    simd_real* lp1;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      lp1 = reinterpret_cast<simd_real*>(&lp(p));
+      Visitor::accept(s, p, pax, x, *lp1);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_STATICSAMPLERSSE_HPP
+#define BI_SSE_UPDATER_STATICSAMPLERSSE_HPP
+
+#include "../../random/Random.hpp"
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Static sampler, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class StaticSamplerSSE {
+public:
+  /**
+   * @copydoc StaticSampler::samples(Random&, State<B,ON_HOST>&)
+   */
+  static void samples(Random& rng, State<B,ON_HOST>& s);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../random/RngSSE.hpp"
+#include "../../host/updater/StaticSamplerVisitorHost.hpp"
+#include "../../host/updater/StaticSamplerMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+void bi::StaticSamplerSSE<B,S>::samples(Random& rng, State<B,ON_HOST>& s) {
+  typedef RngSSE R1;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef StaticSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef StaticSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  const PhiloxHost gen(rng.getHostRng().nextStream());
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    R1 rng1(gen);
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      rng1.seek(p);
+      Visitor::accept(rng1, s, p, pax, x);
+    }
+  }
+}
+
+#endif
@@ -74,6 +74,16 @@ public:
   template<class V1>
   void gather(const ScheduleElement now, const V1 as);
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Proposal log-weights.
@@ -181,4 +191,11 @@ void bi::AuxiliaryPFState<B,L>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, qlws);
 }
 
+template<class B, bi::Location L>
+template<class W>
+void bi::AuxiliaryPFState<B,L>::wire(W& w) {
+  BootstrapPFState<B,L>::wire(w);
+  w.vector(qlws);
+}
+
 #endif
@@ -94,6 +94,16 @@ public:
    */
   double ess;
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Log-weights.
@@ -232,4 +242,13 @@ void bi::BootstrapPFState<B,L>::load(Archive& ar, const unsigned version) {
   load_resizable_vector(ar, version, as);
 }
 
+template<class B, bi::Location L>
+template<class W>
+void bi::BootstrapPFState<B,L>::wire(W& w) {
+  FilterState<B,L>::wire(w);
+  w.scalar(ess);
+  w.vector(lws);
+  w.vector(as);
+}
+
 #endif
@@ -67,6 +67,16 @@ public:
    */
   typename State<B,L>::matrix_type U1, U2, C;
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Number of dynamic variables.
@@ -187,4 +197,15 @@ void bi::ExtendedKFState<B,L>::load(Archive& ar, const unsigned version) {
   load_resizable_matrix(ar, version, C);
 }
 
+template<class B, bi::Location L>
+template<class W>
+void bi::ExtendedKFState<B,L>::wire(W& w) {
+  FilterState<B,L>::wire(w);
+  w.vector(mu1);
+  w.vector(mu2);
+  w.matrix(U1);
+  w.matrix(U2);
+  w.matrix(C);
+}
+
 #endif
@@ -68,6 +68,16 @@ public:
    */
   double logLikelihood;
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 private:
   /**
    * Serialize.
@@ -153,4 +163,14 @@ void bi::FilterState<B,L>::load(Archive& ar, const unsigned version) {
   ar & logLikelihood;
 }
 
+template<class B, bi::Location L>
+template<class W>
+void bi::FilterState<B,L>::wire(W& w) {
+  State<B,L>::wire(w);
+  w.matrix(path);
+  w.vector(times);
+  w.vector(logIncrements);
+  w.scalar(logLikelihood);
+}
+
 #endif
@@ -8,6 +8,8 @@
 #ifndef BI_STATE_MARGINALMHSTATE_HPP
 #define BI_STATE_MARGINALMHSTATE_HPP
 
+#include <vector>
+
 namespace bi {
 /**
  * State for MarginalMH.
@@ -18,6 +20,9 @@ namespace bi {
  * @tparam L Location.
  * @tparam S1 Filter state type.
  * @tparam IO1 Filter cache type.
+ *
+ * Holds one or more chains. The first chain is held in s1, s2 and out,
+ * others are accessed with current(), proposed() and output().
  */
 template<class B, Location L, class S1, class IO1>
 class MarginalMHState {
@@ -29,11 +34,16 @@ public:
    * @param P Number of \f$x\f$-particles.
    * @param Y Number of observation times.
    * @param T Number of output times.
+   * @param N Number of chains.
    */
-  MarginalMHState(B& m, const int P = 0, const int Y = 0, const int T = 0);
+  MarginalMHState(B& m, const int P = 0, const int Y = 0, const int T = 0,
+      const int N = 1);
 
   /**
-   * Shallow copy constructor.
+   * Copy constructor.
+   *
+   * The states and outputs of chains other than the first are copied into
+   * new objects owned by this state, rather than shared with @p o.
    */
   MarginalMHState(const MarginalMHState<B,L,S1,IO1>& o);
 
@@ -42,6 +52,11 @@ public:
    */
   MarginalMHState& operator=(const MarginalMHState<B,L,S1,IO1>& o);
 
+  /**
+   * Destructor.
+   */
+  ~MarginalMHState();
+
   /**
    * Clear.
    */
@@ -52,6 +67,32 @@ public:
    */
   void swap(MarginalMHState<B,L,S1,IO1>& o);
 
+  /**
+   * Number of chains.
+   */
+  int numChains() const;
+
+  /**
+   * Current state of chain.
+   *
+   * @param i Chain index.
+   */
+  S1& current(const int i);
+
+  /**
+   * Proposed state of chain.
+   *
+   * @param i Chain index.
+   */
+  S1& proposed(const int i);
+
+  /**
+   * Filter output of chain.
+   *
+   * @param i Chain index.
+   */
+  IO1& output(const int i);
+
   /**
    * Current state.
    */
@@ -73,6 +114,21 @@ public:
   long clock;
 
 private:
+  /**
+   * Current states of chains other than the first.
+   */
+  std::vector<S1*> s1s;
+
+  /**
+   * Proposed states of chains other than the first.
+   */
+  std::vector<S1*> s2s;
+
+  /**
+   * Filter outputs of chains other than the first.
+   */
+  std::vector<IO1*> outs;
+
   /**
    * Serialize.
    */
@@ -95,33 +151,68 @@ private:
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalMHState<B,L,S1,IO1>::MarginalMHState(B& m, const int P, const int Y,
-    const int T) :
-    s1(P, Y, T), s2(P, Y, T), out(m, P, T) {
-  //
+    const int T, const int N) :
+    s1(P, Y, T), s2(P, Y, T), out(m, P, T), s1s(N - 1), s2s(N - 1), outs(
+        N - 1) {
+  /* pre-condition */
+  BI_ASSERT(N > 0);
+
+  for (int i = 0; i < N - 1; ++i) {
+    s1s[i] = new S1(P, Y, T);
+    s2s[i] = new S1(P, Y, T);
+    outs[i] = new IO1(m, P, T);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalMHState<B,L,S1,IO1>::MarginalMHState(
     const MarginalMHState<B,L,S1,IO1>& o) :
-    s1(o.s1), s2(o.s2), out(o.out) {
-  //
+    s1(o.s1), s2(o.s2), out(o.out), s1s(o.s1s.size()), s2s(o.s2s.size()), outs(
+        o.outs.size()) {
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    s1s[i] = new S1(*o.s1s[i]);
+    s2s[i] = new S1(*o.s2s[i]);
+    outs[i] = new IO1(*o.outs[i]);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalMHState<B,L,S1,IO1>& bi::MarginalMHState<B,L,S1,IO1>::operator=(
     const MarginalMHState<B,L,S1,IO1>& o) {
+  /* pre-condition */
+  BI_ASSERT(o.numChains() == numChains());
+
   s1 = o.s1;
   s2 = o.s2;
   out = o.out;
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    *s1s[i] = *o.s1s[i];
+    *s2s[i] = *o.s2s[i];
+    *outs[i] = *o.outs[i];
+  }
 
   return *this;
 }
 
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalMHState<B,L,S1,IO1>::~MarginalMHState() {
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    delete s1s[i];
+    delete s2s[i];
+    delete outs[i];
+  }
+}
+
 template<class B, bi::Location L, class S1, class IO1>
 void bi::MarginalMHState<B,L,S1,IO1>::clear() {
   s1.clear();
   s2.clear();
   out.clear();
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    s1s[i]->clear();
+    s2s[i]->clear();
+    outs[i]->clear();
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
@@ -129,6 +220,38 @@ void bi::MarginalMHState<B,L,S1,IO1>::swap(MarginalMHState<B,L,S1,IO1>& o) {
   s1.swap(o.s1);
   s2.swap(o.s2);
   out.swap(o.out);
+  std::swap(s1s, o.s1s);
+  std::swap(s2s, o.s2s);
+  std::swap(outs, o.outs);
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+int bi::MarginalMHState<B,L,S1,IO1>::numChains() const {
+  return 1 + int(s1s.size());
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+S1& bi::MarginalMHState<B,L,S1,IO1>::current(const int i) {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i < numChains());
+
+  return (i == 0) ? s1 : *s1s[i - 1];
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+S1& bi::MarginalMHState<B,L,S1,IO1>::proposed(const int i) {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i < numChains());
+
+  return (i == 0) ? s2 : *s2s[i - 1];
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+IO1& bi::MarginalMHState<B,L,S1,IO1>::output(const int i) {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i < numChains());
+
+  return (i == 0) ? out : *outs[i - 1];
 }
 
 template<class B, bi::Location L, class S1, class IO1>
@@ -138,6 +261,11 @@ void bi::MarginalMHState<B,L,S1,IO1>::save(Archive& ar,
   ar & s1;
   ar & s2;
   ar & out;
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    ar & *s1s[i];
+    ar & *s2s[i];
+    ar & *outs[i];
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
@@ -147,6 +275,11 @@ void bi::MarginalMHState<B,L,S1,IO1>::load(Archive& ar,
   ar & s1;
   ar & s2;
   ar & out;
+  for (int i = 0; i < int(s1s.size()); ++i) {
+    ar & *s1s[i];
+    ar & *s2s[i];
+    ar & *outs[i];
+  }
 }
 
 #endif
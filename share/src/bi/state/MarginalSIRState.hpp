@@ -69,6 +69,11 @@ public:
    */
   MarginalSIRState& operator=(const MarginalSIRState<B,L,S1,IO1>& o);
 
+  /**
+   * Destructor.
+   */
+  ~MarginalSIRState();
+
   /**
    * Clear.
    */
@@ -115,6 +120,33 @@ public:
   template<class V1>
   void gather(const ScheduleElement now, const V1 as);
 
+  /**
+   * Ensure that there is scratch for concurrent proposals.
+   *
+   * @param n Number of proposals to be made concurrently.
+   *
+   * Not thread safe, call before entering a parallel region.
+   */
+  void reserveProposals(const int n);
+
+  /**
+   * Proposed state for concurrent moves.
+   *
+   * @param i Index of proposal, usually the thread id.
+   *
+   * The first proposal is s2, others are allocated by reserveProposals().
+   */
+  S1& proposal(const int i);
+
+  /**
+   * Proposed output for concurrent moves.
+   *
+   * @param i Index of proposal, usually the thread id.
+   *
+   * The first proposal is out2, others are allocated by reserveProposals().
+   */
+  IO1& proposalOutput(const int i);
+
   /**
    * \f$\theta\f$-particles.
    */
@@ -135,6 +167,16 @@ public:
    */
   IO1 out2;
 
+  /**
+   * Additional proposed states, for concurrent moves.
+   */
+  std::vector<S1*> s2s;
+
+  /**
+   * Additional proposed outputs, for concurrent moves.
+   */
+  std::vector<IO1*> out2s;
+
   /**
    * Marginal log-likelihood increments.
    */
@@ -156,6 +198,17 @@ public:
   long clock;
 
 private:
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Number of \f$x\f$-particles, observation times and output times, to
+   * size additional proposals.
+   */
+  int Px, Y, T;
+
   /**
    * Log-weights.
    */
@@ -200,8 +253,8 @@ template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(B& m, const int Ptheta,
     const int Px, const int Y, const int T) :
     s1s(Ptheta), out1s(Ptheta), s2(Px, Y, T), out2(m, Px, T), logIncrements(Y), logLikelihood(
-        0.0), ess(0.0), lws(Ptheta), as(Ptheta), ptheta(0), Ptheta(
-        Ptheta) {
+        0.0), ess(0.0), m(m), Px(Px), Y(Y), T(T), lws(Ptheta), as(Ptheta), ptheta(0),
+        Ptheta(Ptheta) {
   for (int p = 0; p < size(); ++p) {
     s1s[p] = new S1(Px, Y, T);
     out1s[p] = new IO1(m, Px, T);
@@ -212,8 +265,8 @@ template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(
     const MarginalSIRState<B,L,S1,IO1>& o) :
     s1s(o.s1s.size()), out1s(o.out1s.size()), s2(o.s2), out2(o.out2), logIncrements(o.logIncrements), logLikelihood(
-        o.logLikelihood), ess(0.0), lws(o.lws), as(
-        o.as), ptheta(o.ptheta), Ptheta(o.Ptheta) {
+        o.logLikelihood), ess(0.0), m(o.m), Px(o.Px), Y(o.Y), T(
+        o.T), lws(o.lws), as(o.as), ptheta(o.ptheta), Ptheta(o.Ptheta) {
   for (int p = 0; p < size(); ++p) {
     s1s[p] = new S1(*o.s1s[p]);
     out1s[p] = new IO1(*o.out1s[p]);
@@ -243,6 +296,18 @@ bi::MarginalSIRState<B,L,S1,IO1>& bi::MarginalSIRState<B,L,S1,IO1>::operator=(
   return *this;
 }
 
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalSIRState<B,L,S1,IO1>::~MarginalSIRState() {
+  for (int p = 0; p < (int)s1s.size(); ++p) {
+    delete s1s[p];
+    delete out1s[p];
+  }
+  for (int i = 0; i < (int)s2s.size(); ++i) {
+    delete s2s[i];
+    delete out2s[i];
+  }
+}
+
 template<class B, bi::Location L, class S1, class IO1>
 void bi::MarginalSIRState<B,L,S1,IO1>::clear() {
   for (int p = 0; p < size(); ++p) {
@@ -251,6 +316,10 @@ void bi::MarginalSIRState<B,L,S1,IO1>::clear() {
   }
   s2.clear();
   out2.clear();
+  for (int i = 0; i < (int)s2s.size(); ++i) {
+    s2s[i]->clear();
+    out2s[i]->clear();
+  }
   logIncrements.clear();
   logLikelihood = 0.0;
   ess = 0.0;
@@ -264,6 +333,8 @@ void bi::MarginalSIRState<B,L,S1,IO1>::swap(MarginalSIRState<B,L,S1,IO1>& o) {
   std::swap(out1s, o.out1s);
   s2.swap(o.s2);
   out2.swap(o.out2);
+  std::swap(s2s, o.s2s);
+  std::swap(out2s, o.out2s);
   logIncrements.swap(o.logIncrements);
   std::swap(logLikelihood, o.logLikelihood);
   std::swap(ess, o.ess);
@@ -330,6 +401,30 @@ void bi::MarginalSIRState<B,L,S1,IO1>::gather(const ScheduleElement now,
   }
 }
 
+template<class B, bi::Location L, class S1, class IO1>
+void bi::MarginalSIRState<B,L,S1,IO1>::reserveProposals(const int n) {
+  while ((int)s2s.size() < n - 1) {
+    s2s.push_back(new S1(Px, Y, T));
+    out2s.push_back(new IO1(m, Px, T));
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+S1& bi::MarginalSIRState<B,L,S1,IO1>::proposal(const int i) {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i <= (int)s2s.size());
+
+  return (i == 0) ? s2 : *s2s[i - 1];
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+IO1& bi::MarginalSIRState<B,L,S1,IO1>::proposalOutput(const int i) {
+  /* pre-condition */
+  BI_ASSERT(i >= 0 && i <= (int)out2s.size());
+
+  return (i == 0) ? out2 : *out2s[i - 1];
+}
+
 template<class B, bi::Location L, class S1, class IO1>
 template<class Archive>
 void bi::MarginalSIRState<B,L,S1,IO1>::save(Archive& ar,
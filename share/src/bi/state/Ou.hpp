@@ -30,6 +30,11 @@ struct Ou {
  */
 template<class B, class V1>
 struct Ou<ON_HOST,B,V1> {
+  /**
+   * Value type.
+   */
+  typedef typename V1::value_type value_type;
+
   /**
    * Get variable.
    *
@@ -83,6 +88,11 @@ struct Ou<ON_HOST,B,V1> {
  */
 template<class B, class V1>
 struct Ou<ON_DEVICE,B,V1> {
+  /**
+   * Value type.
+   */
+  typedef typename V1::value_type value_type;
+
   /**
    * Get variable.
    *
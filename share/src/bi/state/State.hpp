@@ -30,11 +30,28 @@ namespace bi {
  * @li for @p L on device, @p P must be either less than 32, or a
  * multiple of 32, and
  * @li for @p L on host with SSE enabled, @p P must be zero, one or a
- * multiple of four (single precision) or two (double precision).
+ * multiple of #BI_SIMD_SIZE (e.g. four single or two double precision
+ * values for SSE, sixteen or eight for AVX-512).
  */
 int roundup(const int P);
+
+/**
+ * Number of trajectories in each tile, when the trajectories of a state are
+ * divided into tiles that are each updated in turn by one thread.
+ *
+ * @param P Number of trajectories.
+ * @param N Number of reals per trajectory.
+ *
+ * @return Number of trajectories in each tile, at most @p P.
+ *
+ * Tiles are sized to fit in cache, but with enough tiles to occupy all
+ * threads. The start of every tile satisfies roundup().
+ */
+int tile_size(const int P, const int N);
 }
 
+#include "../math/function.hpp"
+#include "../misc/omp.hpp"
 #ifdef ENABLE_SSE
 #include "../sse/math/scalar.hpp"
 #endif
@@ -48,8 +65,7 @@ inline int bi::roundup(const int P) {
     P1 = ((P1 + 31) / 32) * 32;
   }
 #elif defined(ENABLE_SSE)
-  /* zero, one or a multiple of 4 (single precision) or 2 (double
-   * precision) required */
+  /* zero, one or a multiple of the SIMD vector width required */
   if (P1 > 1) {
     P1 = ((P1 + BI_SIMD_SIZE - 1)/BI_SIMD_SIZE)*BI_SIMD_SIZE;
   }
@@ -58,6 +74,20 @@ inline int bi::roundup(const int P) {
   return P1;
 }
 
+inline int bi::tile_size(const int P, const int N) {
+  /* target size of a tile, in bytes, chosen to fit within the per-core
+   * cache of most current processors */
+  static const int TILE_BYTES = 262144;
+
+  /* the lower bound of 32 ensures that the start of every tile satisfies
+   * roundup() in all configurations */
+  int Q = TILE_BYTES/(bi::max(1, N)*sizeof(real));
+  Q = bi::min(Q, (P + bi_omp_max_threads - 1)/bi_omp_max_threads);
+  Q = roundup(bi::max(Q, 32));
+
+  return bi::min(Q, P);
+}
+
 namespace bi {
 /**
  * %State of Model %model.
@@ -70,7 +100,8 @@ namespace bi {
  * @section State_Serialization Serialization
  *
  * This class supports serialization through the Boost.Serialization
- * library.
+ * library, and to or from the flat binary wire format described in
+ * WireHeader, which is preferred for transfers between processes.
  */
 template<class B, Location L>
 class State {
@@ -197,6 +228,26 @@ public:
   template<class V1>
   void gather(const V1 as);
 
+  /**
+   * Copy single trajectory from another state.
+   *
+   * @param p Index of trajectory in this state.
+   * @param o Other state.
+   * @param q Index of trajectory in @p o.
+   *
+   * All non-common variables are copied, including those of alternative
+   * buffers.
+   */
+  void copyTrajectory(const int p, const State<B,L>& o, const int q);
+
+  /**
+   * Copy common and built-in variables from another state, leaving
+   * trajectories untouched.
+   *
+   * @param o Other state.
+   */
+  void copyCommon(const State<B,L>& o);
+
   /**
    * @name Built-in variables
    */
@@ -391,6 +442,58 @@ public:
   CUDA_FUNC_BOTH
   const matrix_reference_type getDyn() const;
 
+  /**
+   * Get buffer of step size controller states of ode blocks.
+   */
+  CUDA_FUNC_BOTH
+  matrix_reference_type getStep();
+
+  /**
+   * Get buffer of step size controller states of ode blocks.
+   */
+  CUDA_FUNC_BOTH
+  const matrix_reference_type getStep() const;
+
+  /**
+   * Get step size of ode block.
+   *
+   * @param p Trajectory index.
+   * @param k Index of ode block.
+   *
+   * @return Step size with which to continue integration of the
+   * trajectory, zero if it has not yet been integrated by the block.
+   */
+  CUDA_FUNC_BOTH
+  real& getStepSize(const int p, const int k);
+
+  /**
+   * Get step size of ode block.
+   *
+   * @param p Trajectory index.
+   * @param k Index of ode block.
+   */
+  CUDA_FUNC_BOTH
+  const real& getStepSize(const int p, const int k) const;
+
+  /**
+   * Get logarithm of last step size factor of ode block, as used for Lund
+   * stabilization of the step size controller.
+   *
+   * @param p Trajectory index.
+   * @param k Index of ode block.
+   */
+  CUDA_FUNC_BOTH
+  real& getStepFactor(const int p, const int k);
+
+  /**
+   * Get logarithm of last step size factor of ode block.
+   *
+   * @param p Trajectory index.
+   * @param k Index of ode block.
+   */
+  CUDA_FUNC_BOTH
+  const real& getStepFactor(const int p, const int k) const;
+
   /**
    * Log-prior density of parameters.
    */
@@ -406,6 +509,16 @@ public:
    */
   long clock;
 
+  /**
+   * Serialize to or from wire format.
+   *
+   * @tparam W Wire archive type (see WireArchive).
+   *
+   * @param w Wire archive.
+   */
+  template<class W>
+  void wire(W& w);
+
 protected:
   /* net sizes, for convenience */
   static const int NR = B::NR;
@@ -416,6 +529,12 @@ protected:
   static const int NDX = B::NDX;
   static const int NPX = B::NPX;
   static const int NB = B::NB;
+  static const int NODE = B::NODE;
+
+  /**
+   * Offset of step size controller states in @p Xdn.
+   */
+  static const int NS = NR + ND + NDX + NR + ND;
 
   /**
    * Storage for dense non-common variables.
@@ -466,12 +585,13 @@ private:
 
 #include "../math/view.hpp"
 #include "../math/constant.hpp"
+#include "../math/wire.hpp"
 #include "../primitive/matrix_primitive.hpp"
 
 template<class B, bi::Location L>
 bi::State<B,L>::State(const int P, const int Y, const int T) :
     logPrior(-BI_INF), logProposal(-BI_INF), clock(0),
-    Xdn(P, NR + ND + NDX + NR + ND),  // includes dy- and ry-vars
+    Xdn(P, NS + 2 * NODE),  // includes dy-, ry-vars and step sizes
     Kdn(1, NP + NPX + NF + NP + 2 * NO),// includes py- and oy-vars
     p(0), P(P) {
       /* pre-condition */
@@ -565,7 +685,12 @@ inline void bi::State<B,L>::resizeMax(const int maxP, const bool preserve) {
   /* pre-condition */
   BI_ASSERT(maxP == roundup(maxP));
 
+  const int oldP = preserve ? Xdn.size1() : 0;
   Xdn.resize(maxP, Xdn.size2(), preserve);
+  if (NODE > 0 && maxP > oldP) {
+    /* new trajectories have not yet been integrated by any ode block */
+    subrange(Xdn.ref(), oldP, maxP - oldP, NS, 2 * NODE).clear();
+  }
   if (p > maxP) {
     p = maxP;
   }
@@ -898,6 +1023,50 @@ inline const typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::getD
   return subrange(Xdn.ref(), p, P, 0, NR + ND);
 }
 
+template<class B, bi::Location L>
+inline typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::getStep() {
+  return subrange(Xdn.ref(), p, P, NS, 2 * NODE);
+}
+
+template<class B, bi::Location L>
+inline const typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::getStep() const {
+  return subrange(Xdn.ref(), p, P, NS, 2 * NODE);
+}
+
+template<class B, bi::Location L>
+inline real& bi::State<B,L>::getStepSize(const int p, const int k) {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < NODE);
+
+  return Xdn(this->p + p, NS + 2 * k);
+}
+
+template<class B, bi::Location L>
+inline const real& bi::State<B,L>::getStepSize(const int p,
+    const int k) const {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < NODE);
+
+  return Xdn(this->p + p, NS + 2 * k);
+}
+
+template<class B, bi::Location L>
+inline real& bi::State<B,L>::getStepFactor(const int p, const int k) {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < NODE);
+
+  return Xdn(this->p + p, NS + 2 * k + 1);
+}
+
+template<class B, bi::Location L>
+inline const real& bi::State<B,L>::getStepFactor(const int p,
+    const int k) const {
+  /* pre-condition */
+  BI_ASSERT(k >= 0 && k < NODE);
+
+  return Xdn(this->p + p, NS + 2 * k + 1);
+}
+
 template<class B, bi::Location L>
 typename bi::State<B,L>::vector_reference_type bi::State<B,L>::select(
     const int p) {
@@ -908,6 +1077,27 @@ template<class B, bi::Location L>
 template<class V1>
 void bi::State<B,L>::gather(const V1 as) {
   bi::gather_rows(as, getDyn(), getDyn());
+  if (NODE > 0) {
+    bi::gather_rows(as, getStep(), getStep());
+  }
+}
+
+template<class B, bi::Location L>
+void bi::State<B,L>::copyTrajectory(const int p, const State<B,L>& o,
+    const int q) {
+  /* pre-conditions */
+  BI_ASSERT(p >= 0 && p < size());
+  BI_ASSERT(q >= 0 && q < o.size());
+
+  row(Xdn.ref(), this->p + p) = row(o.Xdn.ref(), o.p + q);
+}
+
+template<class B, bi::Location L>
+void bi::State<B,L>::copyCommon(const State<B,L>& o) {
+  Kdn = o.Kdn;
+  for (int i = 0; i < NB; ++i) {
+    builtin[i] = o.builtin[i];
+  }
 }
 
 template<class B, bi::Location L>
@@ -936,4 +1126,17 @@ void bi::State<B,L>::load(Archive& ar, const unsigned version) {
   ar & P;
 }
 
+template<class B, bi::Location L>
+template<class W>
+void bi::State<B,L>::wire(W& w) {
+  w.scalar(logPrior);
+  w.scalar(logProposal);
+  w.scalar(clock);
+  w.matrix(Xdn);
+  w.matrix(Kdn);
+  w.array(builtin, NB);
+  w.scalar(p);
+  w.scalar(P);
+}
+
 #endif
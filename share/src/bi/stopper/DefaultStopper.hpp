@@ -10,6 +10,10 @@
 #include "../math/constant.hpp"
 #include "../math/function.hpp"
 
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
+
 namespace bi {
 /**
  * Stopper that only uses default criteria.
@@ -23,6 +27,24 @@ public:
    */
   bool stop(const int T, const double threshold, const double maxlw = BI_INF);
 
+#ifdef ENABLE_MPI
+  /**
+   * Add sums to a reduction across processes.
+   *
+   * @param[in,out] red Reduction.
+   */
+  void contribute(StepReduction& red) const;
+
+  /**
+   * @copydoc Stopper::stop
+   *
+   * @param red Finished reduction, to which #contribute has added.
+   * @param i Index of the first sum added by #contribute.
+   */
+  bool distributedStop(const StepReduction& red, const int i, const int T,
+      const double threshold, const double maxlw = BI_INF);
+#endif
+
   /**
    * @copydoc Stopper::add(const double, const double)
    */
@@ -46,6 +68,17 @@ inline bool bi::DefaultStopper::stop(const int T, const double threshold,
   return false;
 }
 
+#ifdef ENABLE_MPI
+inline void bi::DefaultStopper::contribute(StepReduction& red) const {
+  //
+}
+
+inline bool bi::DefaultStopper::distributedStop(const StepReduction& red,
+    const int i, const int T, const double threshold, const double maxlw) {
+  return false;
+}
+#endif
+
 inline void bi::DefaultStopper::add(const double lw, const double maxlw) {
   //
 }
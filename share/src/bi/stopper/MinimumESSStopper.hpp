@@ -10,6 +10,10 @@
 #include "../math/constant.hpp"
 #include "../math/function.hpp"
 
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
+
 namespace bi {
 /**
  * Stopper based on ESS criterion.
@@ -29,10 +33,21 @@ public:
   bool stop(const int T, const double threshold, const double maxlw = BI_INF);
 
 #ifdef ENABLE_MPI
+  /**
+   * Add sums to a reduction across processes.
+   *
+   * @param[in,out] red Reduction.
+   */
+  void contribute(StepReduction& red) const;
+
   /**
    * @copydoc Stopper::stop
+   *
+   * @param red Finished reduction, to which #contribute has added.
+   * @param i Index of the first sum added by #contribute.
    */
-  bool distributedStop(const int T, const double threshold, const double maxlw = BI_INF);
+  bool distributedStop(const StepReduction& red, const int i, const int T,
+      const double threshold, const double maxlw = BI_INF);
 #endif
 
   /**
@@ -64,8 +79,6 @@ private:
 };
 }
 
-#include "../mpi/mpi.hpp"
-
 inline bi::MinimumESSStopper::MinimumESSStopper() :
     sumw(0.0), sumw2(0.0) {
   //
@@ -80,12 +93,15 @@ inline bool bi::MinimumESSStopper::stop(const int T,
 }
 
 #ifdef ENABLE_MPI
-inline bool bi::MinimumESSStopper::distributedStop(const int T, \
-    const double threshold, const double maxlw) {
-  boost::mpi::communicator world;
-  double sumw1 = boost::mpi::all_reduce(world, sumw, std::plus<double>());
-  double sumw21 = boost::mpi::all_reduce(world, sumw2, std::plus<double>());
+inline void bi::MinimumESSStopper::contribute(StepReduction& red) const {
+  red.addSum(sumw);
+  red.addSum(sumw2);
+}
 
+inline bool bi::MinimumESSStopper::distributedStop(const StepReduction& red,
+    const int i, const int T, const double threshold, const double maxlw) {
+  double sumw1 = red.getSum(i);
+  double sumw21 = red.getSum(i + 1);
   double ess = (sumw1 * sumw1) / sumw21;
   double minsumw = bi::exp(maxlw) * (threshold - 1.0) / 2.0;
 
@@ -103,11 +119,12 @@ inline void bi::MinimumESSStopper::add(const double lw, const double maxlw) {
 
 template<class V1>
 void bi::MinimumESSStopper::add(const V1 lws, const double maxlw) {
-  /* pre-condition */
-  BI_ASSERT(max_reduce(lws) <= maxlw);
+  double mx, lW, lW2;
+  logweight_reduce(lws, &mx, &lW, &lW2);
+  BI_ASSERT(mx <= maxlw);
 
-  sumw += sumexp_reduce(lws);
-  sumw2 += sumexpsq_reduce(lws);
+  sumw += bi::exp(lW);
+  sumw2 += bi::exp(lW2);
 }
 
 inline void bi::MinimumESSStopper::reset() {
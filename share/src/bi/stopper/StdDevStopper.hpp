@@ -7,6 +7,10 @@
 #ifndef BI_STOPPER_STDDEVSTOPPER_HPP
 #define BI_STOPPER_STDDEVSTOPPER_HPP
 
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
+
 namespace bi {
 /**
  * Stopper based on standard deviation criterion.
@@ -26,10 +30,21 @@ public:
   bool stop(const int T, const double threshold, const double maxlw = BI_INF);
 
 #ifdef ENABLE_MPI
+  /**
+   * Add sums to a reduction across processes.
+   *
+   * @param[in,out] red Reduction.
+   */
+  void contribute(StepReduction& red) const;
+
   /**
    * @copydoc Stopper::stop
+   *
+   * @param red Finished reduction, to which #contribute has added.
+   * @param i Index of the first sum added by #contribute.
    */
-  bool distributedStop(const int T, const double threshold, const double maxlw = BI_INF);
+  bool distributedStop(const StepReduction& red, const int i, const int T,
+      const double threshold, const double maxlw = BI_INF);
 #endif
 
   /**
@@ -56,8 +71,6 @@ private:
 };
 }
 
-#include "../mpi/mpi.hpp"
-
 inline bi::StdDevStopper::StdDevStopper() :
     sum(0.0) {
   //
@@ -69,11 +82,13 @@ inline bool bi::StdDevStopper::stop(const int T, const double threshold,
 }
 
 #ifdef ENABLE_MPI
-inline bool bi::StdDevStopper::distributedStop(const int T, const double threshold,
-    const double maxlw) {
-  boost::mpi::communicator world;
-  double sum1 = boost::mpi::all_reduce(world, sum, std::plus<double>());
+inline void bi::StdDevStopper::contribute(StepReduction& red) const {
+  red.addSum(sum);
+}
 
+inline bool bi::StdDevStopper::distributedStop(const StepReduction& red,
+    const int i, const int T, const double threshold, const double maxlw) {
+  double sum1 = red.getSum(i);
   return sum1 >= T * threshold;
 }
 #endif
@@ -91,11 +106,12 @@ inline void bi::StdDevStopper::add(const double lw, const double maxlw) {
 
 template<class V1>
 void bi::StdDevStopper::add(const V1 lws, const double maxlw) {
-  /* pre-condition */
-  BI_ASSERT(max_reduce(lws) <= maxlw);
+  double mx, lW, lW2;
+  logweight_reduce(lws, &mx, &lW, &lW2);
+  BI_ASSERT(mx <= maxlw);
 
-  double mu = sumexp_reduce(lws) / lws.size();
-  double s2 = sumexpsq_reduce(lws) / lws.size();
+  double mu = bi::exp(lW) / lws.size();
+  double s2 = bi::exp(lW2) / lws.size();
   double val = bi::sqrt(s2 - mu * mu);
 
   sum += lws.size() * mu / val;
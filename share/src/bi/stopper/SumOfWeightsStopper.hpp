@@ -10,6 +10,10 @@
 #include "../math/constant.hpp"
 #include "../math/function.hpp"
 
+#ifdef ENABLE_MPI
+#include "../mpi/StepReduction.hpp"
+#endif
+
 namespace bi {
 /**
  * Stopper based on sum of weights criterion.
@@ -29,10 +33,21 @@ public:
   bool stop(const int T, const double threshold, const double maxlw = BI_INF);
 
 #ifdef ENABLE_MPI
+  /**
+   * Add sums to a reduction across processes.
+   *
+   * @param[in,out] red Reduction.
+   */
+  void contribute(StepReduction& red) const;
+
   /**
    * @copydoc Stopper::stop
+   *
+   * @param red Finished reduction, to which #contribute has added.
+   * @param i Index of the first sum added by #contribute.
    */
-  bool distributedStop(const int T, const double threshold, const double maxlw = BI_INF);
+  bool distributedStop(const StepReduction& red, const int i, const int T,
+      const double threshold, const double maxlw = BI_INF);
 #endif
 
   /**
@@ -59,8 +74,6 @@ private:
 };
 }
 
-#include "../mpi/mpi.hpp"
-
 inline bi::SumOfWeightsStopper::SumOfWeightsStopper() : sumw(0.0) {
   //
 }
@@ -73,12 +86,15 @@ inline bool bi::SumOfWeightsStopper::stop(const int T,
 }
 
 #ifdef ENABLE_MPI
-inline bool bi::SumOfWeightsStopper::distributedStop(const int T,
+inline void bi::SumOfWeightsStopper::contribute(StepReduction& red) const {
+  red.addSum(sumw);
+}
+
+inline bool bi::SumOfWeightsStopper::distributedStop(
+    const StepReduction& red, const int i, const int T,
     const double threshold, const double maxlw) {
-  boost::mpi::communicator world;
-  double sumw1 = boost::mpi::all_reduce(world, sumw, std::plus<double>());
+  double sumw1 = red.getSum(i);
   double minsumw = T * threshold * bi::exp(maxlw);
-
   return sumw1 >= minsumw;
 }
 #endif
@@ -92,10 +108,11 @@ inline void bi::SumOfWeightsStopper::add(const double lw, const double maxlw) {
 
 template<class V1>
 void bi::SumOfWeightsStopper::add(const V1 lws, const double maxlw) {
-  /* pre-condition */
-  BI_ASSERT(max_reduce(lws) <= maxlw);
+  double mx, lW;
+  logweight_reduce(lws, &mx, &lW);
+  BI_ASSERT(mx <= maxlw);
 
-  sumw += sumexp_reduce(lws);
+  sumw += bi::exp(lW);
 }
 
 inline void bi::SumOfWeightsStopper::reset() {
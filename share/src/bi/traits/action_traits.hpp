@@ -8,6 +8,9 @@
 #ifndef BI_TRAITS_ACTION_TRAITS_HPP
 #define BI_TRAITS_ACTION_TRAITS_HPP
 
+#include "var_traits.hpp"
+#include "../typelist/equals.hpp"
+
 namespace bi {
 /**
  * Size of action.
@@ -33,6 +36,39 @@ struct action_is_matrix {
   static const int value = A::IS_MATRIX;
 };
 
+/**
+ * Can action be evaluated for several trajectories at once with SIMD
+ * instructions?
+ *
+ * @ingroup model_low
+ *
+ * @tparam A Action type.
+ *
+ * Actions that target common variables cannot, as there is only one copy
+ * of such variables to write, rather than one per trajectory.
+ */
+template<class A>
+struct action_is_simd {
+  static const bool value = A::IS_SIMD &&
+      !is_common_var<typename A::target_type>::value;
+};
+
+/**
+ * Can action be evaluated for all trajectories at once as a batch matrix
+ * operation?
+ *
+ * @ingroup model_low
+ *
+ * @tparam A Action type.
+ *
+ * As for action_is_simd, actions that target common variables cannot.
+ */
+template<class A>
+struct action_is_batch {
+  static const bool value = A::IS_BATCH &&
+      !is_common_var<typename A::target_type>::value;
+};
+
 /**
  * Start of action in action type list (cumulative sum of the sizes of
  * all preceding actions).
@@ -73,6 +109,36 @@ template<class S, class A>
 struct action_end {
   static const int value = action_start<S,A>::value + action_size<A>::value;
 };
+
+/**
+ * Start of the action that targets the whole of a variable in action type
+ * list, or -1 if there is no such action.
+ *
+ * @ingroup model_low
+ *
+ * @tparam S Action type list.
+ * @tparam X Variable type.
+ */
+template<class S, class X>
+struct target_start {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool match = equals<typename front::target_type,X>::value &&
+      action_size<front>::value == var_size<X>::value;
+  static const int next = target_start<pop_front,X>::value;
+  static const int value = match ? 0 : ((next < 0) ? -1 : action_size<front>::value + next);
+};
+
+/**
+ * @internal
+ *
+ * @ingroup model_low
+ */
+template<class X>
+struct target_start<empty_typelist,X> {
+  static const int value = -1;
+};
 }
 
 #endif
@@ -122,6 +122,54 @@ struct block_is_matrix<empty_typelist> {
   static const bool value = true;
 };
 
+/**
+ * Can block be evaluated for several trajectories at once with SIMD
+ * instructions?
+ */
+template<class S>
+struct block_is_simd {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool value = action_is_simd<front>::value && block_is_simd<pop_front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of block_is_simd.
+ *
+ * @ingroup model_low
+ */
+template<>
+struct block_is_simd<empty_typelist> {
+  static const bool value = true;
+};
+
+/**
+ * Can block be evaluated for all trajectories at once as batch matrix
+ * operations?
+ */
+template<class S>
+struct block_is_batch {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool value = action_is_batch<front>::value && block_is_batch<pop_front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of block_is_batch.
+ *
+ * @ingroup model_low
+ */
+template<>
+struct block_is_batch<empty_typelist> {
+  static const bool value = true;
+};
+
 }
 
 #endif
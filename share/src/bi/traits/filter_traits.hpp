@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_TRAITS_FILTER_TRAITS_HPP
+#define BI_TRAITS_FILTER_TRAITS_HPP
+
+namespace bi {
+/**
+ * Is filter reentrant? A filter is reentrant if one filter object may be
+ * used by several threads at once, each on its own state and output
+ * buffer. This is the case for filters whose only mutable data is that
+ * held in the state, but not, for example, for those that accumulate
+ * statistics in a stopper.
+ *
+ * @ingroup method_filter
+ *
+ * @tparam F Filter type.
+ */
+template<class F>
+struct filter_is_reentrant {
+  static const bool value = false;
+};
+
+/**
+ * Does the log-likelihood of the filter lag by one observation? This is the
+ * case for filters that add the log-likelihood increment of an observation
+ * at the start of the following step, rather than when correcting for it.
+ *
+ * @ingroup method_filter
+ *
+ * @tparam F Filter type.
+ */
+template<class F>
+struct filter_likelihood_lags {
+  static const bool value = false;
+};
+}
+
+#endif
@@ -87,6 +87,12 @@ public:
 }
 
 #include "../host/updater/DynamicMaxLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/DynamicMaxLogDensitySSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/DynamicMaxLogDensityGPU.cuh"
 #endif
@@ -95,7 +101,17 @@ template<class B, class S>
 template<class T1, class V1>
 void bi::DynamicMaxLogDensity<B,S>::maxLogDensities(const T1 t1, const T1 t2,
     State<B,ON_HOST>& s, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      DynamicMaxLogDensitySSE<B,S>,DynamicMaxLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::maxLogDensities(t1, t2, s, lp);
+  } else {
+    DynamicMaxLogDensityHost<B,S>::maxLogDensities(t1, t2, s, lp);
+  }
+  #else
   DynamicMaxLogDensityHost<B,S>::maxLogDensities(t1, t2, s, lp);
+  #endif
 }
 
 template<class B, class S>
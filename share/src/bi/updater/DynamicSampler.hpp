@@ -83,6 +83,12 @@ public:
 }
 
 #include "../host/updater/DynamicSamplerHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/DynamicSamplerSSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/DynamicSamplerGPU.cuh"
 #endif
@@ -91,7 +97,17 @@ template<class B, class S>
 template<class T1>
 void bi::DynamicSampler<B,S>::samples(Random& rng, const T1 t1, const T1 t2,
     State<B,ON_HOST>& s) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      DynamicSamplerSSE<B,S>,DynamicSamplerHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::samples(rng, t1, t2, s);
+  } else {
+    DynamicSamplerHost<B,S>::samples(rng, t1, t2, s);
+  }
+  #else
   DynamicSamplerHost<B,S>::samples(rng, t1, t2, s);
+  #endif
 }
 
 template<class B, class S>
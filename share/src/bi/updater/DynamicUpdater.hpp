@@ -77,25 +77,36 @@ public:
 }
 
 #include "../host/updater/DynamicUpdaterHost.hpp"
+#include "../host/updater/DynamicUpdaterBatchHost.hpp"
 #ifdef ENABLE_SSE
 #include "../sse/updater/DynamicUpdaterSSE.hpp"
 #endif
 #ifdef __CUDACC__
 #include "../cuda/updater/DynamicUpdaterGPU.cuh"
 #endif
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
 
 template<class B, class S>
 template<class T1>
 void bi::DynamicUpdater<B,S>::update(const T1 t1, const T1 t2,
     State<B,ON_HOST>& s) {
+  /* blocks of batch matrix actions update all trajectories at once */
+  typedef typename boost::mpl::if_c<block_is_batch<S>::value,
+      DynamicUpdaterBatchHost<B,S>,DynamicUpdaterHost<B,S> >::type host_type;
+
   #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_batch<S>::value,
+      DynamicUpdaterBatchHost<B,S>,DynamicUpdaterSSE<B,S> >::type sse_type;
+
   if (s.size() % BI_SIMD_SIZE == 0) {
-    DynamicUpdaterSSE<B,S>::update(t1, t2, s);
+    sse_type::update(t1, t2, s);
   } else {
-    DynamicUpdaterHost<B,S>::update(t1, t2, s);
+    host_type::update(t1, t2, s);
   }
   #else
-  DynamicUpdaterHost<B,S>::update(t1, t2, s);
+  host_type::update(t1, t2, s);
   #endif
 }
 
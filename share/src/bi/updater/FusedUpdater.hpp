@@ -0,0 +1,252 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_UPDATER_FUSEDUPDATER_HPP
+#define BI_UPDATER_FUSEDUPDATER_HPP
+
+namespace bi {
+/**
+ * Update using a sequence of blocks fused into a single sweep over
+ * trajectories.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Block type list.
+ *
+ * Rather than each block making its own pass over all trajectories, the
+ * trajectories are divided into tiles that fit in cache, and every block is
+ * applied to a tile before moving on to the next, so that the state of each
+ * trajectory is loaded once for the whole sequence. Tiles are shared between
+ * threads in a single parallel region; the parallel regions of the blocks
+ * themselves are nested, and so run on the thread that owns the tile.
+ *
+ * Blocks must update each trajectory independently of all others, and must
+ * not write common variables.
+ */
+template<class B, class S>
+class FusedUpdater {
+public:
+  /**
+   * Update state.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param t1 Start of interval.
+   * @param t2 End of interval.
+   * @param onDelta True if @p t1 is on the time step of the blocks.
+   * @param[in,out] s State.
+   */
+  template<class T1>
+  static void simulates(const T1 t1, const T1 t2, const bool onDelta,
+      State<B,ON_HOST>& s);
+
+  /**
+   * Sample state.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param t1 Start of interval.
+   * @param t2 End of interval.
+   * @param onDelta True if @p t1 is on the time step of the blocks.
+   * @param[in,out] s State.
+   */
+  template<class T1>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      const bool onDelta, State<B,ON_HOST>& s);
+
+  #ifdef __CUDACC__
+  /**
+   * Update state.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param t1 Start of interval.
+   * @param t2 End of interval.
+   * @param onDelta True if @p t1 is on the time step of the blocks.
+   * @param[in,out] s State.
+   */
+  template<class T1>
+  static void simulates(const T1 t1, const T1 t2, const bool onDelta,
+      State<B,ON_DEVICE>& s);
+
+  /**
+   * Sample state.
+   *
+   * @tparam T1 Scalar type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param t1 Start of interval.
+   * @param t2 End of interval.
+   * @param onDelta True if @p t1 is on the time step of the blocks.
+   * @param[in,out] s State.
+   */
+  template<class T1>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      const bool onDelta, State<B,ON_DEVICE>& s);
+  #endif
+
+private:
+  /**
+   * Compute the number of trajectories in each tile.
+   *
+   * @param s State.
+   */
+  static int tileSize(const State<B,ON_HOST>& s);
+};
+
+/**
+ * @internal
+ *
+ * Visitor applying each block of a fused sequence in turn.
+ *
+ * @tparam B Model type.
+ * @tparam S Block type list.
+ */
+template<class B, class S>
+class FusedUpdaterVisitor {
+public:
+  template<class T1, Location L>
+  static void simulates(const T1 t1, const T1 t2, const bool onDelta,
+      State<B,L>& s);
+
+  template<class T1, Location L>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      const bool onDelta, State<B,L>& s);
+};
+
+/**
+ * @internal
+ *
+ * Base case of FusedUpdaterVisitor.
+ */
+template<class B>
+class FusedUpdaterVisitor<B,empty_typelist> {
+public:
+  template<class T1, Location L>
+  static void simulates(const T1 t1, const T1 t2, const bool onDelta,
+      State<B,L>& s) {
+    //
+  }
+
+  template<class T1, Location L>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      const bool onDelta, State<B,L>& s) {
+    //
+  }
+};
+}
+
+#include "../misc/omp.hpp"
+#include "../math/function.hpp"
+#include "../typelist/front.hpp"
+#include "../typelist/pop_front.hpp"
+
+template<class B, class S>
+template<class T1>
+void bi::FusedUpdater<B,S>::simulates(const T1 t1, const T1 t2,
+    const bool onDelta, State<B,ON_HOST>& s) {
+  typedef FusedUpdaterVisitor<B,S> Visitor;
+
+  const int P = s.size();
+  const int Q = tileSize(s);
+
+  if (Q >= P) {
+    Visitor::simulates(t1, t2, onDelta, s);
+  } else {
+    #pragma omp parallel
+    {
+      State<B,ON_HOST> s1(s);  // shallow copy, for own active range
+      int start;
+
+      #pragma omp for schedule(static)
+      for (start = 0; start < P; start += Q) {
+        s1.setRange(s.start() + start, bi::min(Q, P - start));
+        Visitor::simulates(t1, t2, onDelta, s1);
+      }
+    }
+  }
+}
+
+template<class B, class S>
+template<class T1>
+void bi::FusedUpdater<B,S>::samples(Random& rng, const T1 t1, const T1 t2,
+    const bool onDelta, State<B,ON_HOST>& s) {
+  typedef FusedUpdaterVisitor<B,S> Visitor;
+
+  const int P = s.size();
+  const int Q = tileSize(s);
+
+  if (Q >= P) {
+    Visitor::samples(rng, t1, t2, onDelta, s);
+  } else {
+    #pragma omp parallel
+    {
+      State<B,ON_HOST> s1(s);  // shallow copy, for own active range
+      int start;
+
+      #pragma omp for schedule(static)
+      for (start = 0; start < P; start += Q) {
+        s1.setRange(s.start() + start, bi::min(Q, P - start));
+        Visitor::samples(rng, t1, t2, onDelta, s1);
+      }
+    }
+  }
+}
+
+#ifdef __CUDACC__
+template<class B, class S>
+template<class T1>
+void bi::FusedUpdater<B,S>::simulates(const T1 t1, const T1 t2,
+    const bool onDelta, State<B,ON_DEVICE>& s) {
+  FusedUpdaterVisitor<B,S>::simulates(t1, t2, onDelta, s);
+}
+
+template<class B, class S>
+template<class T1>
+void bi::FusedUpdater<B,S>::samples(Random& rng, const T1 t1, const T1 t2,
+    const bool onDelta, State<B,ON_DEVICE>& s) {
+  FusedUpdaterVisitor<B,S>::samples(rng, t1, t2, onDelta, s);
+}
+#endif
+
+template<class B, class S>
+int bi::FusedUpdater<B,S>::tileSize(const State<B,ON_HOST>& s) {
+  const int P = s.size();
+
+  /* already within a tile of an enclosing parallel region */
+  if (bi_omp_in_parallel()) {
+    return P;
+  }
+
+  return tile_size(P, s.getDyn().size2());
+}
+
+template<class B, class S>
+template<class T1, bi::Location L>
+inline void bi::FusedUpdaterVisitor<B,S>::simulates(const T1 t1,
+    const T1 t2, const bool onDelta, State<B,L>& s) {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  front::simulates(t1, t2, onDelta, s);
+  FusedUpdaterVisitor<B,pop_front>::simulates(t1, t2, onDelta, s);
+}
+
+template<class B, class S>
+template<class T1, bi::Location L>
+inline void bi::FusedUpdaterVisitor<B,S>::samples(Random& rng, const T1 t1,
+    const T1 t2, const bool onDelta, State<B,L>& s) {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  front::samples(rng, t1, t2, onDelta, s);
+  FusedUpdaterVisitor<B,pop_front>::samples(rng, t1, t2, onDelta, s);
+}
+
+#endif
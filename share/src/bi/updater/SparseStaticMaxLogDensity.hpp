@@ -87,6 +87,12 @@ public:
 }
 
 #include "../host/updater/SparseStaticMaxLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/SparseStaticMaxLogDensitySSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/SparseStaticMaxLogDensityGPU.cuh"
 #endif
@@ -95,7 +101,17 @@ template<class B, class S>
 template<class V1>
 void bi::SparseStaticMaxLogDensity<B,S>::maxLogDensities(State<B,ON_HOST>& s,
     const Mask<ON_HOST>& mask, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      SparseStaticMaxLogDensitySSE<B,S>,SparseStaticMaxLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::maxLogDensities(s, mask, lp);
+  } else {
+    SparseStaticMaxLogDensityHost<B,S>::maxLogDensities(s, mask, lp);
+  }
+  #else
   SparseStaticMaxLogDensityHost<B,S>::maxLogDensities(s, mask, lp);
+  #endif
 }
 
 template<class B, class S>
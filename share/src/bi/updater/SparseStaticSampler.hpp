@@ -67,6 +67,12 @@ public:
 }
 
 #include "../host/updater/SparseStaticSamplerHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/SparseStaticSamplerSSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/SparseStaticSamplerGPU.cuh"
 #endif
@@ -74,13 +80,23 @@ public:
 template<class B, class S>
 void bi::SparseStaticSampler<B,S>::samples(Random& rng, State<B,ON_HOST>& s,
     const Mask<ON_HOST>& mask) {
-  SparseStaticSamplerHost<B,S>::samples(rng, s);
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      SparseStaticSamplerSSE<B,S>,SparseStaticSamplerHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::samples(rng, s, mask);
+  } else {
+    SparseStaticSamplerHost<B,S>::samples(rng, s, mask);
+  }
+  #else
+  SparseStaticSamplerHost<B,S>::samples(rng, s, mask);
+  #endif
 }
 
 template<class B, class S>
 void bi::SparseStaticSampler<B,S>::samples(Random& rng, State<B,ON_HOST>& s,
     const int p, const Mask<ON_HOST>& mask) {
-  SparseStaticSamplerHost<B,S>::samples(rng, s, p);
+  SparseStaticSamplerHost<B,S>::samples(rng, s, p, mask);
 }
 
 #ifdef __CUDACC__
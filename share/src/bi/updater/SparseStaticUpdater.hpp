@@ -62,6 +62,12 @@ public:
 }
 
 #include "../host/updater/SparseStaticUpdaterHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/SparseStaticUpdaterSSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/SparseStaticUpdaterGPU.cuh"
 #endif
@@ -69,7 +75,17 @@ public:
 template<class B, class S>
 void bi::SparseStaticUpdater<B,S>::update(State<B,ON_HOST>& s,
     const Mask<ON_HOST>& mask) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      SparseStaticUpdaterSSE<B,S>,SparseStaticUpdaterHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::update(s, mask);
+  } else {
+    SparseStaticUpdaterHost<B,S>::update(s, mask);
+  }
+  #else
   SparseStaticUpdaterHost<B,S>::update(s, mask);
+  #endif
 }
 
 template<class B, class S>
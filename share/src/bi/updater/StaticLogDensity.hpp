@@ -79,6 +79,12 @@ public:
 }
 
 #include "../host/updater/StaticLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/StaticLogDensitySSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticLogDensityGPU.cuh"
 #endif
@@ -86,7 +92,17 @@ public:
 template<class B, class S>
 template<class V1>
 void bi::StaticLogDensity<B,S>::logDensities(State<B,ON_HOST>& s, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      StaticLogDensitySSE<B,S>,StaticLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::logDensities(s, lp);
+  } else {
+    StaticLogDensityHost<B,S>::logDensities(s, lp);
+  }
+  #else
   StaticLogDensityHost<B,S>::logDensities(s, lp);
+  #endif
 }
 
 template<class B, class S>
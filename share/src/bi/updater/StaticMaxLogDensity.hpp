@@ -79,6 +79,12 @@ public:
 }
 
 #include "../host/updater/StaticMaxLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/StaticMaxLogDensitySSE.hpp"
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticMaxLogDensityGPU.cuh"
 #endif
@@ -86,7 +92,17 @@ public:
 template<class B, class S>
 template<class V1>
 void bi::StaticMaxLogDensity<B,S>::maxLogDensities(State<B,ON_HOST>& s, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      StaticMaxLogDensitySSE<B,S>,StaticMaxLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::maxLogDensities(s, lp);
+  } else {
+    StaticMaxLogDensityHost<B,S>::maxLogDensities(s, lp);
+  }
+  #else
   StaticMaxLogDensityHost<B,S>::maxLogDensities(s, lp);
+  #endif
 }
 
 template<class B, class S>
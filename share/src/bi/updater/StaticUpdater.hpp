@@ -55,23 +55,34 @@ public:
 }
 
 #include "../host/updater/StaticUpdaterHost.hpp"
+#include "../host/updater/StaticUpdaterBatchHost.hpp"
 #ifdef ENABLE_SSE
 #include "../sse/updater/StaticUpdaterSSE.hpp"
 #endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticUpdaterGPU.cuh"
 #endif
+#include "../traits/block_traits.hpp"
+
+#include "boost/mpl/if.hpp"
 
 template<class B, class S>
 void bi::StaticUpdater<B,S>::update(State<B,ON_HOST>& s) {
+  /* blocks of batch matrix actions update all trajectories at once */
+  typedef typename boost::mpl::if_c<block_is_batch<S>::value,
+      StaticUpdaterBatchHost<B,S>,StaticUpdaterHost<B,S> >::type host_type;
+
   #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_batch<S>::value,
+      StaticUpdaterBatchHost<B,S>,StaticUpdaterSSE<B,S> >::type sse_type;
+
   if (s.size() % BI_SIMD_SIZE == 0) {
-    StaticUpdaterSSE<B,S>::update(s);
+    sse_type::update(s);
   } else {
-    StaticUpdaterHost<B,S>::update(s);
+    host_type::update(s);
   }
   #else
-  StaticUpdaterHost<B,S>::update(s);
+  host_type::update(s);
   #endif
 }
 